@@ -1,20 +1,253 @@
 #include "astronomy.h"
 #include "calendar.h"
+#include "ephemeris.h"
+#include "profile.h"
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
 
 #define PI 3.14159265358979323846
 
+/* Approximate Gregorian year and month of a JD (selects Samhain years) */
+static void gregorian_ym_from_jd(long jd, int *year, int *month)
+{
+    long z = jd + 1;
+    long alpha = (long)((z - 1867216.25) / 36524.25);
+    long a = z + 1 + alpha - alpha/4;
+    long b = a + 1524;
+    long c = (long)((b - 122.1) / 365.25);
+    long dd = (long)(365.25 * c);
+    long e = (long)((b - dd) / 30.6001);
+    int greg_month = (e < 14) ? e - 1 : e - 13;
+    *month = greg_month;
+    *year = (greg_month > 2) ? c - 4716 : c - 4715;
+}
+
+/*
+ * ============================================================
+ * PRECISION TIER
+ * The Sun, Moon and full moons come from the built-in mean formulas below
+ * unless a precision.h model is selected. Like ephemeris_open(), pick the
+ * tier before the first lookup: per-thread caches keep what they hold.
+ * ============================================================
+ */
+static PrecisionTier astro_tier = PRECISION_FAST;
+static const EphemerisModel *astro_model = NULL;   /* NULL = fast */
+
+int astronomy_set_tier(PrecisionTier tier)
+{
+    if ((unsigned)tier >= PRECISION_TIERS) return -1;
+#ifdef CELTIC_FIXED_POINT
+    /* The series of the other tiers need floating point */
+    if (tier != PRECISION_FAST) return -1;
+#else
+    astro_model = precision_model(tier);
+#endif
+    astro_tier = tier;
+    return 0;
+}
+
+PrecisionTier astronomy_tier(void)
+{
+    return astro_tier;
+}
+
+#ifndef CELTIC_FIXED_POINT
+/* Lunation fraction (0 = new, 0.5 = full) from the model's elongation */
+static double model_lunation_phase(double jd)
+{
+    double e = (astro_model->moon_longitude(jd) - astro_model->sun_longitude(jd)) / 360.0;
+    return e - floor(e);
+}
+#endif
+
+/*
+ * ============================================================
+ * FIXED-POINT BACKEND (-DCELTIC_FIXED_POINT)
+ * For boards without an FPU: the moon phase, moon sign, solar series,
+ * declination, equation of time and sunset hour angle are computed in
+ * integers. Angles are binary (2^32 = one turn, so wrapping is free);
+ * mean motions are 64-bit binary angles advanced by whole days, so no
+ * fmod() is needed; sines come from a quarter-wave table refined by a
+ * short Taylor step (~2e-9), and arcsines from the table inverse refined
+ * by Newton steps. Measured against the double series over -1100..3000:
+ *   solar longitude   < 3e-7 deg
+ *   declination       < 4e-7 deg
+ *   equation of time  < 0.0003 min   (series to y^3 instead of atan2)
+ *   sunset            < 2e-7 h
+ * and no day-level result moved: phase octant, sun and moon sign, Samhain
+ * day and sunset minute agree on every day. A minute or date can still
+ * flip where the double value sits within those bounds of a boundary.
+ * Lunation counts and Metonic positions keep their floor()/fmod() day
+ * arithmetic; these are not transcendental and soft-float handles them.
+ * Constants are folded from the double ones at compile time.
+ * ============================================================
+ */
+#ifdef CELTIC_FIXED_POINT
+#include <stdint.h>
+
+typedef uint32_t fx_angle;                  /* 2^32 = one turn */
+#define FX_ONE 1073741824                   /* 1.0 in Q30 */
+#define FX_QUARTER 0x40000000u
+#define FX_HALF_SQRT2 759250125             /* sqrt(1/2) in Q30 */
+#define FX_RAD_PER_ANGLE_Q30 1686629713     /* pi/2 in Q30: angle * this >> 30 = Q30 radians */
+#define FX_ANGLE_PER_RAD 683565276          /* 2^32 / (2 pi) */
+#define FX_TURN64 18446744073709551616.0
+
+/* Turns (-0.5 .. 1) / degrees (-180 .. 360) as a 64-bit binary angle */
+#define FX_TURNS64(t) ((uint64_t)(int64_t)(((t) - ((t) >= 0.5 ? 1.0 : 0.0)) * FX_TURN64))
+#define FX_DEG64(deg) FX_TURNS64((deg) / 360.0)
+#define FX_DEG(deg) ((fx_angle)(FX_DEG64(deg) >> 32))
+
+/* sin(i * pi / 512) in Q30, i = 0..256 */
+static const int32_t fx_sin_table[257] = {
+    0, 6588356, 13176464, 19764076, 26350943, 32936819, 39521455, 46104602,
+    52686014, 59265442, 65842639, 72417357, 78989349, 85558366, 92124163, 98686491,
+    105245103, 111799753, 118350194, 124896179, 131437462, 137973796, 144504935, 151030634,
+    157550647, 164064728, 170572633, 177074115, 183568930, 190056834, 196537583, 203010932,
+    209476638, 215934457, 222384147, 228825464, 235258165, 241682010, 248096755, 254502159,
+    260897982, 267283981, 273659918, 280025552, 286380643, 292724951, 299058239, 305380268,
+    311690799, 317989595, 324276419, 330551034, 336813204, 343062693, 349299266, 355522689,
+    361732726, 367929144, 374111709, 380280190, 386434353, 392573967, 398698801, 404808624,
+    410903207, 416982319, 423045732, 429093217, 435124548, 441139496, 447137835, 453119340,
+    459083786, 465030947, 470960600, 476872522, 482766489, 488642281, 494499676, 500338453,
+    506158392, 511959275, 517740883, 523502998, 529245404, 534967884, 540670223, 546352205,
+    552013618, 557654248, 563273883, 568872310, 574449320, 580004702, 585538248, 591049748,
+    596538995, 602005783, 607449906, 612871159, 618269338, 623644239, 628995660, 634323400,
+    639627258, 644907034, 650162530, 655393548, 660599890, 665781362, 670937767, 676068911,
+    681174602, 686254647, 691308855, 696337036, 701339000, 706314559, 711263525, 716185713,
+    721080937, 725949013, 730789757, 735602987, 740388522, 745146182, 749875788, 754577161,
+    759250125, 763894504, 768510122, 773096806, 777654384, 782182683, 786681534, 791150767,
+    795590213, 799999706, 804379079, 808728167, 813046808, 817334838, 821592095, 825818421,
+    830013654, 834177638, 838310216, 842411232, 846480531, 850517961, 854523370, 858496606,
+    862437520, 866345964, 870221790, 874064853, 877875009, 881652112, 885396022, 889106597,
+    892783698, 896427186, 900036924, 903612776, 907154608, 910662286, 914135678, 917574653,
+    920979082, 924348837, 927683790, 930983817, 934248793, 937478595, 940673101, 943832191,
+    946955747, 950043650, 953095785, 956112036, 959092290, 962036435, 964944360, 967815955,
+    970651112, 973449725, 976211688, 978936898, 981625251, 984276646, 986890984, 989468165,
+    992008094, 994510675, 996975812, 999403415, 1001793390, 1004145648, 1006460100, 1008736660,
+    1010975242, 1013175761, 1015338134, 1017462281, 1019548121, 1021595575, 1023604567, 1025575020,
+    1027506862, 1029400018, 1031254418, 1033069992, 1034846671, 1036584389, 1038283080, 1039942680,
+    1041563127, 1043144360, 1044686319, 1046188946, 1047652185, 1049075980, 1050460278, 1051805027,
+    1053110176, 1054375676, 1055601479, 1056787540, 1057933813, 1059040255, 1060106826, 1061133483,
+    1062120190, 1063066909, 1063973603, 1064840240, 1065666786, 1066453210, 1067199483, 1067905576,
+    1068571464, 1069197120, 1069782521, 1070327646, 1070832474, 1071296985, 1071721163, 1072104991,
+    1072448455, 1072751542, 1073014240, 1073236540, 1073418433, 1073559913, 1073660973, 1073721611,
+    1073741824
+};
+
+static int32_t fx_sin(fx_angle a)
+{
+    uint32_t x = a & (FX_QUARTER - 1);
+    if (a & FX_QUARTER) x = FX_QUARTER - x;      /* Second and fourth quadrants mirror */
+    int i = (int)(x >> 22);
+    int64_t s0 = fx_sin_table[i], c0 = fx_sin_table[256 - i];
+
+    /* sin(a0 + d) with d below one table step: Taylor terms to d^3 */
+    int64_t d = ((int64_t)(x & 0x3FFFFF) * FX_RAD_PER_ANGLE_Q30) >> 30;
+    int64_t d2 = (d * d) >> 30;
+    int64_t d3 = (d2 * d) >> 30;
+    int64_t v = s0 + ((c0 * d) >> 30) - ((s0 * d2) >> 31) - (c0 * d3) / (6LL << 30);
+    return (int32_t)((a & 0x80000000u) ? -v : v);
+}
+
+static int32_t fx_cos(fx_angle a)
+{
+    return fx_sin(a + FX_QUARTER);
+}
+
+static uint32_t fx_isqrt(uint64_t v)
+{
+    uint64_t root = 0, bit = 1ULL << 62;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+/* asin(u) for 0 <= u <= sqrt(1/2), where the slope keeps Newton well behaved */
+static fx_angle fx_asin_low(int32_t u)
+{
+    int lo = 0, hi = 128;
+    while (hi - lo > 1) {
+        int mid = (lo + hi) / 2;
+        if (fx_sin_table[mid] <= u) lo = mid;
+        else hi = mid;
+    }
+    int64_t step = fx_sin_table[lo + 1] - fx_sin_table[lo];
+    fx_angle a = ((fx_angle)lo << 22) + (fx_angle)((((int64_t)u - fx_sin_table[lo]) << 22) / step);
+
+    for (int n = 0; n < 2; n++) {
+        int64_t delta = (((int64_t)u - fx_sin(a)) << 30) / fx_cos(a);
+        a += (fx_angle)(int32_t)((delta * FX_ANGLE_PER_RAD) >> 30);
+    }
+    return a;
+}
+
+/* asin of a Q30 value, as a signed binary angle (-quarter .. quarter) */
+static fx_angle fx_asin(int32_t x)
+{
+    uint32_t u = (uint32_t)(x < 0 ? -(int64_t)x : x);
+    fx_angle a;
+    if (u >= FX_ONE) {
+        a = FX_QUARTER;
+    } else if (u > FX_HALF_SQRT2) {
+        /* asin(u) = 90 deg - 2 asin(sqrt((1 - u) / 2)) */
+        a = FX_QUARTER - 2 * fx_asin_low((int32_t)fx_isqrt((uint64_t)(FX_ONE - u) << 29));
+    } else {
+        a = fx_asin_low((int32_t)u);
+    }
+    return x < 0 ? (fx_angle)0 - a : a;
+}
+
+static fx_angle fx_acos(int32_t x)
+{
+    return FX_QUARTER - fx_asin(x);
+}
+
+static double fx_degrees(fx_angle a)
+{
+    return a * (360.0 / 4294967296.0);
+}
+
+static double fx_degrees_signed(fx_angle a)
+{
+    return (int32_t)a * (360.0 / 4294967296.0);
+}
+
+static fx_angle fx_angle_of_degrees(double deg)
+{
+    return (fx_angle)(int64_t)(deg * (4294967296.0 / 360.0));
+}
+
+/* Top 32 bits of base + rate * day (64-bit binary angles, wrapping) */
+static fx_angle fx_mean_motion(uint64_t base, uint64_t rate, long day)
+{
+    return (fx_angle)((base + rate * (uint64_t)(int64_t)day) >> 32);
+}
+#endif
+
 /* Moon phases (8-step): 0=new, 1=waxing crescent, 2=first quarter, 3=waxing gibbous,
  * 4=full, 5=waning gibbous, 6=last quarter, 7=waning crescent. Primary phases stay
  * single-day using a narrow window. */
-int moon_phase(long jd)
-{
-    /* Reference: New Moon on Jan 6, 2000 at JD 2451550.1 */
-    const double synodic = 29.53058867;
-    double phase = fmod((jd - 2451550.1) / synodic, 1.0);
-    if (phase < 0) phase += 1.0;
+#define MOON_PHASE_REF_JD 2451550.1
+#define MOON_PHASE_SYNODIC 29.53058867
+#define MOON_PHASE_PEAK_WINDOW 0.55   /* Days either side of a primary phase */
 
+#ifndef CELTIC_FIXED_POINT
+/* Classify a lunation fraction (0 = new, 0.5 = full) into the 8-step set */
+static int phase_octant(double phase)
+{
+    const double synodic = MOON_PHASE_SYNODIC;
     double age_days = phase * synodic;          /* 0 .. ~29.53 */
     double d_new   = fmin(age_days, synodic - age_days);          /* distance to nearest new */
     double d_full  = fabs(age_days - synodic * 0.5);              /* distance to full */
@@ -22,7 +255,7 @@ int moon_phase(long jd)
     double d_lq    = fabs(age_days - synodic * 0.75);             /* distance to last quarter */
 
     /* Window for primary phases; keep it narrow but not too tight so new/full land visibly */
-    const double peak_window = 0.55;  /* in days */
+    const double peak_window = MOON_PHASE_PEAK_WINDOW;
 
     /* Snap to the closest primary phase if within the narrow window */
     if (d_new  <= peak_window) return 0;
@@ -40,32 +273,310 @@ int moon_phase(long jd)
 
     return idx;
 }
+#endif
+
+#ifdef CELTIC_FIXED_POINT
+/* Lunation fraction as a binary angle (0 = new moon) */
+static fx_angle fx_lunation_phase(long jd)
+{
+    return fx_mean_motion(FX_TURNS64((2451545.0 - MOON_PHASE_REF_JD) / MOON_PHASE_SYNODIC),
+                          FX_TURNS64(1.0 / MOON_PHASE_SYNODIC), jd - 2451545L);
+}
+
+static uint32_t fx_phase_distance(fx_angle phase, fx_angle centre)
+{
+    int32_t d = (int32_t)(phase - centre);
+    return d < 0 ? (uint32_t)0 - (uint32_t)d : (uint32_t)d;
+}
+
+/* phase_octant() on a binary-angle fraction */
+static int fx_phase_octant(fx_angle phase)
+{
+    const uint32_t w = (uint32_t)(FX_TURNS64(MOON_PHASE_PEAK_WINDOW / MOON_PHASE_SYNODIC) >> 32);
+    uint32_t d_new = fx_phase_distance(phase, 0);
+    uint32_t d_fq = fx_phase_distance(phase, FX_QUARTER);
+    uint32_t d_full = fx_phase_distance(phase, 2 * FX_QUARTER);
+    uint32_t d_lq = fx_phase_distance(phase, 3 * FX_QUARTER);
+
+    if (d_new  <= w) return 0;
+    if (d_fq   <= w) return 2;
+    if (d_full <= w) return 4;
+    if (d_lq   <= w) return 6;
+
+    int idx = (int)((phase + (1u << 28)) >> 29);
+    if (idx == 0) idx = (phase < 2 * FX_QUARTER) ? 1 : 7;
+    if (idx == 2) idx = (phase < FX_QUARTER) ? 1 : 3;
+    if (idx == 4) idx = (phase < 2 * FX_QUARTER) ? 3 : 5;
+    if (idx == 6) idx = (phase < 3 * FX_QUARTER) ? 5 : 7;
+    return idx;
+}
+#endif
+
+/* Age of the lunation at jd, in days since the new moon */
+static double lunation_age(long jd)
+{
+#ifdef CELTIC_FIXED_POINT
+    return fx_lunation_phase(jd) * (MOON_PHASE_SYNODIC / 4294967296.0);
+#else
+    if (astro_model) return model_lunation_phase((double)jd) * MOON_PHASE_SYNODIC;
+    double age = fmod((jd - MOON_PHASE_REF_JD) / MOON_PHASE_SYNODIC, 1.0);
+    if (age < 0) age += 1.0;
+    return age * MOON_PHASE_SYNODIC;
+#endif
+}
+
+static int computed_moon_phase(long jd)
+{
+#ifdef CELTIC_FIXED_POINT
+    return fx_phase_octant(fx_lunation_phase(jd));
+#else
+    if (astro_model) return phase_octant(model_lunation_phase((double)jd));
+
+    /* Reference: New Moon on Jan 6, 2000 at JD 2451550.1 */
+    double phase = fmod((jd - MOON_PHASE_REF_JD) / MOON_PHASE_SYNODIC, 1.0);
+    if (phase < 0) phase += 1.0;
+    return phase_octant(phase);
+#endif
+}
+
+int moon_phase(long jd)
+{
+    const EphemerisDay *day = ephemeris_day(jd);
+    if (day) return day->moon & 0x07;
+    return computed_moon_phase(jd);
+}
 
 /*
- * Sun's ecliptic longitude (tropical zodiac)
- * Uses simplified formula accurate to ~1°
- * Reference: Vernal Equinox (Sun at 0° Aries) occurs around March 20
+ * First day on or after jd whose moon_phase() is in phase_mask (bit p =
+ * phase p; must be non-zero). Each octant starts at a fixed age of the
+ * lunation, so the wait for the nearest wanted one is known: jump by its
+ * whole days and confirm, instead of testing every day. A true lunation
+ * runs up to ~14 hours ahead of the mean one, so with a model the jump
+ * stops a day short.
  */
-int sun_sign(long jd)
+long next_moon_phase(long jd, unsigned phase_mask)
+{
+    const double s = MOON_PHASE_SYNODIC, w = MOON_PHASE_PEAK_WINDOW;
+    const double start_age[8] = {
+        s - w, w, s * 0.25 - w, s * 0.25 + w, s * 0.5 - w, s * 0.5 + w, s * 0.75 - w, s * 0.75 + w
+    };
+
+    phase_mask &= 0xff;
+    for (;;) {
+        if (phase_mask & (1u << moon_phase(jd))) return jd;
+
+        double age = lunation_age(jd);
+
+        double wait = s;
+        for (int p = 0; p < 8; p++) {
+            if (!(phase_mask & (1u << p))) continue;
+            double d = start_age[p] - age;
+            if (d <= 0.0) d += s;
+            if (d < wait) wait = d;
+        }
+        long step = (long)floor(astro_model ? wait - 1.0 : wait);
+        jd += step > 1 ? step : 1;
+    }
+}
+
+/*
+ * ============================================================
+ * SOLAR STATE
+ * One evaluation of the low-precision solar series (mean longitude, mean
+ * anomaly, equation of center) feeds every solar quantity in this file:
+ * zodiac sign, longitude searches, declination for sunset and the
+ * equation of time. Keeping a single set of constants means the sign, the
+ * festival searches and the sunset always agree on where the Sun is.
+ * ============================================================
+ */
+#define SUN_MEAN_LONG_J2000   280.460     /* degrees */
+#define SUN_MEAN_LONG_RATE    0.9856474   /* degrees/day */
+#define SUN_MEAN_ANOM_J2000   357.528
+#define SUN_MEAN_ANOM_RATE    0.9856003
+
+#ifdef CELTIC_FIXED_POINT
+typedef struct {
+    fx_angle longitude;   /* lambda */
+    fx_angle mean_long;   /* L */
+    fx_angle mean_anom;   /* g */
+} FxSun;
+
+/* The solar series at day + fraction / 2^32 days after J2000.0 */
+static void fx_solar_series(long day, uint32_t fraction, FxSun *out)
+{
+    out->mean_long = fx_mean_motion(FX_DEG64(SUN_MEAN_LONG_J2000), FX_DEG64(SUN_MEAN_LONG_RATE), day) +
+                     (fx_angle)(((FX_DEG64(SUN_MEAN_LONG_RATE) >> 32) * fraction) >> 32);
+    out->mean_anom = fx_mean_motion(FX_DEG64(SUN_MEAN_ANOM_J2000), FX_DEG64(SUN_MEAN_ANOM_RATE), day) +
+                     (fx_angle)(((FX_DEG64(SUN_MEAN_ANOM_RATE) >> 32) * fraction) >> 32);
+
+    /* Equation of center */
+    int64_t center = (int64_t)(int32_t)FX_DEG(1.915) * fx_sin(out->mean_anom) +
+                     (int64_t)(int32_t)FX_DEG(0.020) * fx_sin(2 * out->mean_anom);
+    out->longitude = out->mean_long + (fx_angle)(int32_t)(center >> 30);
+}
+
+static void fx_solar_series_at(double jd, FxSun *out)
+{
+    double d = jd - 2451545.0;
+    long day = (long)d;
+    if (d < day) day--;
+    double f = (d - day) * 4294967296.0;
+    fx_solar_series(day, f < 4294967295.0 ? (uint32_t)f : 0xFFFFFFFFu, out);
+}
+#endif
+
+/* Ecliptic longitude at a fractional JD; optionally returns L and g (degrees) */
+static double solar_series(double jd, double *mean_long, double *mean_anom)
 {
+    PROFILE_COUNT(PROF_SOLAR_SERIES);
+#ifdef CELTIC_FIXED_POINT
+    FxSun sun;
+    fx_solar_series_at(jd, &sun);
+    if (mean_long) *mean_long = fx_degrees(sun.mean_long);
+    if (mean_anom) *mean_anom = fx_degrees(sun.mean_anom);
+    return fx_degrees(sun.longitude);
+#else
+
     /* Days since J2000.0 epoch (Jan 1, 2000 12:00 TT) */
     double d = jd - 2451545.0;
 
     /* Mean longitude of the Sun (degrees) */
-    double L = fmod(280.460 + 0.9856474 * d, 360.0);
+    double L = fmod(SUN_MEAN_LONG_J2000 + SUN_MEAN_LONG_RATE * d, 360.0);
     if (L < 0) L += 360.0;
 
     /* Mean anomaly of the Sun (degrees) */
-    double g = fmod(357.528 + 0.9856003 * d, 360.0);
+    double g = fmod(SUN_MEAN_ANOM_J2000 + SUN_MEAN_ANOM_RATE * d, 360.0);
     if (g < 0) g += 360.0;
 
     /* Ecliptic longitude (with equation of center correction) */
-    double lambda = L + 1.915 * sin(g * PI / 180.0) + 0.020 * sin(2 * g * PI / 180.0);
-    lambda = fmod(lambda, 360.0);
-    if (lambda < 0) lambda += 360.0;
+    double lambda;
+    if (astro_model) {
+        /* The mean L and g still serve the equation of time and Newton steps */
+        lambda = astro_model->sun_longitude(jd);
+    } else {
+        lambda = L + 1.915 * sin(g * PI / 180.0) + 0.020 * sin(2 * g * PI / 180.0);
+        lambda = fmod(lambda, 360.0);
+        if (lambda < 0) lambda += 360.0;
+    }
+
+    if (mean_long) *mean_long = L;
+    if (mean_anom) *mean_anom = g;
+    return lambda;
+#endif
+}
+
+/* Derivative of the longitude series, in degrees per day */
+static double solar_rate_from_anomaly(double g)
+{
+#ifdef CELTIC_FIXED_POINT
+    fx_angle a = fx_angle_of_degrees(g);
+    double c1 = fx_cos(a) / (double)FX_ONE, c2 = fx_cos(2 * a) / (double)FX_ONE;
+    return SUN_MEAN_LONG_RATE + (1.915 * c1 + 0.040 * c2) * SUN_MEAN_ANOM_RATE * PI / 180.0;
+#else
+    double g_rad = g * PI / 180.0;
+    return SUN_MEAN_LONG_RATE +
+           (1.915 * cos(g_rad) + 0.040 * cos(2 * g_rad)) * SUN_MEAN_ANOM_RATE * PI / 180.0;
+#endif
+}
+
+static double sun_longitude_at(double jd)
+{
+    return solar_series(jd, NULL, NULL);
+}
+
+/*
+ * What the sunset hour angle needs of solar_state(), without the equation
+ * of time and daily motion: the declination (degrees) in fixed point, its
+ * sine in floating point, where the asin would only be undone again.
+ */
+#ifdef CELTIC_FIXED_POINT
+static double solar_declination(long jd)
+{
+    PROFILE_COUNT(PROF_SOLAR_SERIES);
+    long day = jd - 2451545L;
+    FxSun sun;
+    fx_solar_series(day, 0, &sun);
+    fx_angle epsilon = fx_mean_motion(FX_DEG64(23.439), FX_DEG64(-0.0000004), day);
+    return fx_degrees_signed(fx_asin((int32_t)(((int64_t)fx_sin(epsilon) * fx_sin(sun.longitude)) >> 30)));
+}
+#else
+static double solar_sin_declination(long jd)
+{
+    double d = jd - 2451545.0;
+    double lambda_rad = solar_series((double)jd, NULL, NULL) * PI / 180.0;
+    double epsilon_rad = (23.439 - 0.0000004 * d) * PI / 180.0;
+    return sin(epsilon_rad) * sin(lambda_rad);
+}
+#endif
+
+void solar_state(long jd, SolarState *out)
+{
+#ifdef CELTIC_FIXED_POINT
+    PROFILE_COUNT(PROF_SOLAR_SERIES);
+    long day = jd - 2451545L;
+    FxSun sun;
+    fx_solar_series(day, 0, &sun);
+    fx_angle epsilon = fx_mean_motion(FX_DEG64(23.439), FX_DEG64(-0.0000004), day);
+
+    int32_t sin_lambda = fx_sin(sun.longitude);
+    fx_angle declination = fx_asin((int32_t)(((int64_t)fx_sin(epsilon) * sin_lambda) >> 30));
+
+    /* Right ascension by its series in y = tan^2(epsilon / 2): alpha = lambda - y sin 2l + y^2/2 sin 4l - y^3/3 sin 6l */
+    int64_t cos_eps = fx_cos(epsilon);
+    int64_t y = ((FX_ONE - cos_eps) << 30) / (FX_ONE + cos_eps);
+    int64_t y2 = (y * y) >> 30, y3 = (y2 * y) >> 30;
+    int64_t ra_offset = -((y * fx_sin(2 * sun.longitude)) >> 30) +
+                        ((y2 * fx_sin(4 * sun.longitude)) >> 31) -
+                        (y3 * fx_sin(6 * sun.longitude)) / (3LL << 30);
+    fx_angle alpha = sun.longitude + (fx_angle)(int32_t)((ra_offset * FX_ANGLE_PER_RAD) >> 30);
+
+    out->longitude = fx_degrees(sun.longitude);
+    out->daily_motion = solar_rate_from_anomaly(fx_degrees(sun.mean_anom));
+    out->declination = fx_degrees_signed(declination);
+    out->equation_of_time = fx_degrees_signed(sun.mean_long - alpha) * 4.0;
+    out->sign = (int)(((uint64_t)sun.longitude * 12) >> 32);
+#else
+    double d = jd - 2451545.0;
+    double L, g;
+    double lambda = solar_series((double)jd, &L, &g);
+    double lambda_rad = lambda * PI / 180.0;
+
+    /* Obliquity of ecliptic */
+    double epsilon_rad = (23.439 - 0.0000004 * d) * PI / 180.0;
+
+    /* Right ascension for the equation of time (apparent minus mean, in minutes) */
+    double alpha = atan2(cos(epsilon_rad) * sin(lambda_rad), cos(lambda_rad)) * 180.0 / PI;
+    double eot = L - alpha;
+    eot = fmod(eot, 360.0);
+    if (eot > 180.0) eot -= 360.0;
+    if (eot < -180.0) eot += 360.0;
+
+    out->longitude = lambda;
+    out->daily_motion = solar_rate_from_anomaly(g);
+    out->declination = asin(sin(epsilon_rad) * sin(lambda_rad)) * 180.0 / PI;
+    out->equation_of_time = eot * 4.0;
+    out->sign = (int)(lambda / 30.0);
+#endif
+}
+
+/*
+ * Sun's ecliptic longitude (tropical zodiac)
+ * Uses simplified formula accurate to ~1°
+ * Reference: Vernal Equinox (Sun at 0° Aries) occurs around March 20
+ */
+int sun_sign(long jd)
+{
+    const EphemerisDay *day = ephemeris_day(jd);
+    if (day) return day->sun_sign;
 
     /* Convert to zodiac sign (0=Aries, 1=Taurus, ... 11=Pisces) */
-    return (int)(lambda / 30.0);
+#ifdef CELTIC_FIXED_POINT
+    FxSun sun;
+    fx_solar_series(jd - 2451545L, 0, &sun);
+    return (int)(((uint64_t)sun.longitude * 12) >> 32);
+#else
+    return (int)(sun_longitude(jd) / 30.0);
+#endif
 }
 
 /*
@@ -73,18 +584,35 @@ int sun_sign(long jd)
  * Simplified formula - Moon moves ~13.2° per day
  * Reference: Known Moon position at J2000.0
  */
-int moon_sign(long jd)
+#define MOON_MEAN_LONG_J2000 218.32
+#define MOON_MEAN_LONG_RATE  13.176396
+
+static int computed_moon_sign(long jd)
 {
+#ifdef CELTIC_FIXED_POINT
+    fx_angle L = fx_mean_motion(FX_DEG64(MOON_MEAN_LONG_J2000), FX_DEG64(MOON_MEAN_LONG_RATE), jd - 2451545L);
+    return (int)(((uint64_t)L * 12) >> 32);
+#else
+    if (astro_model) return (int)(astro_model->moon_longitude((double)jd) / 30.0);
+
     /* Days since J2000.0 */
     double d = jd - 2451545.0;
 
     /* Moon's mean longitude (degrees) */
     /* At J2000.0, Moon was at ~218° (Scorpio) */
-    double L = fmod(218.32 + 13.176396 * d, 360.0);
+    double L = fmod(MOON_MEAN_LONG_J2000 + MOON_MEAN_LONG_RATE * d, 360.0);
     if (L < 0) L += 360.0;
 
     /* Convert to zodiac sign */
     return (int)(L / 30.0);
+#endif
+}
+
+int moon_sign(long jd)
+{
+    const EphemerisDay *day = ephemeris_day(jd);
+    if (day) return day->moon >> 4;
+    return computed_moon_sign(jd);
 }
 
 /*
@@ -93,40 +621,275 @@ int moon_sign(long jd)
  */
 double sun_longitude(long jd)
 {
-    double d = jd - 2451545.0;
-    double L = fmod(280.460 + 0.9856474 * d, 360.0);
-    if (L < 0) L += 360.0;
-    double g = fmod(357.528 + 0.9856003 * d, 360.0);
-    if (g < 0) g += 360.0;
-    double lambda = L + 1.915 * sin(g * PI / 180.0) + 0.020 * sin(2 * g * PI / 180.0);
-    lambda = fmod(lambda, 360.0);
-    if (lambda < 0) lambda += 360.0;
-    return lambda;
+    return sun_longitude_at((double)jd);
 }
 
 /*
- * Find the JD of the most recent full moon before or on given JD
- * Celtic months begin at the full moon
+ * ============================================================
+ * EPHEMERIS SPANS
+ * Month, year and decade grids need the same quantities for runs of
+ * consecutive days. The lunar part is pure arithmetic and is evaluated two
+ * days per vector (SSE2 on x86-64, NEON on AArch64, scalar elsewhere); the
+ * fractional parts are computed exactly, so phases and moon signs match
+ * moon_phase()/moon_sign() day for day. The solar part advances the
+ * equation-of-center sines by rotation instead of calling sin() every day,
+ * re-anchoring every SPAN_SOLAR_ANCHOR days; longitudes agree with
+ * sun_longitude() to ~1e-9°.
+ * ============================================================
  */
-long find_full_moon_before(long jd)
+#define SPAN_BLOCK 64
+#define SPAN_SOLAR_ANCHOR 16
+/* Lane values must stay inside int32 for the truncating SIMD floor */
+#define SPAN_SIMD_MAX_DAYS 1.0e8
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SPAN_LANES 2
+typedef __m128d span_vec;
+static inline span_vec span_set(double a, double b) { return _mm_set_pd(b, a); }
+static inline span_vec span_splat(double a) { return _mm_set1_pd(a); }
+static inline span_vec span_add(span_vec a, span_vec b) { return _mm_add_pd(a, b); }
+static inline span_vec span_sub(span_vec a, span_vec b) { return _mm_sub_pd(a, b); }
+static inline span_vec span_mul(span_vec a, span_vec b) { return _mm_mul_pd(a, b); }
+static inline span_vec span_div(span_vec a, span_vec b) { return _mm_div_pd(a, b); }
+static inline span_vec span_floor(span_vec x)
 {
-    /* Reference: New Moon on Jan 6, 2000 at JD 2451550.1 */
-    double synodic = 29.53058867;
-    double new_moon_ref = 2451550.1;
+    span_vec t = _mm_cvtepi32_pd(_mm_cvttpd_epi32(x));
+    return _mm_sub_pd(t, _mm_and_pd(_mm_cmpgt_pd(t, x), _mm_set1_pd(1.0)));
+}
+static inline void span_store(double *p, span_vec v) { _mm_storeu_pd(p, v); }
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SPAN_LANES 2
+typedef float64x2_t span_vec;
+static inline span_vec span_set(double a, double b) { double t[2] = {a, b}; return vld1q_f64(t); }
+static inline span_vec span_splat(double a) { return vdupq_n_f64(a); }
+static inline span_vec span_add(span_vec a, span_vec b) { return vaddq_f64(a, b); }
+static inline span_vec span_sub(span_vec a, span_vec b) { return vsubq_f64(a, b); }
+static inline span_vec span_mul(span_vec a, span_vec b) { return vmulq_f64(a, b); }
+static inline span_vec span_div(span_vec a, span_vec b) { return vdivq_f64(a, b); }
+static inline span_vec span_floor(span_vec x) { return vrndmq_f64(x); }
+static inline void span_store(double *p, span_vec v) { vst1q_f64(p, v); }
+#else
+#define SPAN_LANES 1
+#endif
+
+#ifndef CELTIC_FIXED_POINT
+/* Lunation fractions and moon longitudes for count (<= SPAN_BLOCK) days */
+static void lunar_span_block(long jd_start, int count, double *phase, double *moon_long)
+{
+    int i = 0;
+#if SPAN_LANES > 1
+    if (fabs((double)(jd_start - 2451545L)) < SPAN_SIMD_MAX_DAYS) {
+        const span_vec ref = span_splat(MOON_PHASE_REF_JD);
+        const span_vec synodic = span_splat(MOON_PHASE_SYNODIC);
+        const span_vec j2000 = span_splat(2451545.0);
+        const span_vec l0 = span_splat(MOON_MEAN_LONG_J2000);
+        const span_vec rate = span_splat(MOON_MEAN_LONG_RATE);
+        const span_vec full_turn = span_splat(360.0);
+        for (; i + 1 < count; i += 2) {
+            span_vec jd = span_set((double)(jd_start + i), (double)(jd_start + i + 1));
+
+            span_vec x = span_div(span_sub(jd, ref), synodic);
+            span_store(phase + i, span_sub(x, span_floor(x)));
+
+            span_vec t = span_add(l0, span_mul(rate, span_sub(jd, j2000)));
+            span_vec turns = span_floor(span_div(t, full_turn));
+            span_store(moon_long + i, span_sub(t, span_mul(turns, full_turn)));
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        long jd = jd_start + i;
+        double p = fmod((jd - MOON_PHASE_REF_JD) / MOON_PHASE_SYNODIC, 1.0);
+        if (p < 0) p += 1.0;
+        phase[i] = p;
+        double t = MOON_MEAN_LONG_J2000 + MOON_MEAN_LONG_RATE * (jd - 2451545.0);
+        moon_long[i] = t - 360.0 * floor(t / 360.0);
+    }
+}
+#endif
 
-    /* Phase: 0=new, 0.5=full */
-    double phase = fmod((jd - new_moon_ref) / synodic, 1.0);
-    if (phase < 0) phase += 1.0;
+static void solar_span(long jd_start, int n, double *out_sunlong)
+{
+#ifdef CELTIC_FIXED_POINT
+    /* The fixed-point series has no sin() to save: one evaluation a day */
+    for (int i = 0; i < n; i++) {
+        FxSun sun;
+        fx_solar_series(jd_start + i - 2451545L, 0, &sun);
+        out_sunlong[i] = fx_degrees(sun.longitude);
+    }
+#else
+    if (astro_model) {
+        for (int i = 0; i < n; i++) out_sunlong[i] = solar_series((double)(jd_start + i), NULL, NULL);
+        return;
+    }
 
-    /* Days since last full moon (full moon is at phase 0.5) */
-    double days_since_full;
-    if (phase >= 0.5) {
-        days_since_full = (phase - 0.5) * synodic;
-    } else {
-        days_since_full = (phase + 0.5) * synodic;
+    const double step = SUN_MEAN_ANOM_RATE * PI / 180.0;
+    const double cos1 = cos(step), sin1 = sin(step);
+    const double cos2 = cos(2 * step), sin2 = sin(2 * step);
+
+    for (int base = 0; base < n; base += SPAN_SOLAR_ANCHOR) {
+        long jd0 = jd_start + base;
+        double L0, g0;
+        solar_series((double)jd0, &L0, &g0);
+        double g_rad = g0 * PI / 180.0;
+        double s1 = sin(g_rad), c1 = cos(g_rad);
+        double s2 = sin(2 * g_rad), c2 = cos(2 * g_rad);
+
+        int end = base + SPAN_SOLAR_ANCHOR;
+        if (end > n) end = n;
+        for (int i = base; i < end; i++) {
+            double L = L0 + SUN_MEAN_LONG_RATE * (i - base);
+            double lambda = L + 1.915 * s1 + 0.020 * s2;
+            lambda = fmod(lambda, 360.0);
+            if (lambda < 0) lambda += 360.0;
+            out_sunlong[i] = lambda;
+
+            double ns1 = s1 * cos1 + c1 * sin1, nc1 = c1 * cos1 - s1 * sin1;
+            double ns2 = s2 * cos2 + c2 * sin2, nc2 = c2 * cos2 - s2 * sin2;
+            s1 = ns1; c1 = nc1; s2 = ns2; c2 = nc2;
+        }
     }
+#endif
+}
 
-    return jd - (long)days_since_full;
+void ephemeris_span(long jd_start, int n, int *out_phase, double *out_sunlong, int *out_moonsign)
+{
+    const EphemerisDay *mapped = (n > 0) ? ephemeris_day(jd_start) : NULL;
+    if (mapped && !ephemeris_day(jd_start + n - 1)) mapped = NULL;
+
+    if (mapped && (out_phase || out_moonsign)) {
+        /* Whole span inside the mapped file: read the records in place */
+        for (int i = 0; i < n; i++) {
+            if (out_phase) out_phase[i] = mapped[i].moon & 0x07;
+            if (out_moonsign) out_moonsign[i] = mapped[i].moon >> 4;
+        }
+    } else if (out_phase || out_moonsign) {
+#ifdef CELTIC_FIXED_POINT
+        const int vector = 0;
+#else
+        /* A model's series do not vectorise; evaluate them day by day */
+        const int vector = (astro_model == NULL);
+#endif
+        if (!vector) {
+            for (int i = 0; i < n; i++) {
+                if (out_phase) out_phase[i] = computed_moon_phase(jd_start + i);
+                if (out_moonsign) out_moonsign[i] = computed_moon_sign(jd_start + i);
+            }
+        }
+#ifndef CELTIC_FIXED_POINT
+        double phase[SPAN_BLOCK], moon_long[SPAN_BLOCK];
+        for (int base = 0; vector && base < n; base += SPAN_BLOCK) {
+            int count = n - base;
+            if (count > SPAN_BLOCK) count = SPAN_BLOCK;
+            lunar_span_block(jd_start + base, count, phase, moon_long);
+            for (int i = 0; i < count; i++) {
+                /* Exact fixups: x - floor(x) can round up to 1.0, t/360 to a whole turn */
+                double p = phase[i];
+                if (p >= 1.0) p -= 1.0;
+                double m = moon_long[i];
+                if (m < 0) m += 360.0;
+                if (m >= 360.0) m -= 360.0;
+                if (out_phase) out_phase[base + i] = phase_octant(p);
+                if (out_moonsign) out_moonsign[base + i] = (int)(m / 30.0);
+            }
+        }
+#endif
+    }
+    if (out_sunlong) solar_span(jd_start, n, out_sunlong);
+}
+
+/*
+ * Fractional JD at which the Sun reaches target_longitude, taking the
+ * crossing within half a revolution of jd_near. Newton iteration on the
+ * longitude series above: the first step lands within a few days and the
+ * next two or three refine it well below a second.
+ */
+#define SOLAR_NEWTON_MAX_ITER 8
+#define SOLAR_NEWTON_TOLERANCE 1e-6  /* days */
+
+double solar_longitude_crossing(double jd_near, double target_longitude)
+{
+    PROFILE_BEGIN(PROF_SOLAR_CROSSING);
+    double t = jd_near;
+    for (int i = 0; i < SOLAR_NEWTON_MAX_ITER; i++) {
+        double g;
+        double diff = target_longitude - solar_series(t, NULL, &g);
+        if (diff > 180.0) diff -= 360.0;
+        if (diff < -180.0) diff += 360.0;
+        double step = diff / solar_rate_from_anomaly(g);
+        t += step;
+        if (fabs(step) < SOLAR_NEWTON_TOLERANCE) break;
+    }
+    PROFILE_END(PROF_SOLAR_CROSSING);
+    return t;
+}
+
+/*
+ * ============================================================
+ * LUNATION TABLES
+ * Lunations are numbered from the first full moon after the reference
+ * new moon (JD 2451550.1), so lunation k opens on the day of full moon
+ *   F(k) = 2451550.1 + (k + 0.5) * synodic
+ * (with a precision model or a file, F(k) is the true full moon's day).
+ * Month starts, lengths and day numbers follow from the lunation number in
+ * O(1); each Celtic year additionally keeps its own sorted list of
+ * full-moon days, searched by binary search.
+ * ============================================================
+ */
+#define LUNATION_REF_JD 2451550.1
+#define LUNATION_SYNODIC 29.53058867
+
+long lunation_number(long jd)
+{
+    long k = (long)floor((jd - LUNATION_REF_JD) / LUNATION_SYNODIC - 0.5);
+    if (!astro_model && ephemeris_tier() <= PRECISION_FAST) return k;
+
+    /* True full moons stray up to ~14 hours from the mean ones: settle on
+     * the lunation whose full-moon day actually opens jd */
+    while (jd < jd_of_full_moon(k)) k--;
+    while (jd >= jd_of_full_moon(k + 1)) k++;
+    return k;
+}
+
+/* Model full moons cost a series evaluation (high: a Newton solve); keep
+ * the days direct-mapped by lunation, per thread */
+#define FULL_MOON_CACHE_SLOTS 256
+
+static _Thread_local struct {
+    int valid;
+    PrecisionTier tier;
+    long lunation;
+    long jd;
+} full_moon_cache[FULL_MOON_CACHE_SLOTS];
+
+long jd_of_full_moon(long lunation)
+{
+    long jd;
+    if (ephemeris_full_moon(lunation, &jd)) return jd;
+    if (astro_model) {
+        int idx = (int)((unsigned long)lunation % FULL_MOON_CACHE_SLOTS);
+        if (!full_moon_cache[idx].valid || full_moon_cache[idx].lunation != lunation ||
+            full_moon_cache[idx].tier != astro_tier) {
+            full_moon_cache[idx].valid = 1;
+            full_moon_cache[idx].tier = astro_tier;
+            full_moon_cache[idx].lunation = lunation;
+            full_moon_cache[idx].jd = (long)ceil(astro_model->full_moon(lunation));
+        }
+        return full_moon_cache[idx].jd;
+    }
+    return (long)ceil(LUNATION_REF_JD + (lunation + 0.5) * LUNATION_SYNODIC);
+}
+
+/*
+ * Find the JD of the most recent full moon before or on given JD
+ * Celtic months begin at the full moon
+ */
+long find_full_moon_before(long jd)
+{
+    PROFILE_COUNT(PROF_FULL_MOON_BEFORE);
+    return jd_of_full_moon(lunation_number(jd));
 }
 
 /*
@@ -145,12 +908,8 @@ int lunar_day_of_month(long jd)
  */
 int lunar_month_length(long jd)
 {
-    long this_full = find_full_moon_before(jd);
-    long next_full = find_full_moon_before(jd + 30);  /* Find next full moon */
-    if (next_full <= this_full) {
-        next_full = find_full_moon_before(jd + 35);
-    }
-    int length = (int)(next_full - this_full);
+    long k = lunation_number(jd);
+    int length = (int)(jd_of_full_moon(k + 1) - jd_of_full_moon(k));
     return (length >= 30) ? 30 : 29;
 }
 
@@ -160,17 +919,12 @@ int lunar_month_length(long jd)
  */
 long find_samonios_start(int greg_year)
 {
-    /* Find when sun is at 225° (Samhain) - typically Nov 7 */
-    long jd_nov1 = jd_from_ymd(greg_year, 11, 1);
-    long jd_samhain = jd_nov1;
+    const EphemerisYear *rec = ephemeris_year(greg_year);
+    if (rec) return (long)rec->samonios;
 
-    for (int d = 0; d < 15; d++) {
-        double sun = sun_longitude(jd_nov1 + d);
-        if (sun >= 224.5 && sun <= 225.5) {
-            jd_samhain = jd_nov1 + d;
-            break;
-        }
-    }
+    /* Day on which the sun reaches 225° (Samhain) - typically Nov 7 */
+    long jd_nov7 = jd_from_ymd(greg_year, 11, 7);
+    long jd_samhain = lround(solar_longitude_crossing((double)jd_nov7, 225.0));
 
     /* Find the full moon nearest to Samhain (within ~7 days before) */
     /* The full moon before or around Samhain starts Samonios */
@@ -179,56 +933,139 @@ long find_samonios_start(int greg_year)
     return jd_full;
 }
 
+/* Lunar years are cached direct-mapped by their Samhain year, per thread */
+#define LUNAR_YEAR_CACHE_SLOTS 256
+
+static _Thread_local struct {
+    int valid;
+    LunarYear year;
+} lunar_year_cache[LUNAR_YEAR_CACHE_SLOTS];
+
+static void build_lunar_year(int samhain_year, LunarYear *ly)
+{
+    long first = lunation_number(find_samonios_start(samhain_year));
+    long next = lunation_number(find_samonios_start(samhain_year + 1));
+
+    ly->samhain_year = samhain_year;
+    ly->first_lunation = first;
+    ly->months = (int)(next - first);
+    for (int i = 0; i < LUNAR_YEAR_SLOTS; i++) {
+        ly->full_moons[i] = jd_of_full_moon(first + i);
+    }
+}
+
+const LunarYear *lunar_year(int samhain_year)
+{
+    int idx = (int)((unsigned)samhain_year % LUNAR_YEAR_CACHE_SLOTS);
+    if (!lunar_year_cache[idx].valid || lunar_year_cache[idx].year.samhain_year != samhain_year) {
+        PROFILE_COUNT(PROF_LUNAR_YEAR_MISS);
+        build_lunar_year(samhain_year, &lunar_year_cache[idx].year);
+        lunar_year_cache[idx].valid = 1;
+    } else {
+        PROFILE_COUNT(PROF_LUNAR_YEAR_HIT);
+    }
+    return &lunar_year_cache[idx].year;
+}
+
 /*
- * Get the lunar Celtic month index (0-11 or 12 for intercalary)
- * Based on counting lunations from Samonios start (full moon near Samhain)
+ * Number of lunations from Samonios to the month containing jd (binary
+ * search over the year's full moons). Dates before Samonios give -1; dates
+ * past the table saturate at LUNAR_YEAR_SLOTS - 1.
  */
-int lunar_celtic_month_index(long jd)
+int lunar_year_month_of(const LunarYear *ly, long jd)
+{
+    if (jd < ly->full_moons[0]) return -1;
+    int lo = 0, hi = LUNAR_YEAR_SLOTS - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (ly->full_moons[mid] <= jd) lo = mid;
+        else hi = mid - 1;
+    }
+    return lo;
+}
+
+/* Samhain year of the lunar Celtic year containing jd */
+int lunar_samhain_year(long jd)
 {
-    /* Determine which Gregorian year's Samhain we're relative to */
     /* Celtic year starts around Nov, so:
      * - Jan-Oct: use previous year's Samhain
      * - Nov-Dec: check if before/after this year's Samhain
      */
+    int greg_year, greg_month;
+    gregorian_ym_from_jd(jd, &greg_year, &greg_month);
 
-    /* Get approximate Gregorian date from JD */
-    long z = jd + 1;
-    long alpha = (long)((z - 1867216.25) / 36524.25);
-    long a = z + 1 + alpha - alpha/4;
-    long b = a + 1524;
-    long c = (long)((b - 122.1) / 365.25);
-    long dd = (long)(365.25 * c);
-    long e = (long)((b - dd) / 30.6001);
-    int greg_month = (e < 14) ? e - 1 : e - 13;
-    int greg_year = (greg_month > 2) ? c - 4716 : c - 4715;
-
-
-    /* Find Samonios start for this Celtic year */
     int samhain_year = (greg_month >= 11) ? greg_year : greg_year - 1;
-    long jd_samonios = find_samonios_start(samhain_year);
 
     /* If we're before this year's Samonios, use previous year */
-    if (jd < jd_samonios) {
-        samhain_year--;
-        jd_samonios = find_samonios_start(samhain_year);
-    }
+    if (jd < lunar_year(samhain_year)->full_moons[0]) samhain_year--;
+    return samhain_year;
+}
 
-    /* Count lunations since Samonios start */
-    long jd_current_month = find_full_moon_before(jd);
-    int month_count = 0;
-    long jd_check = jd_samonios;
+/*
+ * Get the lunar Celtic month index (0-11 or 12 for intercalary)
+ * Based on counting lunations from Samonios start (full moon near Samhain)
+ */
+int lunar_celtic_month_index(long jd)
+{
+    PROFILE_COUNT(PROF_LUNAR_MONTH_INDEX);
 
-    while (jd_check < jd_current_month) {
-        jd_check = find_full_moon_before(jd_check + 32);  /* Jump to next full moon */
-        month_count++;
-        if (month_count > 13) break;  /* Safety limit */
-    }
+    /* Find Samonios start for this Celtic year */
+    const LunarYear *ly = lunar_year(lunar_samhain_year(jd));
+
+    /* Count lunations since Samonios start */
+    int month_count = lunar_year_month_of(ly, jd);
 
     /* Patch: shift so 0 = Giamonios, not Samonios */
     int shifted = (month_count + 6) % 12; // 0=GIA, 6=SAM
     return (month_count > 11) ? -1 : shifted;  /* -1 for intercalary */
 }
 
+/* Samhain year lunar_samhain_year() starts its search from */
+static int lunar_search_year(long jd)
+{
+    int greg_year, greg_month;
+    gregorian_ym_from_jd(jd, &greg_year, &greg_month);
+    return (greg_month >= 11) ? greg_year : greg_year - 1;
+}
+
+/*
+ * The answer of lunar_celtic_month_index() holds for a whole lunation
+ * except where the lunation crosses November 1 and the search starts from
+ * the next Samhain year, so the span is the lunation cut at that day.
+ */
+int lunar_month_span(long jd, long *first, long *next)
+{
+    long k = lunation_number(jd);
+    long lo = jd_of_full_moon(k);
+    long hi = jd_of_full_moon(k + 1);
+
+    int key = lunar_search_year(jd);
+    if (lunar_search_year(lo) != key) {
+        /* First day of this search year within (lo, jd] */
+        long a = lo, b = jd;
+        while (b - a > 1) {
+            long mid = a + (b - a) / 2;
+            if (lunar_search_year(mid) == key) b = mid;
+            else a = mid;
+        }
+        lo = b;
+    }
+    if (lunar_search_year(hi - 1) != key) {
+        /* First day past this search year within (jd, hi - 1] */
+        long a = jd, b = hi - 1;
+        while (b - a > 1) {
+            long mid = a + (b - a) / 2;
+            if (lunar_search_year(mid) == key) a = mid;
+            else b = mid;
+        }
+        hi = b;
+    }
+
+    if (first) *first = lo;
+    if (next) *next = hi;
+    return lunar_celtic_month_index(jd);
+}
+
 /*
  * ============================================================
  * SUNSET CALCULATIONS
@@ -238,46 +1075,14 @@ int lunar_celtic_month_index(long jd)
  * ============================================================
  */
 
-/* Default latitude: Coligny, France (46.38°N) */
-#define DEFAULT_LATITUDE 46.38
-#define DEFAULT_LONGITUDE 5.35
-
-/*
- * Calculate sunset time for a given Julian Day and latitude
- * Returns hours after midnight (local solar time)
- * Uses simplified sunrise equation
- */
-double calculate_sunset(long jd, double latitude)
+#ifndef CELTIC_FIXED_POINT
+/* Sunset in local apparent solar time from the sine and cosine of the declination */
+static double sunset_from_declination(double sin_delta, double cos_delta, double latitude)
 {
-    /* Days since J2000.0 */
-    double d = jd - 2451545.0;
-
-    /* Sun's mean anomaly */
-    double g = fmod(357.529 + 0.98560028 * d, 360.0);
-    if (g < 0) g += 360.0;
-    double g_rad = g * PI / 180.0;
-
-    /* Sun's mean longitude */
-    double L = fmod(280.459 + 0.98564736 * d, 360.0);
-    if (L < 0) L += 360.0;
-
-    /* Ecliptic longitude */
-    double lambda = L + 1.915 * sin(g_rad) + 0.020 * sin(2 * g_rad);
-    lambda = fmod(lambda, 360.0);
-    if (lambda < 0) lambda += 360.0;
-    double lambda_rad = lambda * PI / 180.0;
-
-    /* Obliquity of ecliptic */
-    double epsilon = 23.439 - 0.0000004 * d;
-    double epsilon_rad = epsilon * PI / 180.0;
-
-    /* Solar declination */
-    double delta = asin(sin(epsilon_rad) * sin(lambda_rad));
-
     /* Hour angle at sunset (-0.833° for atmospheric refraction) */
     double lat_rad = latitude * PI / 180.0;
-    double cos_H = (sin(-0.833 * PI / 180.0) - sin(lat_rad) * sin(delta))
-                   / (cos(lat_rad) * cos(delta));
+    double cos_H = (sin(-0.833 * PI / 180.0) - sin(lat_rad) * sin_delta)
+                   / (cos(lat_rad) * cos_delta);
 
     /* Clamp for polar regions */
     if (cos_H > 1.0) return 12.0;   /* No sunset - return noon */
@@ -288,10 +1093,62 @@ double calculate_sunset(long jd, double latitude)
 
     /* Sunset time = solar noon + hour angle */
     /* Solar noon is approximately 12:00 local solar time */
-    double sunset_hour = 12.0 + H;
+    return 12.0 + H;
+}
+#endif
+
+/* Sunset in local apparent solar time from the Sun's declination (degrees) */
+static double sunset_solar_hours(double declination, double latitude)
+{
+#ifdef CELTIC_FIXED_POINT
+    fx_angle delta = fx_angle_of_degrees(declination);
+    fx_angle lat = fx_angle_of_degrees(latitude);
+
+    /* cos H = (sin(-0.833) - sin(lat) sin(delta)) / (cos(lat) cos(delta)), as num / den */
+    int64_t num = fx_sin(FX_DEG(-0.833)) - (((int64_t)fx_sin(lat) * fx_sin(delta)) >> 30);
+    int64_t den = ((int64_t)fx_cos(lat) * fx_cos(delta)) >> 30;
 
+    if (den <= 0) return num > 0 ? 12.0 : 24.0;
+    if (num > den) return 12.0;    /* No sunset - return noon */
+    if (num < -den) return 24.0;   /* No sunrise - return midnight */
 
-    return sunset_hour;
+    fx_angle H = fx_acos((int32_t)((num << 30) / den));
+    return 12.0 + H * (24.0 / 4294967296.0);
+#else
+    /* Solar declination */
+    double delta = declination * PI / 180.0;
+    return sunset_from_declination(sin(delta), cos(delta), latitude);
+#endif
+}
+
+/*
+ * Calculate sunset time for a given Julian Day and latitude
+ * Returns hours after midnight (local solar time)
+ * Uses simplified sunrise equation
+ */
+double calculate_sunset(long jd, double latitude)
+{
+    PROFILE_COUNT(PROF_SUNSET);
+#ifdef CELTIC_FIXED_POINT
+    return sunset_solar_hours(solar_declination(jd), latitude);
+#else
+    /* The declination stays within ±23.5°, so its cosine is the positive root */
+    double sin_delta = solar_sin_declination(jd);
+    return sunset_from_declination(sin_delta, sqrt(1.0 - sin_delta * sin_delta), latitude);
+#endif
+}
+
+/*
+ * Sunset on a zone clock: solar time corrected by the equation of time,
+ * the longitude (degrees east) and the zone offset (hours east of UTC)
+ */
+double calculate_sunset_clock(long jd, double latitude, double longitude, double tz_offset)
+{
+    PROFILE_COUNT(PROF_SUNSET);
+    SolarState sun;
+    solar_state(jd, &sun);
+    double solar = sunset_solar_hours(sun.declination, latitude);
+    return solar - sun.equation_of_time / 60.0 - longitude / 15.0 + tz_offset;
 }
 
 /*
@@ -374,6 +1231,42 @@ int metonic_lunation(long jd)
     return (int)(position * METONIC_MONTHS) + 1;
 }
 
+/*
+ * Days sharing one value of a Metonic position function: the edges come
+ * from the cycle arithmetic and are then settled against the function
+ * itself, so the span agrees with it to the day.
+ */
+static int metonic_span(long jd, int (*value)(long), int parts, long *first, long *next)
+{
+    int v = value(jd);
+    double cycles = (jd - METONIC_EPOCH_JD) / METONIC_DAYS;
+    double base = METONIC_EPOCH_JD + floor(cycles) * METONIC_DAYS;
+    double step = METONIC_DAYS / parts;
+
+    long lo = (long)ceil(base + (v - 1) * step);
+    long hi = (long)ceil(base + v * step);
+    if (lo > jd) lo = jd;
+    if (hi <= jd) hi = jd + 1;
+    while (lo < jd && value(lo) != v) lo++;
+    while (value(lo - 1) == v) lo--;
+    while (hi > jd + 1 && value(hi - 1) != v) hi--;
+    while (value(hi) == v) hi++;
+
+    if (first) *first = lo;
+    if (next) *next = hi;
+    return v;
+}
+
+int metonic_year_span(long jd, long *first, long *next)
+{
+    return metonic_span(jd, metonic_year, METONIC_YEARS, first, next);
+}
+
+int metonic_lunation_span(long jd, long *first, long *next)
+{
+    return metonic_span(jd, metonic_lunation, METONIC_MONTHS, first, next);
+}
+
 /*
  * Get the total number of Metonic cycles since epoch
  */
@@ -477,15 +1370,9 @@ int is_pleiades_rising(long jd)
  */
 int days_to_solar_longitude(long jd, double target_longitude)
 {
-    double sun_long = sun_longitude(jd);
-
-    double diff = target_longitude - sun_long;
-    if (diff > 180.0) diff -= 360.0;
-    if (diff < -180.0) diff += 360.0;
-
-    /* Sun moves ~0.9856° per day; round to nearest day to avoid double-counting */
-    double days = diff / 0.9856;
-    return (int)lround(days);
+    /* Round the exact crossing to the nearest day to avoid double-counting */
+    double crossing = solar_longitude_crossing((double)jd, target_longitude);
+    return (int)lround(crossing - jd);
 }
 
 /*
@@ -526,27 +1413,16 @@ int days_to_true_lughnasadh(long jd)
  */
 int nearest_cross_quarter(long jd, int *days_to_event)
 {
-    int sam = days_to_true_samhain(jd);
-    int imb = days_to_true_imbolc(jd);
-    int bel = days_to_true_beltane(jd);
-    int lug = days_to_true_lughnasadh(jd);
-
-    /* Make all positive (days until) */
-    if (sam < 0) sam += 365;
-    if (imb < 0) imb += 365;
-    if (bel < 0) bel += 365;
-    if (lug < 0) lug += 365;
-
-    /* Find minimum */
-    int min_days = sam;
-    int event = 0;
-
-    if (imb < min_days) { min_days = imb; event = 1; }
-    if (bel < min_days) { min_days = bel; event = 2; }
-    if (lug < min_days) { min_days = lug; event = 3; }
+    /* Cross-quarters are every other event of the eight-fold year */
+    double event_jd;
+    int event = next_eightfold_event(jd, &event_jd);
+    if ((event & 1) == 0) {
+        event = next_eightfold_event((long)floor(event_jd + 0.5) + 1, &event_jd);
+    }
 
-    *days_to_event = min_days;
-    return event;
+    *days_to_event = (int)lround(event_jd - jd);
+    /* 1=Imbolc, 3=Beltane, 5=Lughnasadh, 7=Samhain -> 1, 2, 3, 0 */
+    return ((event + 1) / 2) % 4;
 }
 
 /*
@@ -563,30 +1439,19 @@ int nearest_cross_quarter(long jd, int *days_to_event)
  * Find the JD of solilunar Samhain for a given Gregorian year
  * Returns the Full Moon nearest to when Sun is at 225°
  */
-long find_solilunar_samhain(int greg_year)
+/* Full moon nearest to a solar event day (or the day itself if Full/New) */
+static long solilunar_full_moon(long jd_solar)
 {
-    /* Find when sun reaches 225° */
-    long jd_nov1 = jd_from_ymd(greg_year, 11, 1);
-    long jd_solar = jd_nov1;
-
-    for (int d = 0; d < 20; d++) {
-        double sun = sun_longitude(jd_nov1 + d);
-        if (sun >= 224.5 && sun <= 225.5) {
-            jd_solar = jd_nov1 + d;
-            break;
-        }
-    }
-
-    /* Check if Full Moon or New Moon falls on solar Samhain (perfect alignment) */
+    /* Check if Full Moon or New Moon falls on the solar day (perfect alignment) */
     int phase = moon_phase(jd_solar);
     if (phase == 4 || phase == 0) {
         return jd_solar;  /* Perfect solilunar alignment! */
     }
 
-    /* Find Full Moon nearest to solar Samhain */
+    /* Find Full Moon nearest to the solar day */
     long jd_full = find_full_moon_before(jd_solar + 10);
 
-    /* Distance from solar Samhain to full moon */
+    /* Distance from the solar day to full moon */
     int days_to_full = (int)(jd_full - jd_solar);
 
     /* If full moon is more than 7 days away, check previous full moon */
@@ -601,27 +1466,34 @@ long find_solilunar_samhain(int greg_year)
     return jd_full;
 }
 
+long find_solilunar_samhain(int greg_year)
+{
+    /* Day on which the sun reaches 225° */
+    long jd_nov7 = jd_from_ymd(greg_year, 11, 7);
+    long jd_solar = lround(solar_longitude_crossing((double)jd_nov7, 225.0));
+    return solilunar_full_moon(jd_solar);
+}
+
 /*
  * Check if a given JD is a solilunar festival (Sun at cross-quarter + significant moon)
  * Returns: 0=not festival, 1=Full Moon alignment, 2=New Moon alignment
  */
 int is_solilunar_festival(long jd)
 {
-    double sun = sun_longitude(jd);
-    int phase = moon_phase(jd);
-
-    /* Check if sun is near any cross-quarter */
-    double cross_quarters[] = {225.0, 315.0, 45.0, 135.0};  /* Sam, Imb, Bel, Lug */
-
-    for (int i = 0; i < 4; i++) {
-        double diff = sun - cross_quarters[i];
-        if (diff > 180) diff -= 360;
-        if (diff < -180) diff += 360;
-
-        if (diff >= -2.0 && diff <= 2.0) {
-            /* Sun is at cross-quarter! Check moon */
-            if (phase == 4) return 1;  /* Full Moon */
-            if (phase == 0) return 2;  /* New Moon */
+    int greg_year, greg_month;
+    gregorian_ym_from_jd(jd, &greg_year, &greg_month);
+
+    /* Sun within ±2° of a cross-quarter, as precomputed JD windows */
+    for (int y = greg_year - 1; y <= greg_year; y++) {
+        const EventYear *ey = event_year(y);
+        for (int i = 0; i < 4; i++) {
+            if (jd >= ey->cross_window[i][0] && jd <= ey->cross_window[i][1]) {
+                /* Sun is at cross-quarter! Check moon */
+                int phase = moon_phase(jd);
+                if (phase == 4) return 1;  /* Full Moon */
+                if (phase == 0) return 2;  /* New Moon */
+                return 0;
+            }
         }
     }
 
@@ -634,15 +1506,8 @@ int is_solilunar_festival(long jd)
 int days_to_solilunar_samhain(long jd)
 {
     /* Get current Gregorian year */
-    long z = jd + 1;
-    long alpha = (long)((z - 1867216.25) / 36524.25);
-    long a = z + 1 + alpha - alpha/4;
-    long b = a + 1524;
-    long c = (long)((b - 122.1) / 365.25);
-    long dd = (long)(365.25 * c);
-    long e = (long)((b - dd) / 30.6001);
-    int greg_month = (e < 14) ? e - 1 : e - 13;
-    int greg_year = (greg_month > 2) ? c - 4716 : c - 4715;
+    int greg_year, greg_month;
+    gregorian_ym_from_jd(jd, &greg_year, &greg_month);
 
     /* Find solilunar Samhain for this year */
     long jd_samhain = find_solilunar_samhain(greg_year);
@@ -700,32 +1565,172 @@ int days_to_mabon(long jd)
  */
 int nearest_eightfold_event(long jd, int *days_to_event)
 {
-    int events[8];
-    events[0] = days_to_yule(jd);        /* 270° */
-    events[1] = days_to_true_imbolc(jd); /* 315° */
-    events[2] = days_to_ostara(jd);      /* 0° */
-    events[3] = days_to_true_beltane(jd);/* 45° */
-    events[4] = days_to_litha(jd);       /* 90° */
-    events[5] = days_to_true_lughnasadh(jd); /* 135° */
-    events[6] = days_to_mabon(jd);       /* 180° */
-    events[7] = days_to_true_samhain(jd);/* 225° */
-
-    /* Make all positive (days until next occurrence) */
+    double event_jd;
+    int nearest = next_eightfold_event(jd, &event_jd);
+    *days_to_event = (int)lround(event_jd - jd);
+    return nearest;
+}
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════════
+ * EVENT YEARS
+ * The exact JDs of one Celtic year's astronomical events, found once with
+ * the Newton crossing search and cached. Day-level queries for the
+ * eight-fold year and the solilunar windows are answered from these
+ * tables by search instead of fresh trigonometry. Years inside a mapped
+ * ephemeris file (ephemeris.h) are copied from it rather than searched.
+ * ═══════════════════════════════════════════════════════════════════════════
+ */
+#ifndef EVENT_YEAR_FIRST_YEAR
+#define EVENT_YEAR_FIRST_YEAR (-3101)   /* Same span as the Samhain table */
+#endif
+#ifndef EVENT_YEAR_LAST_YEAR
+#define EVENT_YEAR_LAST_YEAR 3000
+#endif
+#define EVENT_YEAR_SPAN (EVENT_YEAR_LAST_YEAR - EVENT_YEAR_FIRST_YEAR + 1)
+#define EVENT_YEAR_OVERFLOW_SLOTS 64
+#define CROSS_QUARTER_HALF_WIDTH 2.0   /* degrees, see is_solilunar_festival() */
+
+/* Chronological slots from Samhain, and their eight-fold ids / longitudes */
+static const int eightfold_of_slot[8] = {7, 0, 1, 2, 3, 4, 5, 6};
+static const double longitude_of_slot[8] = {
+    SAMHAIN_LONGITUDE, WINTER_SOLSTICE, IMBOLC_LONGITUDE, VERNAL_EQUINOX,
+    BELTANE_LONGITUDE, SUMMER_SOLSTICE, LUGHNASADH_LONGITUDE, AUTUMN_EQUINOX
+};
+
+/*
+ * One lazily filled slot per year of the span (a direct-mapped cache
+ * thrashes on random dates across millennia), plus a
+ * small direct-mapped cache for years outside it. Both are per thread; the
+ * span table (~1.3 MB) is allocated on a thread's first lookup and freed
+ * when the thread exits, so idle threads carry no TLS block of that size.
+ */
+typedef struct {
+    int valid;
+    EventYear year;
+} EventYearSlot;
+
+static _Thread_local EventYearSlot *event_year_table;
+static _Thread_local EventYearSlot event_year_overflow[EVENT_YEAR_OVERFLOW_SLOTS];
+
+static pthread_key_t event_year_key;
+static pthread_once_t event_year_key_once = PTHREAD_ONCE_INIT;
+
+static void create_event_year_key(void)
+{
+    pthread_key_create(&event_year_key, free);
+}
+
+/* The calling thread's span table, or NULL if it cannot be allocated */
+static EventYearSlot *thread_event_year_table(void)
+{
+    if (!event_year_table) {
+        event_year_table = calloc(EVENT_YEAR_SPAN, sizeof(EventYearSlot));
+        if (event_year_table) {
+            pthread_once(&event_year_key_once, create_event_year_key);
+            pthread_setspecific(event_year_key, event_year_table);
+        }
+    }
+    return event_year_table;
+}
+
+/* Copy a year out of the mapped ephemeris; 0 if the file does not cover it */
+static int load_event_year(int samhain_year, EventYear *ey)
+{
+    const EphemerisYear *rec = ephemeris_year(samhain_year);
+    if (!rec) return 0;
+
+    ey->samhain_year = samhain_year;
+    memcpy(ey->solar, rec->solar, sizeof(ey->solar));
+    ey->next_samhain = rec->next_samhain;
+    for (int q = 0; q < 4; q++) {
+        ey->cross_window[q][0] = rec->cross_window[q][0];
+        ey->cross_window[q][1] = rec->cross_window[q][1];
+        ey->solilunar[q] = (long)rec->solilunar[q];
+    }
+    ey->pleiades_rising = rec->pleiades_rising;
+    ey->samonios = (long)rec->samonios;
+    return 1;
+}
+
+static void build_event_year(int samhain_year, EventYear *ey)
+{
+    if (load_event_year(samhain_year, ey)) return;
+
+    ey->samhain_year = samhain_year;
+
+    double t = solar_longitude_crossing((double)jd_from_ymd(samhain_year, 11, 7), SAMHAIN_LONGITUDE);
     for (int i = 0; i < 8; i++) {
-        if (events[i] < 0) events[i] += 365;
+        /* Each event lies ~45.7 days after the previous one */
+        if (i > 0) t = solar_longitude_crossing(t + 45.66, longitude_of_slot[i]);
+        ey->solar[i] = t;
+    }
+    ey->next_samhain = solar_longitude_crossing(t + 45.66, SAMHAIN_LONGITUDE);
+
+    /* Cross-quarters sit in slots 0, 2, 4, 6 (Samhain, Imbolc, Beltane, Lughnasadh) */
+    for (int q = 0; q < 4; q++) {
+        double at = ey->solar[q * 2];
+        double lon = longitude_of_slot[q * 2];
+        ey->cross_window[q][0] = solar_longitude_crossing(at - CROSS_QUARTER_HALF_WIDTH, lon - CROSS_QUARTER_HALF_WIDTH);
+        ey->cross_window[q][1] = solar_longitude_crossing(at + CROSS_QUARTER_HALF_WIDTH, lon + CROSS_QUARTER_HALF_WIDTH);
+        ey->solilunar[q] = solilunar_full_moon(lround(at));
     }
 
-    /* Find minimum */
-    int min_days = events[0];
-    int nearest = 0;
+    double rising_sun_long = PLEIADES_LONGITUDE - HELIACAL_OFFSET;
+    if (rising_sun_long < 0) rising_sun_long += 360.0;
+    ey->pleiades_rising = solar_longitude_crossing(ey->solar[4] - 2.0, rising_sun_long);
 
-    for (int i = 1; i < 8; i++) {
-        if (events[i] < min_days) {
-            min_days = events[i];
-            nearest = i;
-        }
+    ey->samonios = find_samonios_start(samhain_year);
+}
+
+const EventYear *event_year(int samhain_year)
+{
+    EventYearSlot *slot;
+    EventYearSlot *table;
+    if (samhain_year >= EVENT_YEAR_FIRST_YEAR && samhain_year <= EVENT_YEAR_LAST_YEAR &&
+        (table = thread_event_year_table()) != NULL) {
+        slot = &table[samhain_year - EVENT_YEAR_FIRST_YEAR];
+    } else {
+        slot = &event_year_overflow[(unsigned)samhain_year % EVENT_YEAR_OVERFLOW_SLOTS];
     }
+    if (!slot->valid || slot->year.samhain_year != samhain_year) {
+        PROFILE_BEGIN(PROF_EVENT_YEAR_MISS);
+        build_event_year(samhain_year, &slot->year);
+        slot->valid = 1;
+        PROFILE_END(PROF_EVENT_YEAR_MISS);
+    } else {
+        PROFILE_COUNT(PROF_EVENT_YEAR_HIT);
+    }
+    return &slot->year;
+}
 
-    *days_to_event = min_days;
-    return nearest;
+int eightfold_event_of_slot(int slot)
+{
+    return (slot >= 0 && slot < 8) ? eightfold_of_slot[slot] : -1;
+}
+
+/*
+ * Next event of the eight-fold year that rounds to today or later
+ * (event - jd > -0.5 days). Returns its eight-fold id (0=Yule .. 7=Samhain).
+ */
+int next_eightfold_event(long jd, double *event_jd)
+{
+    int greg_year, greg_month;
+    gregorian_ym_from_jd(jd, &greg_year, &greg_month);
+
+    double from = jd - 0.5;
+    for (int y = greg_year - 1; ; y++) {
+        const EventYear *ey = event_year(y);
+        if (ey->solar[7] <= from) continue;
+
+        /* Binary search for the first event after 'from' */
+        int lo = 0, hi = 7;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (ey->solar[mid] > from) hi = mid;
+            else lo = mid + 1;
+        }
+        if (event_jd) *event_jd = ey->solar[lo];
+        return eightfold_of_slot[lo];
+    }
 }
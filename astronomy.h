@@ -1,20 +1,65 @@
 #ifndef ASTRONOMY_H
 #define ASTRONOMY_H
 
+#include "precision.h"
+
+/* Model for everything below (precision.h); fast unless set. A setup call,
+ * like ephemeris_open(). Returns -1 for a tier this build lacks. */
+int astronomy_set_tier(PrecisionTier tier);
+PrecisionTier astronomy_tier(void);
+
+/* Everything the solar series yields for one day, from a single evaluation */
+typedef struct {
+    double longitude;         /* Ecliptic longitude, degrees 0-360 */
+    double daily_motion;      /* Degrees per day */
+    double declination;       /* Degrees */
+    double equation_of_time;  /* Minutes, apparent minus mean solar time */
+    int sign;                 /* Zodiac sign, 0=Aries .. 11=Pisces */
+} SolarState;
+
+void solar_state(long jd, SolarState *out);
+
 int moon_phase(long jd);
+long next_moon_phase(long jd, unsigned phase_mask);  /* First day >= jd with moon_phase() in the mask */
 int sun_sign(long jd);
 int moon_sign(long jd);
 double sun_longitude(long jd);  /* Ecliptic longitude in degrees */
 
+/* Moon phase, sun longitude and moon sign for n consecutive days from jd_start.
+ * Any output array may be NULL. Matches the per-day functions. */
+void ephemeris_span(long jd_start, int n, int *out_phase, double *out_sunlong, int *out_moonsign);
+
+/* Fractional JD where the Sun reaches a longitude (nearest crossing to jd_near) */
+double solar_longitude_crossing(double jd_near, double target_longitude);
+
+/* Lunation numbering: lunation k opens on the day of its full moon */
+long lunation_number(long jd);           /* Lunation containing jd */
+long jd_of_full_moon(long lunation);     /* First day of a lunation */
+
+/* Full moons of one lunar Celtic year, Samonios onwards (sorted) */
+#define LUNAR_YEAR_SLOTS 15
+typedef struct {
+    int samhain_year;                    /* Gregorian year of the opening Samhain */
+    int months;                          /* Lunations until next Samonios (12 or 13) */
+    long first_lunation;                 /* Lunation number of Samonios */
+    long full_moons[LUNAR_YEAR_SLOTS];   /* full_moons[months] = next Samonios */
+} LunarYear;
+
+const LunarYear *lunar_year(int samhain_year);
+int lunar_year_month_of(const LunarYear *ly, long jd);  /* Lunations since Samonios */
+int lunar_samhain_year(long jd);                         /* Samhain year of the lunar year holding jd */
+
 /* Lunar-synced Celtic month functions */
 long find_full_moon_before(long jd);
 int lunar_day_of_month(long jd);
 int lunar_month_length(long jd);
 long find_samonios_start(int greg_year);      /* Full moon near Samhain */
 int lunar_celtic_month_index(long jd);        /* Month by lunation count */
+int lunar_month_span(long jd, long *first, long *next);  /* Same month for days [*first, *next) */
 
 /* Sunset calculations (Celtic day begins at sunset) */
-double calculate_sunset(long jd, double latitude);
+double calculate_sunset(long jd, double latitude);   /* Local solar time */
+double calculate_sunset_clock(long jd, double latitude, double longitude, double tz_offset);
 int is_after_sunset(long jd, double current_hour, double latitude);
 long celtic_jd_from_time(long jd, double current_hour, double latitude);
 void get_sunset_time_str(long jd, double latitude, char *buffer, int buf_size);
@@ -22,6 +67,8 @@ void get_sunset_time_str(long jd, double latitude, char *buffer, int buf_size);
 /* Metonic Cycle (19-year lunisolar synchronization) */
 int metonic_year(long jd);           /* Year within cycle (1-19) */
 int metonic_lunation(long jd);       /* Lunation within cycle (1-235) */
+int metonic_year_span(long jd, long *first, long *next);      /* Same year for days [*first, *next) */
+int metonic_lunation_span(long jd, long *first, long *next);  /* Same lunation for days [*first, *next) */
 int metonic_cycle_number(long jd);   /* Total cycles since epoch */
 double metonic_drift_hours(long jd); /* Accumulated drift in hours */
 
@@ -49,4 +96,22 @@ int days_to_litha(long jd);          /* Summer Solstice - 90° */
 int days_to_mabon(long jd);          /* Autumn Equinox - 180° */
 int nearest_eightfold_event(long jd, int *days_to_event);
 
+/*
+ * Event year: exact (fractional JD) astronomical events from the Samhain
+ * of samhain_year up to the next one. Built once per year and cached.
+ */
+typedef struct {
+    int samhain_year;
+    double solar[8];             /* Samhain, Yule, Imbolc, Ostara, Beltane, Litha, Lughnasadh, Mabon */
+    double next_samhain;
+    double cross_window[4][2];   /* Sun within ±2° of Samhain, Imbolc, Beltane, Lughnasadh */
+    long solilunar[4];           /* Full moon day aligned with each cross-quarter */
+    double pleiades_rising;      /* Sun 17° behind the Pleiades */
+    long samonios;               /* find_samonios_start() */
+} EventYear;
+
+const EventYear *event_year(int samhain_year);
+int eightfold_event_of_slot(int slot);  /* solar[] slot -> eight-fold id (0=Yule .. 7=Samhain) */
+int next_eightfold_event(long jd, double *event_jd);  /* First event rounding to jd or later */
+
 #endif
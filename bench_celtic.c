@@ -0,0 +1,443 @@
+/*
+ * bench_celtic — microbenchmarks for the calendar and astronomy hot paths
+ *
+ * Times per-call cost and throughput of the core conversions over random
+ * and sequential JD inputs spanning several millennia. Each benchmark runs
+ * one cold pass (caches as left by earlier benchmarks) followed by warm
+ * repetitions; the best warm pass is reported.
+ *
+ * Output is CSV on stdout, one line per benchmark:
+ *   bench,input,calls,cold_ns_per_call,warm_ns_per_call,warm_calls_per_sec
+ *
+ * Usage: bench_celtic [-n calls] [-r repeats] [-s seed] [-f name-substring]
+ *                     [-e ephemeris.eph]   (answer from a mapped ephemeris file)
+ *                     [-t fast|standard|high]   (precision tier, precision.h)
+ */
+#define _XOPEN_SOURCE 700
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "calendar.h"
+#include "astronomy.h"
+#include "glyphs.h"
+#include "ephemeris.h"
+#include "location.h"
+#include "search.h"
+#include "cursor.h"
+
+#define BENCH_FIRST_YEAR   (-1000)
+#define BENCH_LAST_YEAR    3000
+#define BENCH_LATITUDE     46.38   /* Coligny, as in main.c */
+#define RENDER_CALL_DIVISOR 1000   /* Month renders are ~1000x dearer */
+#define LOG_STEP_SECONDS   37      /* Sequential timestamps: a busy event log */
+#define PACK_CHUNK         1024    /* Timestamps per location_pack_days() call */
+#define UNIX_EPOCH_JD      2440588L
+
+typedef enum { INPUT_RANDOM, INPUT_SEQUENTIAL } InputKind;
+
+typedef struct {
+    const long *jd;
+    const int *year;
+    const int *month;
+    const int *day;
+    const time_t *times;
+    int count;
+} BenchInput;
+
+typedef long (*BenchFn)(const BenchInput *in);
+
+/* Accumulates results so the compiler cannot drop the calls */
+static volatile long bench_sink;
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * INPUT GENERATION
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static unsigned long long rng_state;
+
+static unsigned long long rng_next(void)
+{
+    /* xorshift64* */
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 2685821657736338717ULL;
+}
+
+static long rng_range(long lo, long hi)
+{
+    return lo + (long)(rng_next() % (unsigned long long)(hi - lo + 1));
+}
+
+static void fill_input(BenchInput *in, long *jd, int *year, int *month, int *day,
+                       time_t *times, int count, InputKind kind)
+{
+    long jd_first = jd_from_ymd(BENCH_FIRST_YEAR, 1, 1);
+    long jd_last = jd_from_ymd(BENCH_LAST_YEAR, 12, 31);
+    long jd_seq = jd_from_ymd(2000, 1, 1);
+
+    for (int i = 0; i < count; i++) {
+        if (kind == INPUT_RANDOM) {
+            jd[i] = rng_range(jd_first, jd_last);
+            year[i] = (int)rng_range(BENCH_FIRST_YEAR, BENCH_LAST_YEAR);
+            month[i] = (int)rng_range(1, 12);
+            day[i] = (int)rng_range(1, 28);
+            times[i] = (time_t)(jd[i] - UNIX_EPOCH_JD) * 86400 + (time_t)rng_range(0, 86399);
+        } else {
+            jd[i] = jd_seq + i;
+            year[i] = BENCH_FIRST_YEAR + i % (BENCH_LAST_YEAR - BENCH_FIRST_YEAR + 1);
+            month[i] = 1 + (i / 28) % 12;
+            day[i] = 1 + i % 28;
+            times[i] = (time_t)(jd_seq - UNIX_EPOCH_JD) * 86400 + (time_t)i * LOG_STEP_SECONDS;
+        }
+    }
+
+    in->jd = jd;
+    in->year = year;
+    in->month = month;
+    in->day = day;
+    in->times = times;
+    in->count = count;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * BENCHMARK BODIES
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static long bench_jd_from_ymd(const BenchInput *in)
+{
+    long acc = 0;
+    for (int i = 0; i < in->count; i++) acc += jd_from_ymd(in->year[i], in->month[i], in->day[i]);
+    return acc;
+}
+
+static long bench_celtic_year_from_jd(const BenchInput *in)
+{
+    long acc = 0;
+    for (int i = 0; i < in->count; i++) acc += celtic_year_from_jd(in->jd[i]);
+    return acc;
+}
+
+static long bench_day_of_month(const BenchInput *in)
+{
+    long acc = 0;
+    for (int i = 0; i < in->count; i++) acc += day_of_month(in->jd[i]);
+    return acc;
+}
+
+static long bench_lunar_celtic_month_index(const BenchInput *in)
+{
+    long acc = 0;
+    for (int i = 0; i < in->count; i++) acc += lunar_celtic_month_index(in->jd[i]);
+    return acc;
+}
+
+static long bench_find_samonios_start(const BenchInput *in)
+{
+    long acc = 0;
+    for (int i = 0; i < in->count; i++) acc += find_samonios_start(in->year[i]);
+    return acc;
+}
+
+static long bench_sun_longitude(const BenchInput *in)
+{
+    double acc = 0;
+    for (int i = 0; i < in->count; i++) acc += sun_longitude(in->jd[i]);
+    return (long)acc;
+}
+
+static long bench_moon_phase(const BenchInput *in)
+{
+    long acc = 0;
+    for (int i = 0; i < in->count; i++) acc += moon_phase(in->jd[i]);
+    return acc;
+}
+
+/* Lunation numbers from the inputs; jd_of_full_moon() itself does the work */
+static long bench_jd_of_full_moon(const BenchInput *in)
+{
+    long acc = 0;
+    for (int i = 0; i < in->count; i++) acc += jd_of_full_moon((in->jd[i] - 2451550L) / 29);
+    return acc;
+}
+
+static long bench_days_to_true_samhain(const BenchInput *in)
+{
+    long acc = 0;
+    for (int i = 0; i < in->count; i++) acc += days_to_true_samhain(in->jd[i]);
+    return acc;
+}
+
+static long bench_calculate_sunset(const BenchInput *in)
+{
+    double acc = 0.0;
+    for (int i = 0; i < in->count; i++) acc += calculate_sunset(in->jd[i], BENCH_LATITUDE);
+    return (long)acc;
+}
+
+/* Same query through a location's cached sunset blocks */
+static long bench_location_sunset(const BenchInput *in)
+{
+    CelticLocation site = location_make(BENCH_LATITUDE, 5.35, 1.0);
+    double acc = 0.0;
+    for (int i = 0; i < in->count; i++) acc += location_sunset(&site, in->jd[i]);
+    return (long)acc;
+}
+
+/* Timestamps to packed Celtic days, chunked as a log enricher would */
+static long bench_location_pack_days(const BenchInput *in)
+{
+    CelticLocation site = location_make(BENCH_LATITUDE, 5.35, 1.0);
+    CelticDayPacked out[PACK_CHUNK];
+    long acc = 0;
+    for (int i = 0; i < in->count; i += PACK_CHUNK) {
+        int n = in->count - i < PACK_CHUNK ? in->count - i : PACK_CHUNK;
+        location_pack_days(&site, in->times + i, (size_t)n, out);
+        acc += out[n - 1].jd;
+    }
+    return acc;
+}
+
+static long bench_nearest_eightfold_event(const BenchInput *in)
+{
+    long acc = 0;
+    for (int i = 0; i < in->count; i++) {
+        int days;
+        acc += nearest_eightfold_event(in->jd[i], &days) + days;
+    }
+    return acc;
+}
+
+/* Every field of each day through one cursor: single steps on sequential input */
+static long bench_cursor_seek(const BenchInput *in)
+{
+    CelticCursor c;
+    cursor_init(&c, in->jd[0]);
+    long acc = 0;
+    for (int i = 0; i < in->count; i++) {
+        cursor_seek(&c, in->jd[i]);
+        acc += c.lunar_month + c.lunar_day + c.metonic_lunation + c.event_days + c.date.day_of_month;
+    }
+    return acc;
+}
+
+/* Full daily view render, set up as main.c does; output goes to /dev/null */
+static long bench_print_celtic_month_lunar(const BenchInput *in)
+{
+    int count = in->count / RENDER_CALL_DIVISOR;
+    if (count < 1) count = 1;
+
+    for (int i = 0; i < count; i++) {
+        long jd = in->jd[i];
+        int month_idx = lunar_celtic_month_index(jd);
+        long jd_month_start = find_full_moon_before(jd);
+        int month_days = lunar_month_length(jd);
+        print_celtic_month_lunar(month_idx, jd_month_start, jd, jd, month_days, 0);
+    }
+    return count;
+}
+
+/* Whole-year sheet, three blocks across, formatted on one thread */
+static long bench_render_celtic_year(const BenchInput *in)
+{
+    int count = in->count / RENDER_CALL_DIVISOR;
+    if (count < 1) count = 1;
+
+    RenderSink out;
+    render_sink_init(&out);
+    long acc = 0;
+    for (int i = 0; i < count; i++) {
+        render_sink_reset(&out);
+        render_celtic_year(&out, in->year[i], in->jd[i], 3, 1);
+        acc += out.line_count;
+    }
+    render_sink_free(&out);
+    return acc;
+}
+
+/* One year of "festival days at a full moon" from each start day */
+static long bench_celtic_search_year(const BenchInput *in)
+{
+    int count = in->count / RENDER_CALL_DIVISOR;
+    if (count < 1) count = 1;
+
+    CelticQuery q;
+    celtic_query_init(&q);
+    celtic_query_parse(&q, "festival");
+    celtic_query_parse(&q, "phase=full");
+    long acc = 0;
+    for (int i = 0; i < count; i++) acc += celtic_search(&q, in->jd[i], in->jd[i] + 365, NULL, NULL);
+    return acc;
+}
+
+typedef struct {
+    const char *name;
+    BenchFn fn;
+    int renders;   /* Runs calls / RENDER_CALL_DIVISOR iterations */
+} Benchmark;
+
+static const Benchmark benchmarks[] = {
+    {"jd_from_ymd",              bench_jd_from_ymd,              0},
+    {"celtic_year_from_jd",      bench_celtic_year_from_jd,      0},
+    {"day_of_month",             bench_day_of_month,             0},
+    {"lunar_celtic_month_index", bench_lunar_celtic_month_index, 0},
+    {"find_samonios_start",      bench_find_samonios_start,      0},
+    {"sun_longitude",            bench_sun_longitude,            0},
+    {"moon_phase",               bench_moon_phase,               0},
+    {"jd_of_full_moon",          bench_jd_of_full_moon,          0},
+    {"days_to_true_samhain",     bench_days_to_true_samhain,     0},
+    {"calculate_sunset",         bench_calculate_sunset,         0},
+    {"location_sunset",          bench_location_sunset,          0},
+    {"location_pack_days",       bench_location_pack_days,       0},
+    {"nearest_eightfold_event",  bench_nearest_eightfold_event,  0},
+    {"cursor_seek",              bench_cursor_seek,              0},
+    {"print_celtic_month_lunar", bench_print_celtic_month_lunar, 1},
+    {"render_celtic_year",       bench_render_celtic_year,       1},
+    {"celtic_search_year",       bench_celtic_search_year,       1},
+};
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * TIMING
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Point stdout at /dev/null while rendering; returns the saved descriptor */
+static int silence_stdout(void)
+{
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (null_fd >= 0) {
+        dup2(null_fd, STDOUT_FILENO);
+        close(null_fd);
+    }
+    return saved;
+}
+
+static void restore_stdout(int saved)
+{
+    fflush(stdout);
+    if (saved >= 0) {
+        dup2(saved, STDOUT_FILENO);
+        close(saved);
+    }
+}
+
+static double time_pass(const Benchmark *b, const BenchInput *in)
+{
+    int saved = b->renders ? silence_stdout() : -1;
+    double start = now_ns();
+    bench_sink += b->fn(in);
+    double elapsed = now_ns() - start;
+    if (b->renders) restore_stdout(saved);
+    return elapsed;
+}
+
+static void run_benchmark(const Benchmark *b, const BenchInput *in, const char *input_name, int repeats)
+{
+    int calls = in->count;
+    if (b->renders) {
+        calls /= RENDER_CALL_DIVISOR;
+        if (calls < 1) calls = 1;
+    }
+
+    double cold = time_pass(b, in);
+    double warm = cold;
+    for (int r = 0; r < repeats; r++) {
+        double t = time_pass(b, in);
+        if (t < warm) warm = t;
+    }
+
+    double cold_per_call = cold / calls;
+    double warm_per_call = warm / calls;
+    printf("%s,%s,%d,%.1f,%.1f,%.0f\n", b->name, input_name, calls,
+           cold_per_call, warm_per_call, warm_per_call > 0 ? 1e9 / warm_per_call : 0.0);
+    fflush(stdout);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [-n calls] [-r repeats] [-s seed] [-f name-substring] [-e ephemeris.eph]\n"
+                    "       [-t fast|standard|high]\n", prog);
+}
+
+int main(int argc, char *argv[])
+{
+    int calls = 200000;
+    int repeats = 5;
+    unsigned long long seed = 0x9E3779B97F4A7C15ULL;
+    const char *filter = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "-n") == 0) {
+            calls = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "-r") == 0) {
+            repeats = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "-s") == 0) {
+            seed = strtoull(argv[++i], NULL, 0);
+        } else if (i + 1 < argc && strcmp(argv[i], "-f") == 0) {
+            filter = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "-e") == 0) {
+            if (ephemeris_open(argv[++i]) != 0) {
+                perror(argv[i]);
+                return 1;
+            }
+        } else if (i + 1 < argc && strcmp(argv[i], "-t") == 0) {
+            PrecisionTier tier;
+            if (precision_tier_parse(argv[++i], &tier) != 0 || astronomy_set_tier(tier) != 0) {
+                usage(argv[0]);
+                return 1;
+            }
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (calls < 1 || repeats < 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    rng_state = seed ? seed : 1;
+
+    long *jd = malloc(sizeof(long) * calls);
+    int *year = malloc(sizeof(int) * calls);
+    int *month = malloc(sizeof(int) * calls);
+    int *day = malloc(sizeof(int) * calls);
+    time_t *times = malloc(sizeof(time_t) * calls);
+    if (!jd || !year || !month || !day || !times) {
+        fprintf(stderr, "bench_celtic: out of memory\n");
+        return 1;
+    }
+
+    printf("bench,input,calls,cold_ns_per_call,warm_ns_per_call,warm_calls_per_sec\n");
+
+    static const struct { InputKind kind; const char *name; } inputs[] = {
+        {INPUT_RANDOM, "random"},
+        {INPUT_SEQUENTIAL, "sequential"},
+    };
+
+    for (size_t k = 0; k < sizeof(inputs) / sizeof(inputs[0]); k++) {
+        BenchInput in;
+        fill_input(&in, jd, year, month, day, times, calls, inputs[k].kind);
+        for (size_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++) {
+            if (filter && !strstr(benchmarks[i].name, filter)) continue;
+            run_benchmark(&benchmarks[i], &in, inputs[k].name, repeats);
+        }
+    }
+
+    free(jd);
+    free(year);
+    free(month);
+    free(day);
+    free(times);
+    return 0;
+}
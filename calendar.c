@@ -1,7 +1,12 @@
 #include "calendar.h"
 #include "astronomy.h"
+#include "ephemeris.h"
+#include "data.h"
+#include "profile.h"
 #include <time.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
 
 /*
  * Celtic Calendar Epoch and Cycle Constants
@@ -39,24 +44,83 @@ static const int month_start[12] = {0, 29, 59, 88, 117, 147, 176, 206, 235, 265,
 /* Target solar longitude for Samhain */
 #define SAMHAIN_LONG 225.0
 
+/*
+ * Samhain cache
+ *
+ * Every year-relative accessor below resolves the Samhain on either side of
+ * the date, and each resolution is a 61-day sun_longitude() scan. Results are
+ * memoized per Gregorian year: a table covers the configured span (default
+ * 3102 BCE .. 3000 CE, astronomical year numbering) and a small direct-mapped
+ * cache catches years outside it. Slots fill lazily; samhain_cache_prefill()
+ * computes the whole span up front for bulk conversions.
+ *
+ * The caches are thread-local: each thread warms its own copy, so
+ * conversions run on worker threads without locking. When a precomputed
+ * ephemeris is mapped (ephemeris.h), misses inside its span are filled
+ * from the file instead of the longitude search.
+ */
+#ifndef SAMHAIN_CACHE_FIRST_YEAR
+#define SAMHAIN_CACHE_FIRST_YEAR (-3101)
+#endif
+#ifndef SAMHAIN_CACHE_LAST_YEAR
+#define SAMHAIN_CACHE_LAST_YEAR 3000
+#endif
+#define SAMHAIN_CACHE_SPAN (SAMHAIN_CACHE_LAST_YEAR - SAMHAIN_CACHE_FIRST_YEAR + 1)
+#define SAMHAIN_OVERFLOW_SLOTS 64
+
+/* 0 marks an empty slot; no Samhain inside the span falls on JD 0 */
+static _Thread_local long samhain_table[SAMHAIN_CACHE_SPAN];
+
+static _Thread_local struct {
+    int valid;
+    int year;
+    long jd;
+} samhain_overflow[SAMHAIN_OVERFLOW_SLOTS];
+
 /* Find the JD of Samhain (Sun ≈ 225°) for a given Gregorian year */
+static long compute_true_samhain_for_year(int greg_year)
+{
+    const EphemerisYear *rec = ephemeris_year(greg_year);
+    if (rec) return (long)rec->samhain_day;
+
+    /* Nearest whole day to the exact crossing, searched from early November */
+    long start = jd_from_ymd(greg_year, 11, 7);
+    return lround(solar_longitude_crossing((double)start, SAMHAIN_LONG));
+}
+
+/* Cached Samhain lookup; see the cache notes above */
 static long jd_true_samhain_for_year(int greg_year)
 {
-    long start = jd_from_ymd(greg_year, 10, 15); /* search window Oct 15 */
-    double best_diff = 1e9;
-    long best_jd = start;
-    for (int d = 0; d <= 60; d++) {
-        long jd = start + d;
-        double diff = sun_longitude(jd) - SAMHAIN_LONG;
-        if (diff > 180.0) diff -= 360.0;
-        if (diff < -180.0) diff += 360.0;
-        double ad = (diff < 0) ? -diff : diff;
-        if (ad < best_diff) {
-            best_diff = ad;
-            best_jd = jd;
+    if (greg_year >= SAMHAIN_CACHE_FIRST_YEAR && greg_year <= SAMHAIN_CACHE_LAST_YEAR) {
+        long *slot = &samhain_table[greg_year - SAMHAIN_CACHE_FIRST_YEAR];
+        if (*slot == 0) {
+            PROFILE_BEGIN(PROF_SAMHAIN_MISS);
+            *slot = compute_true_samhain_for_year(greg_year);
+            PROFILE_END(PROF_SAMHAIN_MISS);
+        } else {
+            PROFILE_COUNT(PROF_SAMHAIN_HIT);
         }
+        return *slot;
+    }
+
+    int idx = (int)((unsigned)greg_year % SAMHAIN_OVERFLOW_SLOTS);
+    if (!samhain_overflow[idx].valid || samhain_overflow[idx].year != greg_year) {
+        PROFILE_BEGIN(PROF_SAMHAIN_MISS);
+        samhain_overflow[idx].year = greg_year;
+        samhain_overflow[idx].jd = compute_true_samhain_for_year(greg_year);
+        samhain_overflow[idx].valid = 1;
+        PROFILE_END(PROF_SAMHAIN_MISS);
+    } else {
+        PROFILE_COUNT(PROF_SAMHAIN_HIT);
+    }
+    return samhain_overflow[idx].jd;
+}
+
+void samhain_cache_prefill(void)
+{
+    for (int y = SAMHAIN_CACHE_FIRST_YEAR; y <= SAMHAIN_CACHE_LAST_YEAR; y++) {
+        jd_true_samhain_for_year(y);
     }
-    return best_jd;
 }
 
 /* Convert JD to Gregorian year (rough, good enough for selecting Samhain year) */
@@ -98,6 +162,37 @@ long jd_from_ymd(int Y, int M, int D)
            D + B - 1524;
 }
 
+/*
+ * Gregorian date of a JD, the inverse of jd_from_ymd(). Meeus' inversion is
+ * exact from 0 CE on; before that jd_from_ymd() truncates toward zero, so
+ * the date is found by search against jd_from_ymd() itself.
+ */
+void ymd_from_jd(long jd, int *Y, int *M, int *D)
+{
+    long alpha = (long)((jd - 1867216.25) / 36524.25);
+    long a = jd + 1 + alpha - alpha / 4;
+    long b = a + 1524;
+    long c = (long)((b - 122.1) / 365.25);
+    long d = (long)(365.25 * c);
+    long e = (long)((b - d) / 30.6001);
+    int day = (int)(b - d - (long)(30.6001 * e));
+    int month = (int)((e < 14) ? e - 1 : e - 13);
+    int year = (int)((month > 2) ? c - 4716 : c - 4715);
+
+    if (year < 0 || jd_from_ymd(year, month, day) != jd) {
+        year = (int)floor((jd - 1721060) / 365.2425);
+        while (jd_from_ymd(year, 1, 1) > jd) year--;
+        while (jd_from_ymd(year + 1, 1, 1) <= jd) year++;
+        month = 1;
+        while (month < 12 && jd_from_ymd(year, month + 1, 1) <= jd) month++;
+        day = (int)(jd - jd_from_ymd(year, month, 1)) + 1;
+    }
+
+    *Y = year;
+    *M = month;
+    *D = day;
+}
+
 long jd_today(void)
 {
     time_t t = time(NULL);
@@ -105,17 +200,67 @@ long jd_today(void)
     return jd_from_ymd(g->tm_year + 1900, g->tm_mon + 1, g->tm_mday);
 }
 
+/* Every field of jd from the bounds of the Celtic year holding it */
+static void celtic_date_fill(long jd, long year_start, int year_length, int year, CelticDate *out)
+{
+    out->jd = jd;
+    out->year_start = year_start;
+    out->year = year;
+    out->day_of_year = (int)(jd - year_start) + 1;
+    out->year_length = year_length;
+    out->days_remaining = out->year_length - out->day_of_year;
+    out->elapsed_fraction = (double)(out->day_of_year - 1) / (double)out->year_length;
+
+    /* Month by cumulative start day; the intercalary tail stays in month 11 */
+    int month = 0;
+    for (int m = 11; m >= 0; m--) {
+        if (out->day_of_year > month_start[m]) {
+            month = m;
+            break;
+        }
+    }
+    out->month_index = month;
+    out->day_of_month = out->day_of_year - month_start[month];
+
+    int adjusted = out->year + AGE_OFFSET;
+    out->age = adjusted / AGE_YEARS;
+    out->year_in_age = (adjusted - 1) % AGE_YEARS + 1;
+
+    out->is_mat = is_mat_month(month);
+    out->is_atenoux = is_atenoux(out->day_of_month);
+    out->is_d_amb = is_d_amb(out->day_of_month);
+}
+
 /*
- * Calculate Celtic year from Julian Day
- * Uses the 5-year cycle for precision
+ * Decompose a JD into every Celtic calendar field with one Samhain lookup.
+ * The single-field accessors below are thin wrappers around this.
  */
-int celtic_year_from_jd(long jd)
+void celtic_date_from_jd(long jd, CelticDate *out)
 {
+    PROFILE_COUNT(PROF_CELTIC_DATE);
     long prev_sam, next_sam;
     int prev_year;
     samhain_bounds(jd, &prev_sam, &next_sam, &prev_year);
-    int delta_years = prev_year - ANCHOR_SAMHAIN_YEAR;
-    return ANCHOR_YEAR + delta_years;
+    celtic_date_fill(jd, prev_sam, (int)(next_sam - prev_sam),
+                     ANCHOR_YEAR + (prev_year - ANCHOR_SAMHAIN_YEAR), out);
+}
+
+int celtic_date_move(CelticDate *date, long jd)
+{
+    if (jd < date->year_start || jd >= date->year_start + date->year_length) return -1;
+    celtic_date_fill(jd, date->year_start, date->year_length, date->year, date);
+    return 0;
+}
+
+/*
+ * Calculate Celtic year from Julian Day
+ * Uses the 5-year cycle for precision
+ */
+int celtic_year_from_jd(long jd)
+{
+    CelticDate cd;
+    celtic_date_from_jd(jd, &cd);
+    return cd.year;
 }
 
 /*
@@ -123,11 +268,9 @@ int celtic_year_from_jd(long jd)
  */
 int day_of_year(long jd)
 {
-    long prev_sam, next_sam;
-    int prev_year;
-    samhain_bounds(jd, &prev_sam, &next_sam, &prev_year);
-    (void)prev_year;
-    return (int)(jd - prev_sam) + 1;
+    CelticDate cd;
+    celtic_date_from_jd(jd, &cd);
+    return cd.day_of_year;
 }
 
 /*
@@ -146,11 +289,9 @@ int day_of_year(long jd)
  */
 int current_year_length(long jd)
 {
-    long prev_sam, next_sam;
-    int prev_year;
-    samhain_bounds(jd, &prev_sam, &next_sam, &prev_year);
-    (void)prev_year;
-    return (int)(next_sam - prev_sam);
+    CelticDate cd;
+    celtic_date_from_jd(jd, &cd);
+    return cd.year_length;
 }
 
 /*
@@ -159,20 +300,116 @@ int current_year_length(long jd)
  */
 int celtic_month_index(long jd)
 {
-    int doy = day_of_year(jd);
+    CelticDate cd;
+    celtic_date_from_jd(jd, &cd);
+    return cd.month_index;
+}
+
+int day_of_month(long jd)
+{
+    CelticDate cd;
+    celtic_date_from_jd(jd, &cd);
+    return cd.day_of_month;
+}
+
+/*
+ * ============================================================
+ * BATCH CONVERSION
+ * Columns of JDs are converted in blocks. Within a block the dates are
+ * visited in ascending order, so a run of dates inside one Celtic year
+ * shares a single Samhain lookup and a run inside one lunar month span
+ * (lunar_month_span()) a single lunar month lookup. Sorted input skips the
+ * reordering step.
+ * ============================================================
+ */
+#define CELTIC_BATCH_BLOCK 512
+
+typedef struct {
+    long jd;
+    size_t idx;
+} BatchItem;
+
+static int compare_batch_items(const void *a, const void *b)
+{
+    long ja = ((const BatchItem *)a)->jd;
+    long jb = ((const BatchItem *)b)->jd;
+    return (ja > jb) - (ja < jb);
+}
+
+typedef struct {
+    long year_start, next_start;
+    int year;
+    long lunar_first, lunar_next;   /* Days sharing lunar_month */
+    int lunar_month;
+} BatchState;
+
+static void batch_convert_one(BatchState *st, long jd, size_t i, CelticDateColumns *out)
+{
+    if (jd < st->year_start || jd >= st->next_start) {
+        int prev_year;
+        samhain_bounds(jd, &st->year_start, &st->next_start, &prev_year);
+        st->year = ANCHOR_YEAR + (prev_year - ANCHOR_SAMHAIN_YEAR);
+    }
+
+    int doy = (int)(jd - st->year_start) + 1;
+    int month = 0;
     for (int m = 11; m >= 0; m--) {
         if (doy > month_start[m]) {
-            return m;
+            month = m;
+            break;
         }
     }
-    return 0;
+
+    if (out->year) out->year[i] = st->year;
+    if (out->day_of_year) out->day_of_year[i] = doy;
+    if (out->month_index) out->month_index[i] = month;
+    if (out->day_of_month) out->day_of_month[i] = doy - month_start[month];
+
+    if (out->lunar_month) {
+        if (jd < st->lunar_first || jd >= st->lunar_next) {
+            st->lunar_month = lunar_month_span(jd, &st->lunar_first, &st->lunar_next);
+        }
+        out->lunar_month[i] = st->lunar_month;
+    }
 }
 
-int day_of_month(long jd)
+void celtic_dates_from_jd_array(const long *jd, size_t n, CelticDateColumns *out)
 {
-    int doy = day_of_year(jd);
-    int month = celtic_month_index(jd);
-    return doy - month_start[month];
+    BatchState st;
+    st.year_start = 1;
+    st.next_start = 0;   /* empty range forces the first lookup */
+    st.year = 0;
+    st.lunar_first = 1;
+    st.lunar_next = 0;
+    st.lunar_month = 0;
+
+    BatchItem items[CELTIC_BATCH_BLOCK];
+
+    for (size_t base = 0; base < n; base += CELTIC_BATCH_BLOCK) {
+        size_t count = n - base;
+        if (count > CELTIC_BATCH_BLOCK) count = CELTIC_BATCH_BLOCK;
+
+        int sorted = 1;
+        for (size_t k = 1; k < count; k++) {
+            if (jd[base + k] < jd[base + k - 1]) { sorted = 0; break; }
+        }
+
+        if (sorted) {
+            for (size_t k = 0; k < count; k++) {
+                batch_convert_one(&st, jd[base + k], base + k, out);
+            }
+            continue;
+        }
+
+        for (size_t k = 0; k < count; k++) {
+            items[k].jd = jd[base + k];
+            items[k].idx = base + k;
+        }
+        qsort(items, count, sizeof(items[0]), compare_batch_items);
+        for (size_t k = 0; k < count; k++) {
+            batch_convert_one(&st, items[k].jd, items[k].idx, out);
+        }
+    }
 }
 
 long jd_start_of_celtic_month(int year, int month)
@@ -194,27 +431,69 @@ long jd_start_of_celtic_year(int year)
     return jd_true_samhain_for_year(samhain_year);
 }
 
+/*
+ * ============================================================
+ * INVERSE CONVERSION
+ * A Celtic date back to its JD. The fixed model needs the two Samhains of
+ * the year (the cached table) and the forward month_start[] offsets; the
+ * lunar model reads the lunation out of the year's cached full-moon list.
+ * Both are O(1) per date once the year is warm.
+ * ============================================================
+ */
+int jd_from_celtic(int year, int month_index, int day_of_month, long *jd)
+{
+    if (month_index < 0 || month_index > 11 || day_of_month < 1) return -1;
+
+    int samhain_year = ANCHOR_SAMHAIN_YEAR + (year - ANCHOR_YEAR);
+    long year_start = jd_true_samhain_for_year(samhain_year);
+
+    /* Month 11 keeps the intercalary tail up to the next Samhain */
+    long month_end = (month_index < 11) ? year_start + month_start[month_index + 1]
+                                        : jd_true_samhain_for_year(samhain_year + 1);
+    long day = year_start + month_start[month_index] + day_of_month - 1;
+    if (day >= month_end) return -1;
+    *jd = day;
+    return 0;
+}
+
+int jd_from_lunar_celtic(int year, int lunar_month, int lunar_day, long *jd)
+{
+    if (lunar_month < -1 || lunar_month > 11 || lunar_day < 1) return -1;
+
+    const LunarYear *ly = lunar_year(ANCHOR_SAMHAIN_YEAR + (year - ANCHOR_YEAR));
+
+    /* Inverse of the month numbering: Samonios (6) is lunation 0 of the year */
+    int k = (lunar_month < 0) ? 12 : (lunar_month + 6) % 12;
+    if (k >= ly->months) return -1;
+
+    long day = ly->full_moons[k] + lunar_day - 1;
+    if (day >= ly->full_moons[k + 1]) return -1;
+    *jd = day;
+    return 0;
+}
+
 double elapsed_fraction(long jd)
 {
-    int day = day_of_year(jd);
-    int year_len = current_year_length(jd);
-    return (double)(day - 1) / (double)year_len;
+    CelticDate cd;
+    celtic_date_from_jd(jd, &cd);
+    return cd.elapsed_fraction;
 }
 
 int days_remaining(long jd)
 {
-    return current_year_length(jd) - day_of_year(jd);
+    CelticDate cd;
+    celtic_date_from_jd(jd, &cd);
+    return cd.days_remaining;
 }
 
 void age_and_year_in_age(long jd, int *age, int *year_in_age)
 {
-    int year = celtic_year_from_jd(jd);
-    int adjusted = year + AGE_OFFSET;
-    *age = adjusted / AGE_YEARS;
-    *year_in_age = (adjusted - 1) % AGE_YEARS + 1;
+    CelticDate cd;
+    celtic_date_from_jd(jd, &cd);
+    *age = cd.age;
+    *year_in_age = cd.year_in_age;
 }
 
-
 const char *get_celtic_month_name(int month_index)
 {
     static const char *months[] = {
@@ -243,13 +522,11 @@ const char *get_month_abbrev(int month_index)
  * MAT (good/auspicious) months: SAM, RIV, OGR, CUT, SIM, AED
  * ANM (not good) months: DUM, ANA, GIA, EQU, ELE, CAN
  * Summer season (SAM-CUT) has 4 MAT, Winter (GIA-CAN) has 2 MAT
+ * (MAT is the same bit on every day of a month's row in data.c)
  */
 int is_mat_month(int month_index)
 {
-    /* MAT months in Giamos-first order: SIM, AED, SAM, RIV, OGR, CUT */
-    static const int mat[] = {0, 1, 0, 0, 1, 0, 1, 0, 1, 0, 1, 1};
-    if(month_index < 0 || month_index > 11) return 0;
-    return mat[month_index];
+    return (coligny_day_attr[coligny_row(month_index)][1] & COLIGNY_MAT) ? 1 : 0;
 }
 
 /*
@@ -257,13 +534,11 @@ int is_mat_month(int month_index)
  * 30 days: SAM, RIV, OGR, CUT, SIM, AED (MAT months)
  * 29 days: DUM, ANA, GIA, ELE, CAN (ANM months)
  * Variable: EQU (29 or 30, we use 29 by default)
+ * Quimonios (intercalary) and unknown indices: 30
  */
 int get_month_days(int month_index)
 {
-    /* Authentic lengths rotated so Giamonios opens the year */
-    static const int days[] = {29, 30, 29, 29, 30, 29, 30, 29, 30, 29, 30, 30};
-    if(month_index < 0 || month_index > 11) return 30;
-    return days[month_index];
+    return coligny_month_days[coligny_row(month_index)];
 }
 
 /*
@@ -278,16 +553,15 @@ int is_atenoux(int day_of_month)
 /*
  * D AMB (D AMBRIX RI) - inauspicious days pattern from Coligny:
  * First half (1-15): Days 5 and 11 only
- * Second half (16-30): Every odd day EXCEPT day 16 (=day 1a) */
+ * Second half (16-30): Every odd day EXCEPT day 16 (=day 1a)
+ * The pattern is the same in every month (see data.c).
+ */
 int is_d_amb(int day_of_month)
 {
-    if (day_of_month <= 15) {
-        /* First coicíse: only days 5 and 11 are D AMB */
-        return (day_of_month == 5 || day_of_month == 11) ? 1 : 0;
-    } else {
-        /* Second coicíse (after ATENOUX): odd days except 16 (=day 1a) */
-        if (day_of_month == 16) return 0;  /* Day 16 (1a) not inauspicious */
-        return (day_of_month % 2 == 1) ? 1 : 0;  /* Odd days */
+    if (day_of_month >= COLIGNY_DAY_STRIDE) {
+        /* Intercalary tail of the fixed model's month 11: odd days continue */
+        return day_of_month % 2 == 1;
     }
+    return (coligny_day(0, day_of_month) & COLIGNY_D_AMB) ? 1 : 0;
 }
 
@@ -1,9 +1,53 @@
 #ifndef CALENDAR_H
 #define CALENDAR_H
 
+#include <stddef.h>
+
+/* Every calendar field for one Celtic day (fixed month_start[] month model) */
+typedef struct {
+    long jd;
+    long year_start;         /* JD of the Samhain that opened this year */
+    int year;                /* Celtic year */
+    int day_of_year;         /* 1-based */
+    int year_length;         /* Days from this Samhain to the next */
+    int days_remaining;
+    double elapsed_fraction; /* 0.0 at Samhain */
+    int month_index;         /* 0-11 */
+    int day_of_month;        /* 1-based */
+    int age;
+    int year_in_age;
+    int is_mat;              /* 1 = MAT month, 0 = ANM */
+    int is_atenoux;          /* 1 = second half-month */
+    int is_d_amb;            /* 1 = D AMB (inauspicious) */
+} CelticDate;
+
 long jd_from_ymd(int Y, int M, int D);
+void ymd_from_jd(long jd, int *Y, int *M, int *D);   /* Inverse of jd_from_ymd() */
 long jd_today(void);
 
+/* Resolve all CelticDate fields in one pass */
+void celtic_date_from_jd(long jd, CelticDate *out);
+
+/* Re-resolve a date for another day of its own Celtic year without a Samhain
+ * lookup; returns -1 (date untouched) if jd lies outside that year */
+int celtic_date_move(CelticDate *date, long jd);
+
+/*
+ * Struct-of-arrays output for celtic_dates_from_jd_array(). Each non-NULL
+ * column must hold n entries; NULL columns are skipped (leaving lunar_month
+ * NULL avoids the lunation lookups entirely).
+ */
+typedef struct {
+    int *year;
+    int *day_of_year;
+    int *month_index;
+    int *day_of_month;
+    int *lunar_month;    /* lunar_celtic_month_index() */
+} CelticDateColumns;
+
+/* Convert a column of JDs; sorted input is fastest but any order works */
+void celtic_dates_from_jd_array(const long *jd, size_t n, CelticDateColumns *out);
+
 int celtic_year_from_jd(long jd);
 int day_of_year(long jd);
 int day_of_month(long jd);
@@ -11,6 +55,27 @@ int celtic_month_index(long jd);
 long jd_start_of_celtic_month(int year, int month);
 long jd_start_of_celtic_year(int year);
 
+/*
+ * Inverse conversions: the JD of a Celtic date, or -1 (jd untouched) if the
+ * date does not exist in that year.
+ *   jd_from_celtic()        fixed model: celtic_date_from_jd()'s year,
+ *                           month_index (0-11) and day_of_month; month 11
+ *                           runs to the next Samhain
+ *   jd_from_lunar_celtic()  lunar model: month as lunar_celtic_month_index()
+ *                           (-1 = Quimonios, only in 13-month years), day as
+ *                           lunar_day_of_month(); year is the Celtic year
+ *                           whose Samonios opens the lunar year. Days that
+ *                           lunar_celtic_month_index() still counts into the
+ *                           old year (a Samonios before November 1, see
+ *                           lunar_month_span()) are the new year's Samonios
+ *                           here, as in the lunar year views
+ */
+int jd_from_celtic(int year, int month_index, int day_of_month, long *jd);
+int jd_from_lunar_celtic(int year, int lunar_month, int lunar_day, long *jd);
+
+/* Precompute the calling thread's Samhain table for the whole cached span (optional warm-up) */
+void samhain_cache_prefill(void);
+
 double elapsed_fraction(long jd);
 int days_remaining(long jd);
 int current_year_length(long jd);
@@ -0,0 +1,21 @@
+#include "celticcal.h"
+
+#define CELTICCAL_STR_(x) #x
+#define CELTICCAL_STR(x) CELTICCAL_STR_(x)
+
+unsigned celticcal_version(void)
+{
+    return CELTICCAL_VERSION;
+}
+
+const char *celticcal_version_string(void)
+{
+    return CELTICCAL_STR(CELTICCAL_VERSION_MAJOR) "."
+           CELTICCAL_STR(CELTICCAL_VERSION_MINOR) "."
+           CELTICCAL_STR(CELTICCAL_VERSION_PATCH);
+}
+
+void celticcal_event_year(int samhain_year, EventYear *out)
+{
+    *out = *event_year(samhain_year);
+}
@@ -0,0 +1,60 @@
+#ifndef CELTICCAL_H
+#define CELTICCAL_H
+
+/*
+ * libcelticcal: the calendar and astronomy engine as a library
+ * (libcelticcal.so / libcelticcal.a, built from the lines in README.md).
+ *
+ * This header is the one to include from C, and the one FFI bindings
+ * (ctypes, cgo) are written against. The library exports exactly the
+ * functions declared through it, versioned by celticcal.map:
+ *   calendar.h    CelticDate, celtic_date_from_jd(), the batch column
+ *                 conversion celtic_dates_from_jd_array(), per-field helpers,
+ *                 the inverse jd_from_celtic() / jd_from_lunar_celtic()
+ *                 (CELTICCAL_1.2)
+ *   astronomy.h   moon / sun / sunset functions, EventYear and event_year(),
+ *                 precision tiers (precision.h, CELTICCAL_1.1)
+ *   location.h    observer sites, batch timestamp -> Celtic day
+ *   festivals.h   festival index and register_festival(), festival
+ *                 definition files (CELTICCAL_1.3)
+ *   cursor.h      incremental day cursor
+ *   ephemeris.h   loading a precomputed ephemeris file
+ *
+ * ABI: struct layouts and signatures reachable from here only change with
+ * CELTICCAL_VERSION_MAJOR (and the soname); minor versions only add.
+ * Bindings can compare celticcal_version() with the header they were
+ * generated from.
+ *
+ * Threads: every function may be called from any number of threads at
+ * once without locking. Caches (Samhain tables, event years, lunar years,
+ * festival years, sunset blocks) are per thread and freed when the thread
+ * exits; the festival index is a shared immutable snapshot, which
+ * register_festival() and festivals_load() replace without stopping
+ * readers; festivals_quiescent() lets a thread give up the old ones.
+ * The exceptions are setup calls: ephemeris_open(), ephemeris_close() and
+ * astronomy_set_tier() must not overlap lookups.
+ */
+#include "calendar.h"
+#include "astronomy.h"
+#include "location.h"
+#include "festivals.h"
+#include "cursor.h"
+#include "ephemeris.h"
+
+#define CELTICCAL_VERSION_MAJOR 1
+#define CELTICCAL_VERSION_MINOR 3
+#define CELTICCAL_VERSION_PATCH 0
+#define CELTICCAL_VERSION ((CELTICCAL_VERSION_MAJOR << 16) | (CELTICCAL_VERSION_MINOR << 8) | CELTICCAL_VERSION_PATCH)
+
+/* CELTICCAL_VERSION of the library actually loaded, and as "1.3.0" */
+unsigned celticcal_version(void);
+const char *celticcal_version_string(void);
+
+/*
+ * event_year() into caller storage. The pointer event_year() returns lives
+ * in the calling thread's cache and can be overwritten by its next lookup;
+ * bindings that keep the record should copy it with this instead.
+ */
+void celticcal_event_year(int samhain_year, EventYear *out);
+
+#endif
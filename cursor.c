@@ -0,0 +1,103 @@
+#include <math.h>
+#include "cursor.h"
+#include "astronomy.h"
+
+/*
+ * The next event has no span lookup of its own. Walking back past the day
+ * it became next finds the edge from next_eightfold_event() itself:
+ * galloping back until the answer changes, then bisecting. Events are
+ * weeks apart, so this runs once per event at most.
+ */
+static long event_span_first(long jd, double event_jd)
+{
+    double e;
+    long same = jd;
+    long step = 1;
+    long other = jd - 1;
+    while (next_eightfold_event(other, &e), e == event_jd) {
+        same = other;
+        step *= 2;
+        other = jd - step;
+    }
+    while (same - other > 1) {
+        long mid = other + (same - other) / 2;
+        next_eightfold_event(mid, &e);
+        if (e == event_jd) same = mid;
+        else other = mid;
+    }
+    return same;
+}
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════════
+ * CURSOR
+ * ═══════════════════════════════════════════════════════════════════════════
+ */
+void cursor_init(CelticCursor *c, long jd)
+{
+    /* Empty spans force every field to resolve */
+    c->date.year_start = 1;
+    c->date.year_length = 0;
+    c->lunation_start = 1;
+    c->lunation_next = 0;
+    c->month_first = 1;
+    c->month_next = 0;
+    c->metonic_year_first = 1;
+    c->metonic_year_next = 0;
+    c->metonic_lunation_first = 1;
+    c->metonic_lunation_next = 0;
+    c->event_first = jd;
+    c->event_jd = jd - 1.0;
+    cursor_seek(c, jd);
+}
+
+void cursor_seek(CelticCursor *c, long jd)
+{
+    c->jd = jd;
+
+    if (celtic_date_move(&c->date, jd) != 0) celtic_date_from_jd(jd, &c->date);
+
+    if (jd < c->lunation_start || jd >= c->lunation_next) {
+        c->lunation = lunation_number(jd);
+        c->lunation_start = jd_of_full_moon(c->lunation);
+        c->lunation_next = jd_of_full_moon(c->lunation + 1);
+        int length = (int)(c->lunation_next - c->lunation_start);
+        c->lunar_month_length = (length >= 30) ? 30 : 29;
+    }
+    c->lunar_day = (int)(jd - c->lunation_start) + 1;
+
+    if (jd < c->month_first || jd >= c->month_next) {
+        c->lunar_month = lunar_month_span(jd, &c->month_first, &c->month_next);
+    }
+
+    if (jd < c->metonic_year_first || jd >= c->metonic_year_next) {
+        c->metonic_year = metonic_year_span(jd, &c->metonic_year_first, &c->metonic_year_next);
+    }
+    if (jd < c->metonic_lunation_first || jd >= c->metonic_lunation_next) {
+        c->metonic_lunation = metonic_lunation_span(jd, &c->metonic_lunation_first, &c->metonic_lunation_next);
+    }
+
+    /*
+     * The cached event stays next until its own day has passed. Moving
+     * forward it is known to be next from the day it is looked up; only a
+     * step back before that day needs the true start of its span.
+     */
+    if (jd < c->event_first || lround(c->event_jd - jd) < 0) {
+        int back = jd < c->event_first;
+        c->event = next_eightfold_event(jd, &c->event_jd);
+        c->event_first = back ? event_span_first(jd, c->event_jd) : jd;
+    }
+    c->event_days = (int)lround(c->event_jd - jd);
+
+    c->festival = festival_lookup(c->lunar_month, c->lunar_day);
+}
+
+void cursor_next(CelticCursor *c)
+{
+    cursor_seek(c, c->jd + 1);
+}
+
+void cursor_prev(CelticCursor *c)
+{
+    cursor_seek(c, c->jd - 1);
+}
@@ -0,0 +1,55 @@
+#ifndef CURSOR_H
+#define CURSOR_H
+
+#include "calendar.h"
+#include "festivals.h"
+
+/*
+ * Day cursor for sequential walks (month grids, range exports, scans).
+ *
+ * A cursor holds everything the views ask of one day: the fixed-model
+ * CelticDate, the lunation and the lunar-synced month, the Metonic
+ * position, the next eight-fold event and the festival entry. Each field
+ * also remembers the span of days it holds for, so stepping a day only
+ * re-resolves the fields whose span was left; inside a Celtic year, a
+ * lunation and a Metonic month a step is a handful of additions.
+ *
+ * Every field equals its per-day function: celtic_date_from_jd(),
+ * lunation_number() and jd_of_full_moon(), lunar_day_of_month(),
+ * lunar_month_length(), lunar_celtic_month_index(), metonic_year(),
+ * metonic_lunation(), next_eightfold_event() and
+ * festival_lookup(lunar_month, lunar_day).
+ */
+typedef struct {
+    long jd;
+    CelticDate date;
+
+    long lunation;             /* lunation_number() */
+    long lunation_start;       /* First day of the lunation (full moon) */
+    long lunation_next;        /* First day of the next lunation */
+    int lunar_day;             /* 1-30 */
+    int lunar_month_length;    /* 29 or 30 */
+    int lunar_month;           /* 0-11, -1 = Quimonios */
+
+    int metonic_year;          /* 1-19 */
+    int metonic_lunation;      /* 1-235 */
+
+    int event;                 /* Next eight-fold event (0=Yule .. 7=Samhain) */
+    double event_jd;           /* Its exact time */
+    int event_days;            /* lround(event_jd - jd): 0 = on this day */
+
+    const FestivalIndexEntry *festival;   /* festival_lookup(lunar_month, lunar_day) */
+
+    /* Spans [first, next) over which the fields above hold */
+    long month_first, month_next;
+    long metonic_year_first, metonic_year_next;
+    long metonic_lunation_first, metonic_lunation_next;
+    long event_first;          /* The event is next from this day up to its own day */
+} CelticCursor;
+
+void cursor_init(CelticCursor *c, long jd);
+void cursor_seek(CelticCursor *c, long jd);   /* Any day; spans still held are kept */
+void cursor_next(CelticCursor *c);
+void cursor_prev(CelticCursor *c);
+
+#endif
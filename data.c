@@ -0,0 +1,55 @@
+#include "data.h"
+
+const char *moon_symbols[8] = {"🌑", "🌒", "🌓", "🌔", "🌕", "🌖", "🌗", "🌘"};
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════════
+ * COLIGNY DAY ATTRIBUTES
+ * The table is expanded by the compiler from the tablet rules below, so the
+ * rules stay readable in one place and no code runs to build it.
+ *
+ *   ATENOUX   days 16-30 (second coicíse)
+ *   D AMB     days 5 and 11; odd days of the second half except 16 (= 1a)
+ *   Triple    6-day cycle: ƚıı, ıƚı, ııƚ on days 1-3, 7-9, ...; none on 4-6
+ *   Notation  7 = PRINNI LOUD (MAT) / PRINNI LAG (ANM), 8-9 = M D / D,
+ *             22-24 = N INIS R, D AMB days = D AMB, else M D (MAT) / D (ANM)
+ * ═══════════════════════════════════════════════════════════════════════════
+ */
+#define DAY_ATENOUX(d)  ((d) > 15)
+#define DAY_D_AMB(d)    ((d) <= 15 ? ((d) == 5 || (d) == 11) : ((d) != 16 && (d) % 2 == 1))
+#define DAY_TRIPLE(d)   ((d) >= 1 && ((d) - 1) % 6 < 3 ? ((d) - 1) % 6 + 1 : 0)
+#define DAY_NOTATION(mat, d)                                                        \
+    (!DAY_ATENOUX(d) && (d) >= 7 && (d) <= 9                                        \
+         ? ((d) == 7 ? ((mat) ? NOTATION_PRINNI_LOUD : NOTATION_PRINNI_LAG)         \
+                     : ((mat) ? NOTATION_M_D : NOTATION_D))                         \
+     : DAY_ATENOUX(d) && (d) >= 22 && (d) <= 24 ? NOTATION_N_INIS_R                 \
+     : DAY_D_AMB(d) ? NOTATION_D_AMB                                                \
+     : ((mat) ? NOTATION_M_D : NOTATION_D))
+
+#define DAY_ATTR(mat, d)                                                            \
+    ((d) == 0 ? 0 :                                                                 \
+     ((mat) ? COLIGNY_MAT : 0) | (DAY_ATENOUX(d) ? COLIGNY_ATENOUX : 0) |           \
+     (DAY_D_AMB(d) ? COLIGNY_D_AMB : 0) | (DAY_TRIPLE(d) << COLIGNY_TRIPLE_SHIFT) | \
+     (DAY_NOTATION(mat, d) << COLIGNY_NOTATION_SHIFT))
+
+#define DAYS_4(mat, d) DAY_ATTR(mat, d), DAY_ATTR(mat, d + 1), DAY_ATTR(mat, d + 2), DAY_ATTR(mat, d + 3)
+#define ROW(mat) { DAYS_4(mat, 0), DAYS_4(mat, 4), DAYS_4(mat, 8), DAYS_4(mat, 12), \
+                   DAYS_4(mat, 16), DAYS_4(mat, 20), DAYS_4(mat, 24), DAYS_4(mat, 28) }
+
+/* MAT months in Giamos-first order: SIM, AED, SAM, RIV, OGR, CUT; Quimonios is ANM */
+const unsigned char coligny_day_attr[COLIGNY_ROWS][COLIGNY_DAY_STRIDE] = {
+    ROW(0), ROW(1), ROW(0), ROW(0), ROW(1), ROW(0),   /* GIA SIM EQU ELE AED CAN */
+    ROW(1), ROW(0), ROW(1), ROW(0), ROW(1), ROW(1),   /* SAM DUM RIV ANA OGR CUT */
+    ROW(0)                                            /* Quimonios */
+};
+
+/* Authentic lengths rotated so Giamonios opens the year; Quimonios has 30 */
+const unsigned char coligny_month_days[COLIGNY_ROWS] = {
+    29, 30, 29, 29, 30, 29, 30, 29, 30, 29, 30, 30, 30
+};
+
+const char *const coligny_notation_text[6] = {
+    "D", "M D", "PRINNI LOUD", "PRINNI LAG", "D AMB", "N INIS R"
+};
+
+const char *const coligny_triple_text[4] = {"   ", "ƚıı", "ıƚı", "ııƚ"};
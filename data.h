@@ -0,0 +1,56 @@
+#ifndef DATA_H
+#define DATA_H
+
+/* Moon phase glyphs, 8-step set indexed by moon_phase() */
+extern const char *moon_symbols[8];
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════════
+ * COLIGNY DAY ATTRIBUTES
+ * One byte per (month row, day) holding the whole tablet classification of
+ * the day. Rows 0-11 are the months in Giamonios-first order; row 12 is
+ * the intercalary Quimonios, which also catches any other index. Rows are
+ * COLIGNY_DAY_STRIDE bytes so a month's days are one contiguous run
+ * (index by day of month, 1-30; column 0 is unused).
+ * ═══════════════════════════════════════════════════════════════════════════
+ */
+#define COLIGNY_ROWS 13
+#define COLIGNY_QUIMONIOS_ROW 12
+#define COLIGNY_DAY_STRIDE 32
+
+#define COLIGNY_MAT             0x01    /* Month is MAT (auspicious) */
+#define COLIGNY_ATENOUX         0x02    /* Second half-month */
+#define COLIGNY_D_AMB           0x04    /* Inauspicious day */
+#define COLIGNY_TRIPLE_SHIFT    3       /* Triple mark: 0 none, 1 ƚıı, 2 ıƚı, 3 ııƚ */
+#define COLIGNY_TRIPLE_MASK     0x18
+#define COLIGNY_NOTATION_SHIFT  5       /* ColignyNotation */
+#define COLIGNY_NOTATION_MASK   0xE0
+
+typedef enum {
+    NOTATION_D,
+    NOTATION_M_D,
+    NOTATION_PRINNI_LOUD,
+    NOTATION_PRINNI_LAG,
+    NOTATION_D_AMB,
+    NOTATION_N_INIS_R
+} ColignyNotation;
+
+extern const unsigned char coligny_day_attr[COLIGNY_ROWS][COLIGNY_DAY_STRIDE];
+extern const unsigned char coligny_month_days[COLIGNY_ROWS];    /* 29 or 30 */
+extern const char *const coligny_notation_text[6];              /* By ColignyNotation */
+extern const char *const coligny_triple_text[4];                /* By triple mark */
+
+/* Table row of a month index (0-11); -1 (Quimonios) and anything else map to row 12 */
+static inline int coligny_row(int month_index)
+{
+    return ((unsigned)month_index < 12) ? month_index : COLIGNY_QUIMONIOS_ROW;
+}
+
+/* Attribute byte of a day; days outside 0-31 have none */
+static inline unsigned char coligny_day(int month_index, int day_of_month)
+{
+    if ((unsigned)day_of_month >= COLIGNY_DAY_STRIDE) return 0;
+    return coligny_day_attr[coligny_row(month_index)][day_of_month];
+}
+
+#endif
@@ -0,0 +1,280 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "ephemeris.h"
+#include "astronomy.h"
+#include "calendar.h"
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════════
+ * MAPPED TABLE
+ * One read-only mapping per process. The section pointers are set once by
+ * ephemeris_open() and only read afterwards, so lookups need no locking.
+ * Lookups only answer while the file's tier is the running one, so a file
+ * baked with another tier falls back to computation instead of silently
+ * swapping precision.
+ * ═══════════════════════════════════════════════════════════════════════════
+ */
+static void *map_base = NULL;
+static size_t map_size = 0;
+static const EphemerisHeader *map_header = NULL;
+static const EphemerisDay *map_days = NULL;
+static const EphemerisYear *map_years = NULL;
+static const int32_t *map_lunations = NULL;
+
+/* A section of count records of size bytes must lie inside the file, 8-byte aligned */
+static int section_valid(const EphemerisHeader *h, uint64_t offset, uint64_t count, uint64_t size)
+{
+    if (offset % 8 != 0 || offset < sizeof(EphemerisHeader) || offset > h->file_size) return 0;
+    return count <= (h->file_size - offset) / size;
+}
+
+static int header_valid(const EphemerisHeader *h, size_t file_size)
+{
+    return memcmp(h->magic, EPHEMERIS_MAGIC, sizeof(EPHEMERIS_MAGIC)) == 0 &&
+           h->version == EPHEMERIS_VERSION &&
+           h->header_size == sizeof(EphemerisHeader) &&
+           h->byte_order == EPHEMERIS_BYTE_ORDER &&
+           h->file_size == file_size &&
+           h->tier < PRECISION_TIERS &&
+           section_valid(h, h->day_offset, h->day_count, sizeof(EphemerisDay)) &&
+           section_valid(h, h->year_offset, h->year_count, sizeof(EphemerisYear)) &&
+           section_valid(h, h->lunation_offset, h->lunation_count, sizeof(int32_t));
+}
+
+int ephemeris_open(const char *path)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+    if (st.st_size < (off_t)sizeof(EphemerisHeader)) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void *base = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return -1;
+
+    const EphemerisHeader *h = base;
+    if (!header_valid(h, size)) {
+        munmap(base, size);
+        errno = EINVAL;
+        return -1;
+    }
+
+    ephemeris_close();
+    map_base = base;
+    map_size = size;
+    map_days = (const EphemerisDay *)((const char *)base + h->day_offset);
+    map_years = (const EphemerisYear *)((const char *)base + h->year_offset);
+    map_lunations = (const int32_t *)((const char *)base + h->lunation_offset);
+    map_header = h;
+    return 0;
+}
+
+void ephemeris_close(void)
+{
+    if (!map_base) return;
+    map_header = NULL;
+    munmap(map_base, map_size);
+    map_base = NULL;
+    map_size = 0;
+}
+
+/* The header when a file is loaded and matches astronomy_tier(), else NULL */
+static const EphemerisHeader *live_header(void)
+{
+    const EphemerisHeader *h = map_header;
+    return (h && h->tier == (uint32_t)astronomy_tier()) ? h : NULL;
+}
+
+const EphemerisDay *ephemeris_day(long jd)
+{
+    const EphemerisHeader *h = live_header();
+    if (!h) return NULL;
+    uint64_t i = (uint64_t)((int64_t)jd - h->jd_first);
+    return (i < h->day_count) ? &map_days[i] : NULL;
+}
+
+const EphemerisYear *ephemeris_year(int samhain_year)
+{
+    const EphemerisHeader *h = live_header();
+    if (!h) return NULL;
+    uint64_t i = (uint64_t)((int64_t)samhain_year - h->year_first);
+    return (i < h->year_count) ? &map_years[i] : NULL;
+}
+
+int ephemeris_full_moon(long lunation, long *jd)
+{
+    const EphemerisHeader *h = live_header();
+    if (!h) return 0;
+    uint64_t i = (uint64_t)((int64_t)lunation - h->lunation_first);
+    if (i >= h->lunation_count) return 0;
+    *jd = map_lunations[i];
+    return 1;
+}
+
+int ephemeris_tier(void)
+{
+    const EphemerisHeader *h = map_header;
+    return h ? (int)h->tier : -1;
+}
+
+double ephemeris_day_sun_longitude(const EphemerisDay *day)
+{
+    return day->sun_longitude * (360.0 / 65536.0);
+}
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════════
+ * GENERATION
+ * ═══════════════════════════════════════════════════════════════════════════
+ */
+#define WRITE_CHUNK_DAYS 4096
+
+static int write_days(FILE *f, long jd_first, uint32_t count)
+{
+    int phase[WRITE_CHUNK_DAYS], moonsign[WRITE_CHUNK_DAYS];
+    double sunlong[WRITE_CHUNK_DAYS];
+    EphemerisDay rec[WRITE_CHUNK_DAYS];
+
+    for (uint32_t base = 0; base < count; base += WRITE_CHUNK_DAYS) {
+        int n = (int)((count - base < WRITE_CHUNK_DAYS) ? count - base : WRITE_CHUNK_DAYS);
+        long jd = jd_first + (long)base;
+        ephemeris_span(jd, n, phase, sunlong, moonsign);
+        for (int i = 0; i < n; i++) {
+            long q = lround(sunlong[i] * (65536.0 / 360.0));
+            rec[i].sun_longitude = (uint16_t)(q & 0xFFFF);
+            rec[i].moon = (uint8_t)(phase[i] | (moonsign[i] << 4));
+            rec[i].sun_sign = (uint8_t)sun_sign(jd + i);
+        }
+        if (fwrite(rec, sizeof(EphemerisDay), (size_t)n, f) != (size_t)n) return -1;
+    }
+    return 0;
+}
+
+static int write_years(FILE *f, int first_year, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        const EventYear *ey = event_year(first_year + (int)i);
+        EphemerisYear rec;
+        memset(&rec, 0, sizeof(rec));
+        rec.samhain_year = ey->samhain_year;
+        /* Same crossing the Samhain cache rounds to its year-start day */
+        rec.samhain_day = lround(ey->solar[0]);
+        rec.samonios = ey->samonios;
+        for (int q = 0; q < 4; q++) {
+            rec.solilunar[q] = ey->solilunar[q];
+            rec.cross_window[q][0] = ey->cross_window[q][0];
+            rec.cross_window[q][1] = ey->cross_window[q][1];
+        }
+        memcpy(rec.solar, ey->solar, sizeof(rec.solar));
+        rec.next_samhain = ey->next_samhain;
+        rec.pleiades_rising = ey->pleiades_rising;
+        if (fwrite(&rec, sizeof(rec), 1, f) != 1) return -1;
+    }
+    return 0;
+}
+
+static int write_lunations(FILE *f, long first, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        int32_t jd = (int32_t)jd_of_full_moon(first + (long)i);
+        if (fwrite(&jd, sizeof(jd), 1, f) != 1) return -1;
+    }
+    return 0;
+}
+
+static uint64_t align8(uint64_t n)
+{
+    return (n + 7) & ~(uint64_t)7;
+}
+
+static int write_padding(FILE *f, uint64_t from, uint64_t to)
+{
+    static const char zeros[8];
+    return (to > from && fwrite(zeros, 1, (size_t)(to - from), f) != (size_t)(to - from)) ? -1 : 0;
+}
+
+int ephemeris_write(const char *path, int first_year, int last_year)
+{
+    if (last_year < first_year) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    long jd_first = jd_from_ymd(first_year, 1, 1);
+    long jd_last = jd_from_ymd(last_year + 1, 12, 31);
+    long lunation_first = lunation_number(jd_first);
+    long lunation_last = lunation_number(jd_last) + 1;
+
+    EphemerisHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, EPHEMERIS_MAGIC, sizeof(EPHEMERIS_MAGIC));
+    h.version = EPHEMERIS_VERSION;
+    h.header_size = sizeof(EphemerisHeader);
+    h.byte_order = EPHEMERIS_BYTE_ORDER;
+    h.jd_first = jd_first;
+    h.day_count = (uint32_t)(jd_last - jd_first + 1);
+    h.year_first = first_year;
+    h.year_count = (uint32_t)(last_year - first_year + 1);
+    h.lunation_first = lunation_first;
+    h.lunation_count = (uint32_t)(lunation_last - lunation_first + 1);
+    h.tier = (uint32_t)astronomy_tier();
+    h.day_offset = align8(sizeof(EphemerisHeader));
+    h.year_offset = align8(h.day_offset + (uint64_t)h.day_count * sizeof(EphemerisDay));
+    h.lunation_offset = align8(h.year_offset + (uint64_t)h.year_count * sizeof(EphemerisYear));
+    h.file_size = h.lunation_offset + (uint64_t)h.lunation_count * sizeof(int32_t);
+
+    size_t tmp_len = strlen(path) + 8;
+    char *tmp = malloc(tmp_len);
+    if (!tmp) return -1;
+    snprintf(tmp, tmp_len, "%s.XXXXXX", path);
+    int fd = mkstemp(tmp);
+    FILE *f = (fd >= 0) ? fdopen(fd, "wb") : NULL;
+    if (!f) {
+        if (fd >= 0) {
+            close(fd);
+            unlink(tmp);
+        }
+        free(tmp);
+        return -1;
+    }
+    fchmod(fd, 0644);   /* Shared by every process on the host */
+
+    int status = 0;
+    if (fwrite(&h, sizeof(h), 1, f) != 1 ||
+        write_padding(f, sizeof(h), h.day_offset) != 0 ||
+        write_days(f, jd_first, h.day_count) != 0 ||
+        write_padding(f, h.day_offset + (uint64_t)h.day_count * sizeof(EphemerisDay), h.year_offset) != 0 ||
+        write_years(f, first_year, h.year_count) != 0 ||
+        write_padding(f, h.year_offset + (uint64_t)h.year_count * sizeof(EphemerisYear), h.lunation_offset) != 0 ||
+        write_lunations(f, lunation_first, h.lunation_count) != 0) {
+        status = -1;
+    }
+    if (fclose(f) != 0) status = -1;
+
+    if (status == 0 && rename(tmp, path) != 0) status = -1;
+    if (status != 0) {
+        int saved = errno;
+        unlink(tmp);
+        errno = saved;
+    }
+    free(tmp);
+    return status;
+}
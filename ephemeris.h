@@ -0,0 +1,91 @@
+#ifndef EPHEMERIS_H
+#define EPHEMERIS_H
+
+#include <stdint.h>
+
+/*
+ * Precomputed ephemeris file
+ *
+ * A generated binary table (see gen_ephemeris.c) that is mapped read-only
+ * and queried in place: per-day records, per-Samhain-year event records
+ * and full-moon days for one contiguous span. Every process mapping the
+ * same file shares its page-cache pages. Lookups outside the span return
+ * "not found" and the callers in astronomy.c / calendar.c compute instead.
+ *
+ * Layout: EphemerisHeader, then the day, year and lunation arrays at the
+ * offsets the header gives (8-byte aligned). Fields are native-endian; the
+ * byte_order marker rejects files written on the other endianness.
+ */
+#define EPHEMERIS_MAGIC "CELTEPH"
+#define EPHEMERIS_VERSION 1
+#define EPHEMERIS_BYTE_ORDER 0x01020304u
+
+typedef struct {
+    char magic[8];            /* EPHEMERIS_MAGIC, NUL-padded */
+    uint32_t version;
+    uint32_t header_size;     /* sizeof(EphemerisHeader) */
+    uint32_t byte_order;      /* EPHEMERIS_BYTE_ORDER as written */
+    uint32_t day_count;
+    int64_t jd_first;         /* JD of day record 0 */
+    int32_t year_first;       /* Samhain year of year record 0 */
+    uint32_t year_count;
+    int64_t lunation_first;   /* Lunation number of full-moon record 0 */
+    uint32_t lunation_count;
+    uint32_t tier;            /* PrecisionTier the records were computed with (0 = fast) */
+    uint64_t day_offset;      /* Byte offsets from the start of the file */
+    uint64_t year_offset;
+    uint64_t lunation_offset;
+    uint64_t file_size;
+} EphemerisHeader;
+
+typedef struct {
+    uint16_t sun_longitude;   /* Degrees * 65536 / 360, rounded */
+    uint8_t moon;             /* moon_phase() in bits 0-2, moon_sign() in bits 4-7 */
+    uint8_t sun_sign;         /* sun_sign() */
+} EphemerisDay;
+
+typedef struct {
+    int32_t samhain_year;
+    int32_t reserved;
+    int64_t samhain_day;      /* Whole day nearest the 225° crossing (Celtic year start) */
+    int64_t samonios;         /* find_samonios_start() */
+    int64_t solilunar[4];
+    double solar[8];          /* Same slots as EventYear */
+    double next_samhain;
+    double cross_window[4][2];
+    double pleiades_rising;
+} EphemerisYear;
+
+/*
+ * Map a file and make it the process-wide table (replacing any previous
+ * one). Call before starting threads that use the calendar. Returns 0, or
+ * -1 with errno set (EINVAL for a malformed or foreign file).
+ */
+int ephemeris_open(const char *path);
+void ephemeris_close(void);  /* Unmap; no other thread may be inside a lookup */
+
+/*
+ * Lookups; NULL / 0 outside the loaded span, with no file loaded, or while
+ * the file's tier differs from astronomy_tier() (the callers then compute
+ * at the running tier)
+ */
+const EphemerisDay *ephemeris_day(long jd);
+const EphemerisYear *ephemeris_year(int samhain_year);
+int ephemeris_full_moon(long lunation, long *jd);
+
+/* PrecisionTier of the loaded file, -1 with no file loaded */
+int ephemeris_tier(void);
+
+/* Quantized longitude of a day record, in degrees */
+double ephemeris_day_sun_longitude(const EphemerisDay *day);
+
+/*
+ * Generate a file for Samhain years first_year..last_year (days from 1 Jan
+ * of first_year to 31 Dec of last_year + 1) with the current precision
+ * tier (astronomy_set_tier()), recorded in the header. Writes a temporary file and
+ * renames it over path, so processes mapping the old file keep a valid
+ * view. Returns 0, or -1 with errno set.
+ */
+int ephemeris_write(const char *path, int first_year, int last_year);
+
+#endif
@@ -0,0 +1,537 @@
+#define _XOPEN_SOURCE 700
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "export.h"
+#include "calendar.h"
+#include "astronomy.h"
+#include "festivals.h"
+#include "cursor.h"
+
+#define EXPORT_BLOCK_DAYS 512          /* Days of moon phases per span call */
+#define EXPORT_BUFFER_SIZE (1 << 16)   /* Output is written in chunks of this size */
+#define EXPORT_RECORD_MAX 1024         /* Upper bound on one formatted record */
+#define ICS_LINE_OCTETS 75             /* RFC 5545 content line limit */
+
+static const char *eightfold_names[8] = {
+    "Yule", "Imbolc", "Ostara", "Beltane",
+    "Litha", "Lughnasadh", "Mabon", "Samhain"
+};
+
+/* Everything exported for one civil day */
+typedef struct {
+    long jd;
+    int year, month, day;       /* Gregorian */
+    int celtic_year;
+    int lunar_month;            /* lunar_celtic_month_index(), -1 = Quimonios */
+    int lunar_day;
+    int is_mat;
+    int is_d_amb;
+    const char *festival;       /* NULL if none */
+    const char *solar_event;    /* Eight-fold event falling on this day, NULL if none */
+    int moon_phase;
+    char sunset[16];
+} DayRecord;
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * OUTPUT BUFFER
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+/*
+ * Records go either to a FILE, flushed whenever the fixed buffer fills, or
+ * (out == NULL) into memory that grows as needed, so worker threads can
+ * format whole chunks for the writer to emit in order.
+ */
+typedef struct {
+    FILE *out;
+    char *data;
+    size_t len;
+    size_t cap;
+    int error;
+} ExportBuffer;
+
+static int buffer_open(ExportBuffer *b, FILE *out)
+{
+    b->out = out;
+    b->len = 0;
+    b->cap = EXPORT_BUFFER_SIZE;
+    b->error = 0;
+    b->data = malloc(b->cap);
+    return b->data ? 0 : -1;
+}
+
+static void buffer_close(ExportBuffer *b)
+{
+    free(b->data);
+    b->data = NULL;
+    b->len = b->cap = 0;
+}
+
+static void buffer_flush(ExportBuffer *b)
+{
+    if (!b->out) return;
+    if (b->len && !b->error && fwrite(b->data, 1, b->len, b->out) != b->len) {
+        b->error = 1;
+    }
+    b->len = 0;
+}
+
+/* Make room for n more bytes; 0 if the buffer cannot take them */
+static int buffer_reserve(ExportBuffer *b, size_t n)
+{
+    if (b->len + n <= b->cap) return 1;
+    if (b->out) {
+        buffer_flush(b);
+        return b->len + n <= b->cap;
+    }
+
+    size_t cap = b->cap;
+    while (cap < b->len + n) cap *= 2;
+    char *data = realloc(b->data, cap);
+    if (!data) {
+        b->error = 1;
+        return 0;
+    }
+    b->data = data;
+    b->cap = cap;
+    return 1;
+}
+
+static void buffer_write(ExportBuffer *b, const char *text, size_t n)
+{
+    if (b->error) return;
+    if (!buffer_reserve(b, n)) {
+        /* Larger than the file buffer: write it through */
+        if (b->out && !b->error && fwrite(text, 1, n, b->out) != n) b->error = 1;
+        return;
+    }
+    memcpy(b->data + b->len, text, n);
+    b->len += n;
+}
+
+static void buffer_puts(ExportBuffer *b, const char *text)
+{
+    buffer_write(b, text, strlen(text));
+}
+
+static void buffer_printf(ExportBuffer *b, const char *fmt, ...)
+{
+    char record[EXPORT_RECORD_MAX];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(record, sizeof(record), fmt, ap);
+    va_end(ap);
+    if (n < 0) return;
+    if ((size_t)n >= sizeof(record)) n = (int)sizeof(record) - 1;
+    buffer_write(b, record, (size_t)n);
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * FIELD FORMATTING
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+/* ISO 8601 date; years before 1 CE use the expanded "-YYYY" form */
+static void format_date(char *buf, size_t size, int year, int month, int day, const char *sep)
+{
+    snprintf(buf, size, "%s%04d%s%02d%s%02d", year < 0 ? "-" : "", year < 0 ? -year : year,
+             sep, month, sep, day);
+}
+
+static void csv_field(ExportBuffer *b, const char *text)
+{
+    if (!text) return;
+    if (!strpbrk(text, ",\"\r\n")) {
+        buffer_puts(b, text);
+        return;
+    }
+    buffer_write(b, "\"", 1);
+    for (const char *p = text; *p; p++) {
+        if (*p == '"') buffer_write(b, "\"", 1);
+        buffer_write(b, p, 1);
+    }
+    buffer_write(b, "\"", 1);
+}
+
+static void json_string(ExportBuffer *b, const char *text)
+{
+    if (!text) {
+        buffer_puts(b, "null");
+        return;
+    }
+    buffer_write(b, "\"", 1);
+    for (const unsigned char *p = (const unsigned char *)text; *p; p++) {
+        if (*p == '"' || *p == '\\') {
+            char esc[2] = {'\\', (char)*p};
+            buffer_write(b, esc, 2);
+        } else if (*p < 0x20) {
+            char esc[8];
+            snprintf(esc, sizeof(esc), "\\u%04x", *p);
+            buffer_puts(b, esc);
+        } else {
+            buffer_write(b, (const char *)p, 1);
+        }
+    }
+    buffer_write(b, "\"", 1);
+}
+
+/* Append iCalendar TEXT, escaping \ ; , and newlines */
+static size_t ics_escape(char *dst, size_t size, size_t len, const char *text)
+{
+    for (const char *p = text; *p && len + 2 < size; p++) {
+        if (*p == '\\' || *p == ';' || *p == ',') {
+            dst[len++] = '\\';
+            dst[len++] = *p;
+        } else if (*p == '\n') {
+            dst[len++] = '\\';
+            dst[len++] = 'n';
+        } else if (*p != '\r') {
+            dst[len++] = *p;
+        }
+    }
+    dst[len] = '\0';
+    return len;
+}
+
+/* Write one content line, folded at 75 octets without splitting UTF-8 sequences */
+static void ics_line(ExportBuffer *b, const char *line)
+{
+    size_t n = strlen(line);
+    size_t limit = ICS_LINE_OCTETS;
+    while (n > limit) {
+        size_t cut = limit;
+        while (cut > 0 && ((unsigned char)line[cut] & 0xC0) == 0x80) cut--;
+        buffer_write(b, line, cut);
+        buffer_write(b, "\r\n ", 3);
+        line += cut;
+        n -= cut;
+        limit = ICS_LINE_OCTETS - 1;   /* Continuation lines start with a space */
+    }
+    buffer_write(b, line, n);
+    buffer_write(b, "\r\n", 2);
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * RECORDS
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static const char *festival_name(const FestivalIndexEntry *entry)
+{
+    if (entry->multi >= 0) return multi_festival_by_id(entry->multi)->name;
+    if (entry->fixed >= 0) return festivals[entry->fixed].name;
+    return NULL;
+}
+
+static void write_csv_header(ExportBuffer *b)
+{
+    buffer_puts(b, "date,jd,celtic_year,month_index,month,day,mat,d_amb,festival,solar_event,moon_phase,sunset\n");
+}
+
+static void write_csv(ExportBuffer *b, const DayRecord *r)
+{
+    char date[24];
+    format_date(date, sizeof(date), r->year, r->month, r->day, "-");
+    buffer_printf(b, "%s,%ld,%d,%d,%s,%d,%s,%d,", date, r->jd, r->celtic_year, r->lunar_month,
+                  get_celtic_month_name(r->lunar_month), r->lunar_day, r->is_mat ? "MAT" : "ANM", r->is_d_amb);
+    csv_field(b, r->festival);
+    buffer_write(b, ",", 1);
+    csv_field(b, r->solar_event);
+    buffer_printf(b, ",%d,%s\n", r->moon_phase, r->sunset);
+}
+
+static void write_jsonl(ExportBuffer *b, const DayRecord *r)
+{
+    char date[24];
+    format_date(date, sizeof(date), r->year, r->month, r->day, "-");
+    buffer_printf(b, "{\"date\":\"%s\",\"jd\":%ld,\"celtic_year\":%d,\"month_index\":%d,\"month\":\"%s\","
+                     "\"day\":%d,\"mat\":%s,\"d_amb\":%s,\"festival\":",
+                  date, r->jd, r->celtic_year, r->lunar_month, get_celtic_month_name(r->lunar_month),
+                  r->lunar_day, r->is_mat ? "true" : "false", r->is_d_amb ? "true" : "false");
+    json_string(b, r->festival);
+    buffer_puts(b, ",\"solar_event\":");
+    json_string(b, r->solar_event);
+    buffer_printf(b, ",\"moon_phase\":%d,\"sunset\":\"%s\"}\n", r->moon_phase, r->sunset);
+}
+
+static void write_ics_header(ExportBuffer *b)
+{
+    ics_line(b, "BEGIN:VCALENDAR");
+    ics_line(b, "VERSION:2.0");
+    ics_line(b, "PRODID:-//CelticCalendar//Coligny range export//EN");
+    ics_line(b, "CALSCALE:GREGORIAN");
+}
+
+static void write_ics(ExportBuffer *b, const DayRecord *r, const char *dtstamp)
+{
+    char date[24], next[24], line[EXPORT_RECORD_MAX];
+    int ny, nm, nd;
+    format_date(date, sizeof(date), r->year, r->month, r->day, "");
+    ymd_from_jd(r->jd + 1, &ny, &nm, &nd);
+    format_date(next, sizeof(next), ny, nm, nd, "");
+
+    ics_line(b, "BEGIN:VEVENT");
+    snprintf(line, sizeof(line), "UID:%s-celtic@coligny", date);
+    ics_line(b, line);
+    snprintf(line, sizeof(line), "DTSTAMP:%s", dtstamp);
+    ics_line(b, line);
+    snprintf(line, sizeof(line), "DTSTART;VALUE=DATE:%s", date);
+    ics_line(b, line);
+    snprintf(line, sizeof(line), "DTEND;VALUE=DATE:%s", next);
+    ics_line(b, line);
+
+    size_t len = (size_t)snprintf(line, sizeof(line), "SUMMARY:%s %d (%s)",
+                                  get_celtic_month_name(r->lunar_month), r->lunar_day, r->is_mat ? "MAT" : "ANM");
+    if (r->festival) {
+        len = ics_escape(line, sizeof(line), len, " - ");
+        len = ics_escape(line, sizeof(line), len, r->festival);
+    }
+    if (r->solar_event) {
+        len = ics_escape(line, sizeof(line), len, " - ");
+        ics_escape(line, sizeof(line), len, r->solar_event);
+    }
+    ics_line(b, line);
+
+    snprintf(line, sizeof(line), "DESCRIPTION:Celtic year %d\\, moon phase %d\\, sunset %s%s",
+             r->celtic_year, r->moon_phase, r->sunset, r->is_d_amb ? "\\, D AMB" : "");
+    ics_line(b, line);
+    ics_line(b, "END:VEVENT");
+}
+
+int export_format_from_name(const char *name)
+{
+    if (strcmp(name, "csv") == 0) return EXPORT_CSV;
+    if (strcmp(name, "jsonl") == 0) return EXPORT_JSONL;
+    if (strcmp(name, "ics") == 0) return EXPORT_ICS;
+    return -1;
+}
+
+/* Format every day of [jd_first, jd_last] into b */
+static void export_days(ExportBuffer *b, long jd_first, long jd_last, ExportFormat format,
+                        const CelticLocation *site, const char *dtstamp)
+{
+    int phases[EXPORT_BLOCK_DAYS];
+    CelticCursor cur;
+    cursor_init(&cur, jd_first);
+
+    for (long start = jd_first; start <= jd_last && !b->error; start += EXPORT_BLOCK_DAYS) {
+        int n = (int)((jd_last - start + 1 < EXPORT_BLOCK_DAYS) ? jd_last - start + 1 : EXPORT_BLOCK_DAYS);
+        ephemeris_span(start, n, phases, NULL, NULL);
+
+        for (int i = 0; i < n; i++, cursor_next(&cur)) {
+            DayRecord r;
+            r.jd = cur.jd;
+            ymd_from_jd(r.jd, &r.year, &r.month, &r.day);
+            r.celtic_year = cur.date.year;
+            r.lunar_month = cur.lunar_month;
+            r.lunar_day = cur.lunar_day;
+            r.is_mat = (cur.lunar_month_length == 30);
+            r.is_d_amb = is_d_amb(r.lunar_day);
+            r.festival = festival_name(cur.festival);
+            FestivalOccurrence occ;
+            if (!r.festival && festival_rule_at(r.jd, &occ)) r.festival = occ.name;
+            r.solar_event = (cur.event_days == 0) ? eightfold_names[cur.event] : NULL;
+
+            r.moon_phase = phases[i];
+            location_sunset_str(site, r.jd, r.sunset, sizeof(r.sunset));
+
+            switch (format) {
+                case EXPORT_CSV:   write_csv(b, &r); break;
+                case EXPORT_JSONL: write_jsonl(b, &r); break;
+                case EXPORT_ICS:   write_ics(b, &r, dtstamp); break;
+            }
+        }
+    }
+}
+
+static void export_header(ExportBuffer *b, ExportFormat format, char *dtstamp, size_t size)
+{
+    dtstamp[0] = '\0';
+    if (format == EXPORT_ICS) {
+        time_t now = time(NULL);
+        struct tm utc;
+        gmtime_r(&now, &utc);
+        strftime(dtstamp, size, "%Y%m%dT%H%M%SZ", &utc);
+        write_ics_header(b);
+    } else if (format == EXPORT_CSV) {
+        write_csv_header(b);
+    }
+}
+
+/* Write the trailer and release the buffer; returns the export status */
+static int export_finish(ExportBuffer *b, ExportFormat format)
+{
+    if (format == EXPORT_ICS) ics_line(b, "END:VCALENDAR");
+    buffer_flush(b);
+    if (fflush(b->out) != 0) b->error = 1;
+    int status = b->error ? -1 : 0;
+    buffer_close(b);
+    return status;
+}
+
+int export_range(FILE *out, long jd_first, long jd_last, ExportFormat format, const CelticLocation *site)
+{
+    ExportBuffer b;
+    char dtstamp[32];
+    if (buffer_open(&b, out) != 0) return -1;
+
+    export_header(&b, format, dtstamp, sizeof(dtstamp));
+    export_days(&b, jd_first, jd_last, format, site, dtstamp);
+    return export_finish(&b, format);
+}
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════════
+ * PARALLEL EXPORT
+ * The range is cut at Samhain into one chunk per Celtic year. Workers claim
+ * chunks in order and format them into memory, each warming its own
+ * thread-local Samhain, lunation and event-year caches for the years it
+ * owns. The calling thread is the writer: it emits chunks strictly in
+ * sequence and frees them, and workers stay at most a window of chunks
+ * ahead of it so memory stays bounded.
+ * ═══════════════════════════════════════════════════════════════════════════
+ */
+#define EXPORT_WINDOW_PER_THREAD 4
+
+typedef struct {
+    long jd_first;
+    long jd_last;
+    ExportBuffer buffer;
+    int done;
+} ExportChunk;
+
+typedef struct {
+    ExportChunk *chunks;
+    int chunk_count;
+    int next_chunk;        /* Next chunk to be claimed by a worker */
+    int written;           /* Chunks already written by the writer */
+    int window;
+    int abort;
+    ExportFormat format;
+    const CelticLocation *site;
+    const char *dtstamp;
+    pthread_mutex_t lock;
+    pthread_cond_t chunk_done;
+    pthread_cond_t window_open;
+} ExportJob;
+
+static void *export_worker(void *arg)
+{
+    ExportJob *job = arg;
+
+    for (;;) {
+        pthread_mutex_lock(&job->lock);
+        while (!job->abort && job->next_chunk < job->chunk_count &&
+               job->next_chunk >= job->written + job->window) {
+            pthread_cond_wait(&job->window_open, &job->lock);
+        }
+        if (job->abort || job->next_chunk >= job->chunk_count) {
+            pthread_mutex_unlock(&job->lock);
+            return NULL;
+        }
+        ExportChunk *chunk = &job->chunks[job->next_chunk++];
+        pthread_mutex_unlock(&job->lock);
+
+        if (buffer_open(&chunk->buffer, NULL) == 0) {
+            export_days(&chunk->buffer, chunk->jd_first, chunk->jd_last, job->format, job->site, job->dtstamp);
+        } else {
+            chunk->buffer.error = 1;
+        }
+
+        pthread_mutex_lock(&job->lock);
+        chunk->done = 1;
+        pthread_cond_broadcast(&job->chunk_done);
+        pthread_mutex_unlock(&job->lock);
+    }
+}
+
+/* Split [jd_first, jd_last] at each Samhain; returns the chunk count or -1 */
+static int export_plan_chunks(long jd_first, long jd_last, ExportChunk **out)
+{
+    int first_year = celtic_year_from_jd(jd_first);
+    int last_year = celtic_year_from_jd(jd_last);
+    int count = last_year - first_year + 1;
+
+    ExportChunk *chunks = calloc((size_t)count, sizeof(ExportChunk));
+    if (!chunks) return -1;
+
+    long start = jd_first;
+    for (int i = 0; i < count; i++) {
+        long next_year = (i + 1 < count) ? jd_start_of_celtic_year(first_year + i + 1) : jd_last + 1;
+        chunks[i].jd_first = start;
+        chunks[i].jd_last = next_year - 1;
+        start = next_year;
+    }
+    *out = chunks;
+    return count;
+}
+
+int export_range_parallel(FILE *out, long jd_first, long jd_last, ExportFormat format,
+                          const CelticLocation *site, int threads)
+{
+    if (threads <= 1) return export_range(out, jd_first, jd_last, format, site);
+
+    ExportJob job = {0};
+    job.chunk_count = export_plan_chunks(jd_first, jd_last, &job.chunks);
+    if (job.chunk_count < 0) return -1;
+    if (threads > job.chunk_count) threads = job.chunk_count;
+
+    ExportBuffer b;
+    char dtstamp[32];
+    if (buffer_open(&b, out) != 0) {
+        free(job.chunks);
+        return -1;
+    }
+    export_header(&b, format, dtstamp, sizeof(dtstamp));
+
+    job.window = threads * EXPORT_WINDOW_PER_THREAD;
+    job.format = format;
+    job.site = site;
+    job.dtstamp = dtstamp;
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_cond_init(&job.chunk_done, NULL);
+    pthread_cond_init(&job.window_open, NULL);
+
+    pthread_t *workers = malloc(sizeof(pthread_t) * (size_t)threads);
+    int started = 0;
+    if (workers) {
+        while (started < threads && pthread_create(&workers[started], NULL, export_worker, &job) == 0) {
+            started++;
+        }
+    }
+
+    if (started == 0) {
+        /* No workers: format everything on this thread */
+        export_days(&b, jd_first, jd_last, format, site, dtstamp);
+    } else {
+        for (int i = 0; i < job.chunk_count; i++) {
+            ExportChunk *chunk = &job.chunks[i];
+
+            pthread_mutex_lock(&job.lock);
+            while (!chunk->done) pthread_cond_wait(&job.chunk_done, &job.lock);
+            pthread_mutex_unlock(&job.lock);
+
+            if (chunk->buffer.error) b.error = 1;
+            buffer_write(&b, chunk->buffer.data, chunk->buffer.len);
+            buffer_close(&chunk->buffer);
+
+            pthread_mutex_lock(&job.lock);
+            job.written = i + 1;
+            if (b.error) job.abort = 1;
+            pthread_cond_broadcast(&job.window_open);
+            pthread_mutex_unlock(&job.lock);
+            if (b.error) break;
+        }
+    }
+
+    for (int i = 0; i < started; i++) pthread_join(workers[i], NULL);
+    for (int i = 0; i < job.chunk_count; i++) buffer_close(&job.chunks[i].buffer);
+    free(workers);
+    free(job.chunks);
+    pthread_mutex_destroy(&job.lock);
+    pthread_cond_destroy(&job.chunk_done);
+    pthread_cond_destroy(&job.window_open);
+
+    return export_finish(&b, format);
+}
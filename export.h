@@ -0,0 +1,36 @@
+#ifndef EXPORT_H
+#define EXPORT_H
+
+#include <stdio.h>
+#include "location.h"
+
+/*
+ * Streaming range export: one compact record per civil day (noon JD),
+ * without any box drawing. Records are formatted into a large buffer and
+ * written in chunks.
+ *
+ * Fields: Gregorian date, JD, Celtic year, lunar month (index and name),
+ * lunar day, MAT/ANM, D AMB, festival, solar event on the day, moon phase
+ * (0-7) and sunset at the given site.
+ */
+typedef enum {
+    EXPORT_CSV,
+    EXPORT_JSONL,
+    EXPORT_ICS
+} ExportFormat;
+
+/* Parse "csv", "jsonl" or "ics"; returns -1 if unknown */
+int export_format_from_name(const char *name);
+
+/* Write every day in [jd_first, jd_last]; returns 0, or -1 on a write error */
+int export_range(FILE *out, long jd_first, long jd_last, ExportFormat format, const CelticLocation *site);
+
+/*
+ * Same output, generated by up to 'threads' workers (one Celtic year per
+ * chunk) and written in order by the calling thread. Festivals must not be
+ * registered while it runs.
+ */
+int export_range_parallel(FILE *out, long jd_first, long jd_last, ExportFormat format,
+                          const CelticLocation *site, int threads);
+
+#endif
@@ -1,4 +1,14 @@
 #include "festivals.h"
+#include "calendar.h"
+#include "astronomy.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
 
 /*
  * Celtic Calendar Festivals for Year 5289 (Nov 2025 - Oct 2026)
@@ -62,16 +72,103 @@ const MultiFestival multi_festivals[] = {
 
 const int MULTI_FESTIVAL_COUNT = sizeof(multi_festivals)/sizeof(multi_festivals[0]);
 
+/* Astronomical definitions of a festival file, evaluated per Samhain year */
+typedef enum {
+    RULE_SUN,                 /* Day nearest the Sun's crossing of longitude */
+    RULE_FULL_MOON_AFTER_SUN, /* First full moon after that day */
+    RULE_FULL_MOON_AFTER_DAY  /* First full moon after lunar month/day */
+} FestivalRuleKind;
+
+typedef struct {
+    const char *name;
+    const char *coligny_name;
+    FestivalRuleKind kind;
+    double longitude;
+    int month, day;           /* RULE_FULL_MOON_AFTER_DAY anchor */
+    int before, after;        /* Days marked before and after the anchor day */
+} FestivalRule;
+
+#define FESTIVAL_LINE_MAX 512
+
 /*
- * Check if a given day falls within a multi-day festival
- * Returns: festival index (0-7) or -1 if not a festival day
+ * Festivals added at runtime (register_festival(), festivals_load()) and
+ * the lookup index built over them, published together as one immutable
+ * snapshot. Lookups load the current snapshot and never lock; writers build
+ * the successor under festival_lock and swap it in (read-copy-update).
+ *
+ * A replaced snapshot is retired, not freed: a thread may still hold an
+ * entry or festival pointer from it. Each thread that reads records the
+ * oldest generation it may hold until it calls festivals_quiescent(), and
+ * a retired snapshot is freed once no thread holds one that old.
  */
-int get_multi_festival(int month, int day)
+typedef struct FestivalSet {
+    int registered_count;
+    const MultiFestival *registered;
+    int loaded_count;                 /* fixed entries of the festival file */
+    const MultiFestival *loaded;
+    int rule_count;                   /* Its astronomical entries */
+    const FestivalRule *rules;
+    unsigned generation;              /* Tags per-year rule tables */
+    FestivalIndexEntry index[13][FESTIVAL_INDEX_DAYS];
+    /* Once retired, under festival_lock */
+    unsigned replaced_by;             /* Generation of its successor */
+    unsigned owns;                    /* FESTIVAL_OWNS_* arrays no successor shares */
+    struct FestivalSet *retired_next;
+} FestivalSet;
+
+#define FESTIVAL_OWNS_REGISTERED 0x01
+#define FESTIVAL_OWNS_LOADED     0x02
+#define FESTIVAL_OWNS_RULES      0x04
+
+/* A thread that has read a snapshot; since is 0 while it holds none */
+typedef struct FestivalReader {
+    unsigned since;                   /* 1 + oldest generation it may hold */
+    struct FestivalReader *next;      /* festival_readers, under festival_lock */
+} FestivalReader;
+
+static FestivalSet builtin_set;         /* No registrations; built once */
+static pthread_once_t builtin_set_once = PTHREAD_ONCE_INIT;
+static FestivalSet *festival_set = NULL;   /* NULL until the first registration */
+static pthread_mutex_t festival_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned festival_generation = 0;   /* Under festival_lock */
+static char *festival_path = NULL;         /* Last file loaded, under festival_lock */
+static unsigned festival_published = 0;    /* Generation of festival_set, read without the lock */
+static FestivalSet *festival_retired = NULL;   /* Replaced snapshots not yet freed */
+static int festival_retired_any = 0;       /* festival_retired != NULL, read without the lock */
+static FestivalReader *festival_readers = NULL;
+static int festival_reader_lost = 0;       /* A reader could not be recorded: free nothing */
+static pthread_key_t festival_reader_key;
+static pthread_once_t festival_reader_once = PTHREAD_ONCE_INIT;
+static _Thread_local FestivalReader *festival_reader = NULL;
+
+/* Index row for a month index; -1 (Quimonios) uses the extra row */
+static int festival_row(int month)
+{
+    if (month == -1) return 12;
+    if (month < 0 || month > 11) return -1;
+    return month;
+}
+
+/* Ids: built-in multi_festivals[], then registered, then the file's fixed entries */
+static const MultiFestival *set_festival_by_id(const FestivalSet *set, int id)
+{
+    if (id < 0) return NULL;
+    if (id < MULTI_FESTIVAL_COUNT) return &multi_festivals[id];
+    id -= MULTI_FESTIVAL_COUNT;
+    if (id < set->registered_count) return &set->registered[id];
+    id -= set->registered_count;
+    return (id < set->loaded_count) ? &set->loaded[id] : NULL;
+}
+
+/* Linear scan over every multi-day festival; used to build the index */
+static int scan_multi_festival(const FestivalSet *set, int month, int day)
 {
-    for (int i = 0; i < MULTI_FESTIVAL_COUNT; i++) {
-        if (month == multi_festivals[i].month) {
-            int start = multi_festivals[i].start_day;
-            int end = start + multi_festivals[i].duration - 1;
+    int total = MULTI_FESTIVAL_COUNT + set->registered_count + set->loaded_count;
+    for (int i = 0; i < total; i++) {
+        const MultiFestival *mf = set_festival_by_id(set, i);
+        if (month == mf->month) {
+            int start = mf->start_day;
+            int end = start + mf->duration - 1;
             if (day >= start && day <= end) {
                 return i;
             }
@@ -80,19 +177,622 @@ int get_multi_festival(int month, int day)
     return -1;
 }
 
+static void build_festival_index(FestivalSet *set)
+{
+    for (int row = 0; row < 13; row++) {
+        int month = (row == 12) ? -1 : row;
+        for (int day = 0; day < FESTIVAL_INDEX_DAYS; day++) {
+            FestivalIndexEntry *e = &set->index[row][day];
+            e->multi = -1;
+            e->fixed = -1;
+            e->day_number = 0;
+            e->flags = 0;
+
+            int id = scan_multi_festival(set, month, day);
+            if (id >= 0) {
+                e->multi = (short)id;
+                e->day_number = (unsigned char)(day - set_festival_by_id(set, id)->start_day + 1);
+                if (id >= MULTI_FESTIVAL_COUNT) e->flags |= FESTIVAL_FLAG_IVOS;
+            }
+        }
+    }
+    for (int f = 0; f < FESTIVAL_COUNT; f++) {
+        int row = festival_row(festivals[f].month);
+        int day = festivals[f].day;
+        if (row < 0 || day < 0 || day >= FESTIVAL_INDEX_DAYS) continue;
+        if (set->index[row][day].fixed < 0) set->index[row][day].fixed = (short)f;
+        set->index[row][day].flags |= FESTIVAL_FLAG_IVOS;
+    }
+}
+
+static void build_builtin_set(void)
+{
+    build_festival_index(&builtin_set);
+}
+
+/* Free the retired snapshots no reader can still hold; caller holds festival_lock */
+static void reclaim_festivals(void)
+{
+    if (__atomic_load_n(&festival_reader_lost, __ATOMIC_RELAXED)) return;
+    unsigned oldest = ~0u;
+    for (const FestivalReader *r = festival_readers; r; r = r->next) {
+        unsigned since = __atomic_load_n(&r->since, __ATOMIC_SEQ_CST);
+        if (since && since < oldest) oldest = since;
+    }
+
+    FestivalSet **link = &festival_retired;
+    while (*link) {
+        FestivalSet *old = *link;
+        /* A reader with since <= replaced_by may have loaded it */
+        if (old->replaced_by < oldest) {
+            *link = old->retired_next;
+            if (old->owns & FESTIVAL_OWNS_REGISTERED) free((void *)old->registered);
+            if (old->owns & FESTIVAL_OWNS_LOADED) {
+                for (int i = 0; i < old->loaded_count; i++) {
+                    free((char *)old->loaded[i].name);
+                    free((char *)old->loaded[i].coligny_name);
+                }
+                free((void *)old->loaded);
+            }
+            if (old->owns & FESTIVAL_OWNS_RULES) {
+                for (int i = 0; i < old->rule_count; i++) {
+                    free((char *)old->rules[i].name);
+                    free((char *)old->rules[i].coligny_name);
+                }
+                free((void *)old->rules);
+            }
+            free(old);
+        } else {
+            link = &old->retired_next;
+        }
+    }
+    __atomic_store_n(&festival_retired_any, festival_retired != NULL, __ATOMIC_RELAXED);
+}
+
+static void drop_festival_reader(void *p)
+{
+    FestivalReader *reader = p;
+    pthread_mutex_lock(&festival_lock);
+    for (FestivalReader **link = &festival_readers; *link; link = &(*link)->next) {
+        if (*link == reader) {
+            *link = reader->next;
+            break;
+        }
+    }
+    free(reader);
+    festival_reader = NULL;   /* Later destructors may read again */
+    reclaim_festivals();
+    pthread_mutex_unlock(&festival_lock);
+}
+
+static void create_festival_reader_key(void)
+{
+    if (pthread_key_create(&festival_reader_key, drop_festival_reader) != 0)
+        __atomic_store_n(&festival_reader_lost, 1, __ATOMIC_RELAXED);
+}
+
+/* First read since the thread was quiescent: record what it may hold from now on */
+static void begin_festival_read(void)
+{
+    if (!festival_reader) {
+        if (__atomic_load_n(&festival_reader_lost, __ATOMIC_RELAXED)) return;
+        pthread_once(&festival_reader_once, create_festival_reader_key);
+        FestivalReader *reader = calloc(1, sizeof(*reader));
+        pthread_mutex_lock(&festival_lock);
+        if (reader && !__atomic_load_n(&festival_reader_lost, __ATOMIC_RELAXED) &&
+            pthread_setspecific(festival_reader_key, reader) == 0) {
+            reader->next = festival_readers;
+            festival_readers = reader;
+            festival_reader = reader;
+        } else {
+            /* Unrecorded reader: keep every snapshot from now on */
+            __atomic_store_n(&festival_reader_lost, 1, __ATOMIC_RELAXED);
+            free(reader);
+        }
+        pthread_mutex_unlock(&festival_lock);
+        if (!festival_reader) return;
+    }
+    /* Stored before the load: a writer that misses it has already swapped */
+    unsigned generation = __atomic_load_n(&festival_published, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&festival_reader->since, generation + 1, __ATOMIC_SEQ_CST);
+}
+
+static const FestivalSet *current_festivals(void)
+{
+    if (!festival_reader || !festival_reader->since) begin_festival_read();
+    const FestivalSet *set = __atomic_load_n(&festival_set, __ATOMIC_SEQ_CST);
+    if (set) return set;
+    pthread_once(&builtin_set_once, build_builtin_set);
+    return &builtin_set;
+}
+
+/* The snapshot a writer builds on, without recording a read; caller holds festival_lock */
+static const FestivalSet *latest_festivals(void)
+{
+    if (festival_set) return festival_set;
+    pthread_once(&builtin_set_once, build_builtin_set);
+    return &builtin_set;
+}
+
+/* Index and swap in a successor snapshot, retiring the old; caller holds festival_lock */
+static void publish_festivals(FestivalSet *next)
+{
+    FestivalSet *prev = festival_set;
+    next->generation = ++festival_generation;
+    next->replaced_by = 0;
+    next->owns = 0;
+    next->retired_next = NULL;
+    build_festival_index(next);
+    __atomic_store_n(&festival_set, next, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&festival_published, next->generation, __ATOMIC_SEQ_CST);
+    if (!prev) return;   /* The built-in set is static */
+
+    prev->replaced_by = next->generation;
+    if (prev->registered != next->registered) prev->owns |= FESTIVAL_OWNS_REGISTERED;
+    if (prev->loaded != next->loaded) prev->owns |= FESTIVAL_OWNS_LOADED;
+    if (prev->rules != next->rules) prev->owns |= FESTIVAL_OWNS_RULES;
+    prev->retired_next = festival_retired;
+    festival_retired = prev;
+    reclaim_festivals();
+}
+
+void festivals_quiescent(void)
+{
+    if (!festival_reader || !festival_reader->since) return;
+    __atomic_store_n(&festival_reader->since, 0, __ATOMIC_SEQ_CST);
+    if (!__atomic_load_n(&festival_retired_any, __ATOMIC_RELAXED)) return;
+    pthread_mutex_lock(&festival_lock);
+    reclaim_festivals();
+    pthread_mutex_unlock(&festival_lock);
+}
+
+int multi_festival_total(void)
+{
+    const FestivalSet *set = current_festivals();
+    return MULTI_FESTIVAL_COUNT + set->registered_count + set->loaded_count;
+}
+
+const MultiFestival *multi_festival_by_id(int id)
+{
+    return set_festival_by_id(current_festivals(), id);
+}
+
+const FestivalIndexEntry *festival_lookup(int month, int day)
+{
+    static const FestivalIndexEntry none = {-1, -1, 0, 0};
+    int row = festival_row(month);
+    if (row < 0 || day < 0 || day >= FESTIVAL_INDEX_DAYS) return &none;
+    return &current_festivals()->index[row][day];
+}
+
+int register_festival(const char *name, const char *coligny_name,
+                      int month, int start_day, int duration, int type)
+{
+    if (!name || festival_row(month) < 0 || start_day < 1 || duration < 1) return -1;
+    if (start_day + duration - 1 >= FESTIVAL_INDEX_DAYS) return -1;
+
+    char *name_copy = strdup(name);
+    char *coligny_copy = strdup(coligny_name ? coligny_name : name);
+    FestivalSet *next = malloc(sizeof(*next));
+    if (!name_copy || !coligny_copy || !next) {
+        free(name_copy);
+        free(coligny_copy);
+        free(next);
+        return -1;
+    }
+
+    pthread_mutex_lock(&festival_lock);
+    const FestivalSet *prev = latest_festivals();
+    int count = prev->registered_count;
+    MultiFestival *registered = malloc((count + 1) * sizeof(*registered));
+    if (!registered) {
+        pthread_mutex_unlock(&festival_lock);
+        free(name_copy);
+        free(coligny_copy);
+        free(next);
+        return -1;
+    }
+    if (count > 0) memcpy(registered, prev->registered, count * sizeof(*registered));
+
+    MultiFestival *mf = &registered[count];
+    mf->name = name_copy;
+    mf->coligny_name = coligny_copy;
+    mf->month = month;
+    mf->start_day = start_day;
+    mf->duration = duration;
+    mf->type = type;
+
+    *next = *prev;
+    next->registered_count = count + 1;
+    next->registered = registered;
+    publish_festivals(next);
+    pthread_mutex_unlock(&festival_lock);
+
+    return MULTI_FESTIVAL_COUNT + count;
+}
+
 /*
- * Get the day number within a multi-day festival (1, 2, 3...)
+ * ============================================================
+ * FESTIVAL FILES
+ * A file is parsed and checked in full before anything is published, so a
+ * bad edit leaves the running definitions in place.
+ * ============================================================
  */
-int get_festival_day_number(int month, int day)
+
+/* Month name or abbreviation as the views print it, or an index -1..11 */
+static int parse_month(const char *text, int *month)
 {
-    for (int i = 0; i < MULTI_FESTIVAL_COUNT; i++) {
-        if (month == multi_festivals[i].month) {
-            int start = multi_festivals[i].start_day;
-            int end = start + multi_festivals[i].duration - 1;
-            if (day >= start && day <= end) {
-                return day - start + 1;
+    for (int m = -1; m < 12; m++) {
+        if (strcasecmp(text, get_celtic_month_name(m)) == 0 || strcasecmp(text, get_month_abbrev(m)) == 0) {
+            *month = m;
+            return 0;
+        }
+    }
+    char *end;
+    long m = strtol(text, &end, 10);
+    if (end == text || *end || m < -1 || m > 11) return -1;
+    *month = (int)m;
+    return 0;
+}
+
+/* Integer within [lo, hi] */
+static int parse_int(const char *text, int lo, int hi, int *out)
+{
+    char *end;
+    long v = strtol(text, &end, 10);
+    if (end == text || *end || v < lo || v > hi) return -1;
+    *out = (int)v;
+    return 0;
+}
+
+/* Longitude in degrees, with or without a trailing degree sign */
+static int parse_longitude(const char *text, double *out)
+{
+    char *end;
+    double v = strtod(text, &end);
+    if (end == text || (*end && strcmp(end, "°") != 0) || v < 0.0 || v >= 360.0) return -1;
+    *out = v;
+    return 0;
+}
+
+/* "±N" or "+-N" */
+static int parse_window(const char *text, int *out)
+{
+    if (strncmp(text, "±", 2) == 0) text += 2;
+    else if (strncmp(text, "+-", 2) == 0) text += 2;
+    else return -1;
+    return parse_int(text, 0, 15, out);
+}
+
+static char *trim(char *s)
+{
+    while (isspace((unsigned char)*s)) s++;
+    size_t n = strlen(s);
+    while (n && isspace((unsigned char)s[n - 1])) s[--n] = '\0';
+    return s;
+}
+
+typedef struct {
+    int loaded_count;
+    MultiFestival loaded[FESTIVAL_RULES_MAX];
+    int rule_count;
+    FestivalRule rules[FESTIVAL_RULES_MAX];
+} FestivalFile;
+
+/*
+ * One definition line (comment already stripped, not blank) into f.
+ * Returns 0, -1 if malformed, or -2 if it is one too many (FESTIVAL_RULES_MAX).
+ */
+static int parse_festival_line(char *line, FestivalFile *f)
+{
+    char *colon = strchr(line, ':');
+    if (!colon) return -1;
+    *colon = '\0';
+
+    char *name = colon + 1;
+    char *coligny = strchr(name, '|');
+    if (coligny) *coligny++ = '\0';
+    name = trim(name);
+    coligny = coligny ? trim(coligny) : name;
+    if (!*name || !*coligny) return -1;
+
+    char *tok[8];
+    int n = 0;
+    char *save = NULL;
+    for (char *t = strtok_r(line, " \t", &save); t; t = strtok_r(NULL, " \t", &save)) {
+        if (n == 8) return -1;
+        tok[n++] = t;
+    }
+    if (n == 0) return -1;
+
+    if (strcmp(tok[0], "fixed") == 0) {
+        int month, day, days = 1;
+        if (n < 3 || n > 4 || parse_month(tok[1], &month) != 0 ||
+            parse_int(tok[2], 1, FESTIVAL_INDEX_DAYS - 1, &day) != 0 ||
+            (n == 4 && parse_int(tok[3], 1, FESTIVAL_INDEX_DAYS - day, &days) != 0))
+            return -1;
+        if (f->loaded_count == FESTIVAL_RULES_MAX) return -2;
+        MultiFestival *mf = &f->loaded[f->loaded_count];
+        mf->name = strdup(name);
+        mf->coligny_name = strdup(coligny);
+        if (!mf->name || !mf->coligny_name) {
+            free((char *)mf->name);
+            free((char *)mf->coligny_name);
+            return -1;
+        }
+        mf->month = month;
+        mf->start_day = day;
+        mf->duration = days;
+        mf->type = 0;
+        f->loaded_count++;
+        return 0;
+    }
+
+    FestivalRule r = {0};
+    if (strcmp(tok[0], "sun") == 0) {
+        r.kind = RULE_SUN;
+        if (n < 2 || n > 3 || parse_longitude(tok[1], &r.longitude) != 0 ||
+            (n == 3 && parse_window(tok[2], &r.before) != 0))
+            return -1;
+        r.after = r.before;
+    } else if (strcmp(tok[0], "fullmoon") == 0 && n >= 3 && strcmp(tok[1], "after") == 0) {
+        /* fullmoon after sun <degrees> [<days>] | fullmoon after <month> <day> [<days>] */
+        int days = 1;
+        if (n < 4 || n > 5) return -1;
+        if (strcmp(tok[2], "sun") == 0) {
+            r.kind = RULE_FULL_MOON_AFTER_SUN;
+            if (parse_longitude(tok[3], &r.longitude) != 0) return -1;
+        } else {
+            r.kind = RULE_FULL_MOON_AFTER_DAY;
+            if (parse_month(tok[2], &r.month) != 0 || parse_int(tok[3], 1, 30, &r.day) != 0) return -1;
+        }
+        if (n == 5 && parse_int(tok[4], 1, 30, &days) != 0) return -1;
+        r.after = days - 1;
+    } else {
+        return -1;
+    }
+
+    if (f->rule_count == FESTIVAL_RULES_MAX) return -2;
+    r.name = strdup(name);
+    r.coligny_name = strdup(coligny);
+    if (!r.name || !r.coligny_name) {
+        free((char *)r.name);
+        free((char *)r.coligny_name);
+        return -1;
+    }
+    f->rules[f->rule_count++] = r;
+    return 0;
+}
+
+static void free_festival_file(FestivalFile *f)
+{
+    for (int i = 0; i < f->loaded_count; i++) {
+        free((char *)f->loaded[i].name);
+        free((char *)f->loaded[i].coligny_name);
+    }
+    for (int i = 0; i < f->rule_count; i++) {
+        free((char *)f->rules[i].name);
+        free((char *)f->rules[i].coligny_name);
+    }
+}
+
+static int read_festival_file(const char *path, FestivalFile *f, int *error_line)
+{
+    FILE *fp = fopen(path, "r");
+    if (!fp) return -1;
+
+    char line[FESTIVAL_LINE_MAX];
+    int number = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        number++;
+        size_t len = strlen(line);
+        int too_long = len == sizeof(line) - 1 && line[len - 1] != '\n' && !feof(fp);
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char *text = trim(line);
+        if (!too_long && !*text) continue;
+        int status = too_long ? -1 : parse_festival_line(text, f);
+        if (status != 0) {
+            if (error_line) *error_line = number;
+            fclose(fp);
+            errno = status == -2 ? E2BIG : EINVAL;
+            return -1;
+        }
+    }
+    int failed = ferror(fp);
+    fclose(fp);
+    if (failed) {
+        errno = EIO;
+        return -1;
+    }
+    return 0;
+}
+
+int festivals_load(const char *path, int *error_line)
+{
+    if (error_line) *error_line = 0;
+
+    FestivalFile *f = calloc(1, sizeof(*f));
+    char *path_copy = strdup(path);
+    FestivalSet *next = malloc(sizeof(*next));
+    MultiFestival *loaded = NULL;
+    FestivalRule *rules = NULL;
+    if (f && path_copy && next && read_festival_file(path, f, error_line) == 0) {
+        loaded = malloc(sizeof(*loaded) * (f->loaded_count ? f->loaded_count : 1));
+        rules = malloc(sizeof(*rules) * (f->rule_count ? f->rule_count : 1));
+    }
+    if (!loaded || !rules) {
+        int saved = (f && path_copy && next) ? errno : ENOMEM;
+        if (f) free_festival_file(f);
+        free(f);
+        free(path_copy);
+        free(next);
+        free(loaded);
+        free(rules);
+        errno = saved;
+        return -1;
+    }
+    memcpy(loaded, f->loaded, sizeof(*loaded) * f->loaded_count);
+    memcpy(rules, f->rules, sizeof(*rules) * f->rule_count);
+    int count = f->loaded_count + f->rule_count;
+
+    pthread_mutex_lock(&festival_lock);
+    *next = *latest_festivals();
+    next->loaded_count = f->loaded_count;
+    next->loaded = loaded;
+    next->rule_count = f->rule_count;
+    next->rules = rules;
+    publish_festivals(next);
+    free(festival_path);
+    festival_path = path_copy;
+    pthread_mutex_unlock(&festival_lock);
+
+    free(f);
+    return count;
+}
+
+int festivals_reload(int *error_line)
+{
+    if (error_line) *error_line = 0;
+    pthread_mutex_lock(&festival_lock);
+    char *path = festival_path ? strdup(festival_path) : NULL;
+    int none = festival_path == NULL;
+    pthread_mutex_unlock(&festival_lock);
+    if (none) return 0;
+    if (!path) {
+        errno = ENOMEM;
+        return -1;
+    }
+    int count = festivals_load(path, error_line);
+    int saved = errno;
+    free(path);
+    errno = saved;
+    return count;
+}
+
+/*
+ * ============================================================
+ * ASTRONOMICAL FESTIVALS
+ * Each definition resolves to one run of days per Samhain year, anchored
+ * on that year's event table. The runs of a year are kept per thread,
+ * direct-mapped by year and tagged with the snapshot generation, so a
+ * reload simply stops matching the old ones.
+ * ============================================================
+ */
+#define FESTIVAL_YEAR_SLOTS 16
+#define FESTIVAL_SAMHAIN_LONGITUDE 225.0
+#define SOLAR_DAYS_PER_DEGREE (365.2422 / 360.0)
+
+typedef struct {
+    int valid;
+    unsigned generation;
+    int samhain_year;
+    long first[FESTIVAL_RULES_MAX];   /* first > last: no run this year */
+    long last[FESTIVAL_RULES_MAX];
+    long peak[FESTIVAL_RULES_MAX];
+} FestivalYear;
+
+static _Thread_local FestivalYear festival_year_cache[FESTIVAL_YEAR_SLOTS];
+
+/* Day nearest the Sun's crossing of longitude after the Samhain of ey */
+static long sun_day(const EventYear *ey, double longitude)
+{
+    double from_samhain = fmod(longitude - FESTIVAL_SAMHAIN_LONGITUDE + 360.0, 360.0);
+    return lround(solar_longitude_crossing(ey->solar[0] + from_samhain * SOLAR_DAYS_PER_DEGREE, longitude));
+}
+
+/* Anchor day of a rule in a Samhain year; 0 if it has none (e.g. no Quimonios) */
+static int rule_anchor(const FestivalRule *r, const EventYear *ey, long *anchor)
+{
+    if (r->kind != RULE_FULL_MOON_AFTER_DAY) {
+        *anchor = sun_day(ey, r->longitude);
+        return 1;
+    }
+    int year = celtic_year_from_jd(lround(ey->solar[0]));
+    return jd_from_lunar_celtic(year, r->month, r->day, anchor) == 0;
+}
+
+static void build_festival_year(const FestivalSet *set, int samhain_year, FestivalYear *fy)
+{
+    const EventYear *ey = event_year(samhain_year);
+    fy->samhain_year = samhain_year;
+    fy->generation = set->generation;
+    for (int i = 0; i < set->rule_count; i++) {
+        const FestivalRule *r = &set->rules[i];
+        long day;
+        if (!rule_anchor(r, ey, &day)) {
+            fy->first[i] = 1;
+            fy->last[i] = 0;
+            continue;
+        }
+        if (r->kind != RULE_SUN) day = jd_of_full_moon(lunation_number(day) + 1);
+        fy->peak[i] = day;
+        fy->first[i] = day - r->before;
+        fy->last[i] = day + r->after;
+    }
+}
+
+static const FestivalYear *festival_year(const FestivalSet *set, int samhain_year)
+{
+    FestivalYear *fy = &festival_year_cache[(unsigned)samhain_year % FESTIVAL_YEAR_SLOTS];
+    if (!fy->valid || fy->samhain_year != samhain_year || fy->generation != set->generation) {
+        build_festival_year(set, samhain_year, fy);
+        fy->valid = 1;
+    }
+    return fy;
+}
+
+int festival_rule_at(long jd, FestivalOccurrence *out)
+{
+    const FestivalSet *set = current_festivals();
+    if (set->rule_count == 0) return 0;
+
+    /*
+     * A year's runs start no earlier than 15 days before its Samhain, and an
+     * anchor near the next Samhain, the full moon after it and a 30-day run
+     * carry them past the following 31 December, so a day can belong to the
+     * Samhain years of the two calendar years before it.
+     */
+    int year, month, day;
+    ymd_from_jd(jd, &year, &month, &day);
+    for (int y = year - 2; y <= year; y++) {
+        const FestivalYear *fy = festival_year(set, y);
+        for (int i = 0; i < set->rule_count; i++) {
+            if (jd < fy->first[i] || jd > fy->last[i]) continue;
+            if (out) {
+                out->name = set->rules[i].name;
+                out->coligny_name = set->rules[i].coligny_name;
+                out->first = fy->first[i];
+                out->last = fy->last[i];
+                out->peak = fy->peak[i];
             }
+            return 1;
         }
     }
     return 0;
 }
+
+/*
+ * Check if a given day falls within a multi-day festival
+ * Returns: festival index (0-7) or -1 if not a festival day
+ */
+int get_multi_festival(int month, int day)
+{
+    if (festival_row(month) < 0 || day < 0 || day >= FESTIVAL_INDEX_DAYS) {
+        return scan_multi_festival(current_festivals(), month, day);
+    }
+    return festival_lookup(month, day)->multi;
+}
+
+/*
+ * Get the day number within a multi-day festival (1, 2, 3...)
+ */
+int get_festival_day_number(int month, int day)
+{
+    if (festival_row(month) < 0 || day < 0 || day >= FESTIVAL_INDEX_DAYS) {
+        const FestivalSet *set = current_festivals();
+        int id = scan_multi_festival(set, month, day);
+        return (id < 0) ? 0 : day - set_festival_by_id(set, id)->start_day + 1;
+    }
+    return festival_lookup(month, day)->day_number;
+}
@@ -30,4 +30,86 @@ extern const int MULTI_FESTIVAL_COUNT;
 int get_multi_festival(int month, int day);
 int get_festival_day_number(int month, int day);
 
+/*
+ * Festival lookup index
+ * One entry per (month, day): month 0-11 plus row 12 for the intercalary
+ * Quimonios (month -1), days 1..FESTIVAL_INDEX_DAYS-1. Built on first use
+ * from festivals[], multi_festivals[], registered festivals and the fixed
+ * entries of a loaded festival file, and safe to read from any number of
+ * threads without locking.
+ */
+#define FESTIVAL_INDEX_DAYS 33
+#define FESTIVAL_FLAG_IVOS 0x01   /* Marked as a festival day in the grids */
+
+typedef struct {
+    short multi;           /* Multi-day festival id, -1 if none */
+    short fixed;           /* festivals[] index, -1 if none */
+    unsigned char day_number; /* Day within the multi-day festival, 0 if none */
+    unsigned char flags;
+} FestivalIndexEntry;
+
+const FestivalIndexEntry *festival_lookup(int month, int day);
+
+/*
+ * User-registered multi-day festivals (regional IVOS days). They take ids
+ * after the built-in multi_festivals[] and are marked IVOS in the grids.
+ * Returns the new id, or -1 on failure. May run while other threads look
+ * festivals up: they see the index before or after the new entry, and ids,
+ * entries and names already handed out stay valid.
+ */
+int register_festival(const char *name, const char *coligny_name,
+                      int month, int start_day, int duration, int type);
+int multi_festival_total(void);
+const MultiFestival *multi_festival_by_id(int id);
+
+/*
+ * Festival definition files: one definition per line, '#' to end of line
+ * is a comment.
+ *
+ *   fixed <month> <day> [<days>]           : <name> [| <coligny name>]
+ *   sun <degrees> [±<days>]                : <name> [| <coligny name>]
+ *   fullmoon after sun <degrees> [<days>]  : <name> [| <coligny name>]
+ *   fullmoon after <month> <day> [<days>]  : <name> [| <coligny name>]
+ *
+ * Months are lunar months by name or abbreviation as the views print them
+ * (Quimonios for the intercalary month) or by index (-1..11); days are
+ * lunar month days. fixed entries join the festival index after the
+ * registered ones. sun marks the day nearest the Sun's crossing of the
+ * longitude, widened by ±days ("+-" also accepted); fullmoon marks <days>
+ * days (default 1) from the first full moon after the anchor day. Both
+ * resolve once per Samhain year (festival_rule_at()). A file holds at most
+ * FESTIVAL_RULES_MAX fixed and FESTIVAL_RULES_MAX astronomical definitions.
+ *
+ * A load replaces everything the previous file defined in one atomic swap:
+ * readers never lock, and keep the old definitions until they look again.
+ * Returns the number of definitions, or -1 with errno set (EINVAL for a
+ * bad line, E2BIG for one past the limit; its number goes to *error_line)
+ * and the current definitions untouched. festivals_reload() reads the
+ * last loaded file again (0 if none was loaded).
+ */
+#define FESTIVAL_RULES_MAX 32   /* Per kind (fixed, astronomical) */
+int festivals_load(const char *path, int *error_line);
+int festivals_reload(int *error_line);
+
+typedef struct {
+    const char *name;
+    const char *coligny_name;
+    long first;     /* JD of the first marked day */
+    long last;      /* JD of the last */
+    long peak;      /* Day of the crossing or the full moon */
+} FestivalOccurrence;
+
+/* 1 and *out (may be NULL) if an astronomical definition marks jd, else 0 */
+int festival_rule_at(long jd, FestivalOccurrence *out);
+
+/*
+ * Entries, festivals and names returned above stay valid until the calling
+ * thread calls festivals_quiescent(), which tells a replaced definition set
+ * it is no longer held by this thread; the set is freed once no thread
+ * holds it. Threads exiting count as quiescent. A long-running thread that
+ * reads festivals across reloads should call it between requests, or every
+ * replaced set is kept.
+ */
+void festivals_quiescent(void);
+
 #endif
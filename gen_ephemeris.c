@@ -0,0 +1,58 @@
+/*
+ * gen_ephemeris — write a precomputed ephemeris file (format in ephemeris.h)
+ *
+ * Evaluates the series in astronomy.c once for every day, Samhain year and
+ * lunation of the span and stores the results for ephemeris_open() to map.
+ * Point the programs at the file with CELTIC_EPHEMERIS=path. With -t the
+ * records come from a more precise tier (precision.h), so programs reading
+ * the file get true full moons and crossings at lookup cost.
+ *
+ * Usage: gen_ephemeris [-y first_year:last_year] [-t fast|standard|high] output.eph
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ephemeris.h"
+#include "astronomy.h"
+
+#define DEFAULT_FIRST_YEAR 1600
+#define DEFAULT_LAST_YEAR  2400
+
+int main(int argc, char *argv[])
+{
+    int first_year = DEFAULT_FIRST_YEAR;
+    int last_year = DEFAULT_LAST_YEAR;
+    PrecisionTier tier = PRECISION_FAST;
+    const char *path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "-y") == 0) {
+            if (sscanf(argv[++i], "%d:%d", &first_year, &last_year) != 2 || last_year < first_year) {
+                fprintf(stderr, "-y needs first_year:last_year\n");
+                return 1;
+            }
+        } else if (i + 1 < argc && strcmp(argv[i], "-t") == 0) {
+            if (precision_tier_parse(argv[++i], &tier) != 0 || astronomy_set_tier(tier) != 0) {
+                fprintf(stderr, "-t needs fast, standard or high\n");
+                return 1;
+            }
+        } else if (!path && argv[i][0] != '-') {
+            path = argv[i];
+        } else {
+            path = NULL;
+            break;
+        }
+    }
+    if (!path) {
+        fprintf(stderr, "Usage: %s [-y first_year:last_year] [-t fast|standard|high] output.eph\n", argv[0]);
+        return 1;
+    }
+
+    if (ephemeris_write(path, first_year, last_year) != 0) {
+        perror(path);
+        return 1;
+    }
+    fprintf(stderr, "Wrote %s (Samhain years %d..%d, %s tier)\n", path, first_year, last_year,
+            precision_tier_name(tier));
+    return 0;
+}
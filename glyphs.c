@@ -1,15 +1,19 @@
 #define _XOPEN_SOURCE 700
 #include <stdio.h>
-#include <wchar.h>
-#include <wctype.h>
-#include <locale.h>
+#include <stdarg.h>
 #include <limits.h>
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 #include "calendar.h"
 #include "astronomy.h"
 #include "festivals.h"
+#include "cursor.h"
 #include "data.h"
+#include "glyphs.h"
+#include "text_layout.h"
+#include "profile.h"
 
 #define CELL_WIDTH 9
 #define INFO_WIDTH 71
@@ -20,12 +24,152 @@ static const char *zodiac_glyphs[12] = {"♈","♉","♊","♋","♌","♍","♎
 static const char *zodiac_names[12] = {"Aries","Taurus","Gemini","Cancer","Leo","Virgo","Libra","Scorpio","Sagittarius","Capricorn","Aquarius","Pisces"};
 static const char *weekday_glyphs[7] = {"☉", "☽", "♂", "☿", "♃", "♀", "♄"};
 
-static int display_width(const char *s);
+static int in_festival_window(int offset);
 static int is_festival_day(int month_index, int day, long jd);
 
+/* ═══════════════════════════════════════════════════════════════════════════
+ * RENDER SINK
+ * Text is appended to one growable buffer; every completed line records its
+ * offset, byte length and display width so callers can place lines without
+ * re-scanning. A failed allocation drops further output and sets 'failed'.
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+void render_sink_init(RenderSink *s)
+{
+    memset(s, 0, sizeof(*s));
+}
+
+void render_sink_reset(RenderSink *s)
+{
+    s->len = 0;
+    s->line_begin = 0;
+    s->line_count = 0;
+    s->max_width = 0;
+    s->failed = 0;
+    if (s->buf) s->buf[0] = '\0';
+}
+
+void render_sink_free(RenderSink *s)
+{
+    free(s->buf);
+    free(s->lines);
+    render_sink_init(s);
+}
+
+static int sink_reserve(RenderSink *s, size_t extra)
+{
+    if (s->failed) return 0;
+    if (s->len + extra + 1 <= s->cap) return 1;
+
+    size_t cap = s->cap ? s->cap : 4096;
+    while (cap < s->len + extra + 1) cap *= 2;
+    char *buf = realloc(s->buf, cap);
+    if (!buf) {
+        s->failed = 1;
+        return 0;
+    }
+    s->buf = buf;
+    s->cap = cap;
+    return 1;
+}
+
+/* Close the line that runs from line_begin to 'end' (exclusive of '\n') */
+static void sink_close_line(RenderSink *s, size_t end)
+{
+    if (s->line_count == s->line_cap) {
+        int cap = s->line_cap ? s->line_cap * 2 : 128;
+        RenderLine *lines = realloc(s->lines, sizeof(RenderLine) * cap);
+        if (!lines) {
+            s->failed = 1;
+            return;
+        }
+        s->lines = lines;
+        s->line_cap = cap;
+    }
+
+    RenderLine *line = &s->lines[s->line_count++];
+    line->offset = s->line_begin;
+    line->length = end - s->line_begin;
+    line->width = text_display_width_n(s->buf + line->offset, line->length);
+    if (line->width > s->max_width) s->max_width = line->width;
+}
+
+static void sink_write(RenderSink *s, const char *text, size_t n)
+{
+    if (!sink_reserve(s, n)) return;
+    PROFILE_ADD(PROF_RENDER_BYTES, n);
+
+    size_t start = s->len;
+    memcpy(s->buf + start, text, n);
+    s->len += n;
+    s->buf[s->len] = '\0';
+
+    for (const char *p = s->buf + start, *end = s->buf + s->len;
+         (p = memchr(p, '\n', (size_t)(end - p))) != NULL; p++) {
+        size_t nl = (size_t)(p - s->buf);
+        sink_close_line(s, nl);
+        s->line_begin = nl + 1;
+    }
+}
+
+static void sink_puts(RenderSink *s, const char *text)
+{
+    sink_write(s, text, strlen(text));
+}
+
+static void sink_putc(RenderSink *s, char c)
+{
+    sink_write(s, &c, 1);
+}
+
+static void sink_printf(RenderSink *s, const char *fmt, ...)
+{
+    char tmp[256];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(tmp, sizeof(tmp), fmt, ap);
+    va_end(ap);
+    if (n < 0) return;
+
+    if ((size_t)n < sizeof(tmp)) {
+        sink_write(s, tmp, (size_t)n);
+        return;
+    }
+
+    /* Longer than the scratch buffer: format again straight into the sink */
+    char *big = malloc((size_t)n + 1);
+    if (!big) {
+        s->failed = 1;
+        return;
+    }
+    va_start(ap, fmt);
+    vsnprintf(big, (size_t)n + 1, fmt, ap);
+    va_end(ap);
+    sink_write(s, big, (size_t)n);
+    free(big);
+}
+
+/* Record a trailing line that was not terminated by '\n' */
+static void sink_end_line(RenderSink *s)
+{
+    if (!s->failed && s->line_begin < s->len) {
+        sink_close_line(s, s->len);
+        s->line_begin = s->len;
+    }
+}
+
+const char *render_sink_line(const RenderSink *s, int index, size_t *length)
+{
+    if (index < 0 || index >= s->line_count) return NULL;
+    if (length) *length = s->lines[index].length;
+    return s->buf + s->lines[index].offset;
+}
+
 typedef struct {
     const char *name;
     int offset;
+    int solilunar;   /* Imbolc within a day of a full moon */
+    int rule;        /* From a festival file (festival_rule_at()) */
 } SolarEvent;
 
 /* Check if a solar event is within ~1 day of a full moon (solilunar alignment) */
@@ -44,159 +188,169 @@ static void append_solar_event(const char *name, int offset, int month_days,
     if (offset >= 0 && offset < month_days && *count < max_events) {
         events[*count].name = name;
         events[*count].offset = offset;
+        events[*count].solilunar = 0;
+        events[*count].rule = 0;
         (*count)++;
     }
 }
 
-static int collect_solar_events(long jd_start, int month_days, SolarEvent *events, int max_events)
+/*
+ * Everything astronomical one month grid needs: phases from a single span
+ * evaluation (or a slice of a longer one), and the festival flags and
+ * quarter-day events from one cursor walk over its days. Rendering from it
+ * makes no further ephemeris calls.
+ */
+#define MONTH_MAX_DAYS 31
+#define MONTH_MAX_EVENTS 16
+
+typedef struct {
+    int phase[MONTH_MAX_DAYS];
+    unsigned char festival[MONTH_MAX_DAYS];
+    SolarEvent events[MONTH_MAX_EVENTS];
+    int event_count;
+} MonthEphemeris;
+
+/* Fills from a cursor on jd_start and leaves it on the day after the month */
+static void month_ephemeris_fill(MonthEphemeris *eph, int month_index, CelticCursor *cur, int month_days,
+                                 const int *phases)
 {
-    int count = 0;
-    append_solar_event("Yule (270°)",       days_to_yule(jd_start),         month_days, events, max_events, &count);
-    append_solar_event("Ostara (0°)",       days_to_ostara(jd_start),       month_days, events, max_events, &count);
-    append_solar_event("Litha (90°)",       days_to_litha(jd_start),        month_days, events, max_events, &count);
-    append_solar_event("Mabon (180°)",      days_to_mabon(jd_start),        month_days, events, max_events, &count);
-    append_solar_event("Samhain (225°)",    days_to_true_samhain(jd_start), month_days, events, max_events, &count);
-    append_solar_event("Imbolc (315°)",     days_to_true_imbolc(jd_start),  month_days, events, max_events, &count);
-    append_solar_event("Beltane (45°)",     days_to_true_beltane(jd_start), month_days, events, max_events, &count);
-    append_solar_event("Lughnasadh (135°)", days_to_true_lughnasadh(jd_start), month_days, events, max_events, &count);
-    return count;
+    /* Indexed by eight-fold id (0=Yule .. 7=Samhain) */
+    static const char *event_names[8] = {
+        "Yule (270°)", "Imbolc (315°)", "Ostara (0°)", "Beltane (45°)",
+        "Litha (90°)", "Lughnasadh (135°)", "Mabon (180°)", "Samhain (225°)"
+    };
+
+    long jd_start = cur->jd;
+    if (month_days > MONTH_MAX_DAYS) month_days = MONTH_MAX_DAYS;
+    if (phases) memcpy(eph->phase, phases, sizeof(int) * (size_t)month_days);
+    else ephemeris_span(jd_start, month_days, eph->phase, NULL, NULL);
+
+    eph->event_count = 0;
+    for (int day = 1; day <= month_days; day++, cursor_next(cur)) {
+        FestivalOccurrence occ;
+        int rule = festival_rule_at(cur->jd, &occ);
+        eph->festival[day - 1] = (festival_lookup(month_index, day)->flags & FESTIVAL_FLAG_IVOS) ||
+                                 in_festival_window(cur->event_days) || rule;
+        if (cur->event_days == 0) {
+            append_solar_event(event_names[cur->event], day - 1, month_days, eph->events, MONTH_MAX_EVENTS,
+                               &eph->event_count);
+        }
+        if (rule && occ.peak == cur->jd) {
+            int before = eph->event_count;
+            append_solar_event(occ.name, day - 1, month_days, eph->events, MONTH_MAX_EVENTS, &eph->event_count);
+            if (eph->event_count > before) eph->events[before].rule = 1;
+        }
+    }
+
+    for (int i = 0; i < eph->event_count; i++) {
+        eph->events[i].solilunar = !eph->events[i].rule && (strstr(eph->events[i].name, "Imbolc") != NULL) &&
+                                   is_solilunar_alignment(jd_start, eph->events[i].offset);
+    }
 }
 
 /* Wide info box helpers to align with the 7-column grid */
-static void info_border(const char *left, const char *right)
+static void info_border(RenderSink *out, const char *left, const char *right)
 {
-    fputs(left, stdout);
-    for (int i = 0; i < INFO_WIDTH; i++) fputs("─", stdout);
-    fputs(right, stdout);
-    fputc('\n', stdout);
+    sink_puts(out, left);
+    for (int i = 0; i < INFO_WIDTH; i++) sink_puts(out, "─");
+    sink_puts(out, right);
+    sink_putc(out, '\n');
 }
 
-static void info_line(const char *text)
+static void info_line(RenderSink *out, const char *text)
 {
-    int w = display_width(text);
+    int w = text_display_width(text);
     int pad = INFO_WIDTH - w;
     if (pad < 0) pad = 0;
-    fputs("│", stdout);
-    fputs(text, stdout);
-    for (int i = 0; i < pad; i++) fputc(' ', stdout);
-    fputs("│\n", stdout);
+    sink_puts(out, "│");
+    sink_puts(out, text);
+    for (int i = 0; i < pad; i++) sink_putc(out, ' ');
+    sink_puts(out, "│\n");
 }
 
 /* Span the calendar grid width (7 columns) with centered text */
-static void grid_span_center(const char *text)
+static void grid_span_center(RenderSink *out, const char *text)
 {
-    int w = display_width(text);
+    int w = text_display_width(text);
     int pad = GRID_SPAN_WIDTH - w;
     if (pad < 0) pad = 0;
     int left = pad / 2;
     int right = pad - left;
-    fputs("│", stdout);
-    for (int i = 0; i < left; i++) fputc(' ', stdout);
-    fputs(text, stdout);
-    for (int i = 0; i < right; i++) fputc(' ', stdout);
-    fputs("│\n", stdout);
+    sink_puts(out, "│");
+    for (int i = 0; i < left; i++) sink_putc(out, ' ');
+    sink_puts(out, text);
+    for (int i = 0; i < right; i++) sink_putc(out, ' ');
+    sink_puts(out, "│\n");
 }
 
-static void print_border(const char *left, const char *mid, const char *right)
+static void print_border(RenderSink *out, const char *left, const char *mid, const char *right)
 {
-    fputs(left, stdout);
+    sink_puts(out, left);
     for (int col = 0; col < 7; col++) {
-        for (int i = 0; i < CELL_WIDTH; i++) fputs("─", stdout);
-        fputs(col == 6 ? right : mid, stdout);
+        for (int i = 0; i < CELL_WIDTH; i++) sink_puts(out, "─");
+        sink_puts(out, col == 6 ? right : mid);
     }
-    putchar('\n');
+    sink_putc(out, '\n');
 }
 
 /* Center text within a CELL_WIDTH field using display width */
-static void print_cell_center(const char *text)
+static void print_cell_center(RenderSink *out, const char *text)
 {
-    int w = display_width(text);
+    int w = text_display_width(text);
     int pad = CELL_WIDTH - w;
     if (pad < 0) pad = 0;
     int left = pad / 2;
     int right = pad - left;
-    for (int i = 0; i < left; i++) putchar(' ');
-    fputs(text, stdout);
-    for (int i = 0; i < right; i++) putchar(' ');
+    for (int i = 0; i < left; i++) sink_putc(out, ' ');
+    sink_puts(out, text);
+    for (int i = 0; i < right; i++) sink_putc(out, ' ');
 }
 
-static void print_week_header(void)
+static void print_week_header(RenderSink *out)
 {
     const char *names[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
 
-    printf("│");
+    sink_printf(out, "│");
     for (int i = 0; i < 7; i++) {
-        print_cell_center(weekday_glyphs[i]);
-        printf("│");
+        print_cell_center(out, weekday_glyphs[i]);
+        sink_printf(out, "│");
     }
-    printf("\n│");
+    sink_printf(out, "\n│");
     for (int i = 0; i < 7; i++) {
-        print_cell_center(names[i]);
-        printf("│");
+        print_cell_center(out, names[i]);
+        sink_printf(out, "│");
     }
-    printf("\n");
+    sink_printf(out, "\n");
 }
 
-/* Get the Coligny notation for a specific day */
-static const char* get_coligny_notation(int month_index, int day, int is_atenoux_half)
+/* Tablet notation of a day (PRINNI LOUD, M D, D AMB, ...) from data.c */
+static const char* get_coligny_notation(int month_index, int day)
 {
-    int mat = is_mat_month(month_index);
-
-    /* Days 7-8-9 in first half = PRINNI LOUD/LAG (full moon triplet) */
-    if (!is_atenoux_half && day >= 7 && day <= 9) {
-        if (day == 7) return mat ? "PRINNI LOUD" : "PRINNI LAG";
-        return mat ? "M D" : "D";
-    }
-
-    /* Days 22-23-24 in ATENOUX = N INIS R (dark moon nights) */
-    if (is_atenoux_half && day >= 22 && day <= 24) {
-        return "N INIS R";
-    }
-
-    /* Day 5 and 11 in first half = D AMB (inauspicious) */
-    if (!is_atenoux_half && (day == 5 || day == 11)) {
-        return "D AMB";
-    }
-
-    /* Odd days after 16 in ATENOUX = D AMB */
-    if (is_atenoux_half && day > 16 && (day % 2 == 1)) {
-        return "D AMB";
-    }
-
-    /* Default: MAT month = M D, ANM month = D */
-    return mat ? "M D" : "D";
+    unsigned char attr = coligny_day(month_index, day);
+    return coligny_notation_text[(attr & COLIGNY_NOTATION_MASK) >> COLIGNY_NOTATION_SHIFT];
 }
 
 /* Get triple mark for a day (ƚıı, ıƚı, or ııƚ) */
 static const char* get_triple_mark(int day)
 {
-    int cycle = (day - 1) % 6;  /* 6-day cycle: 3 marked + 3 unmarked */
-    if (cycle < 3) {
-        switch (cycle) {
-            case 0: return "ƚıı";
-            case 1: return "ıƚı";
-            case 2: return "ııƚ";
-        }
-    }
-    return "   ";  /* No mark for days 4-6 of each cycle */
+    unsigned char attr = coligny_day(0, day);
+    return coligny_triple_text[(attr & COLIGNY_TRIPLE_MASK) >> COLIGNY_TRIPLE_SHIFT];
 }
 
-static char day_marker(int month_index, int day_of_month)
+/* Cell marker from the MAT and D AMB bits: '!' D AMB, '*' M D, ' ' D */
+static char day_marker(unsigned char attr)
 {
-    int mat = is_mat_month(month_index);
-    int amb = is_d_amb(day_of_month);
-
-    if (amb) return '!';           /* D AMB - inauspicious */
-    if (mat) return '*';           /* M D - auspicious (MAT month) */
-    return ' ';                    /* D - neutral (ANM month) */
+    if (attr & COLIGNY_D_AMB) return '!';
+    if (attr & COLIGNY_MAT) return '*';
+    return ' ';
 }
 
-static void print_coligny_tablet(int month_index, int today_day, int mat, long jd_start)
+static void print_coligny_tablet(RenderSink *out, int month_index, int today_day, int mat, long jd_start)
 {
-    printf("\n");
-    printf("╔══════════════════════════════════════════════════╗\n");
-    printf("║     COLIGNY TABLET NOTATION FOR TODAY            ║\n");
-    printf("╠══════════════════════════════════════════════════╣\n");
+    sink_printf(out, "\n");
+    sink_printf(out, "╔══════════════════════════════════════════════════╗\n");
+    sink_printf(out, "║     COLIGNY TABLET NOTATION FOR TODAY            ║\n");
+    sink_printf(out, "╠══════════════════════════════════════════════════╣\n");
 
     const char *roman_numerals[] = {
         "", "I", "II", "III", "IIII", "V", "VI", "VII", "VIII", "VIIII",
@@ -207,95 +361,46 @@ static void print_coligny_tablet(int month_index, int today_day, int mat, long j
     int is_second_half = (today_day > 15);
     if (is_second_half) display_day = today_day - 15;
 
-    const char *notation = get_coligny_notation(month_index, today_day, is_second_half);
+    const char *notation = get_coligny_notation(month_index, today_day);
     const char *triple = get_triple_mark(today_day);
 
-    printf("║  ◎ %-5s %s %-3s %-11s                     ║\n",
+    sink_printf(out, "║  ◎ %-5s %s %-3s %-11s                     ║\n",
            roman_numerals[display_day],
            triple,
            mat ? "M" : " ",
            notation);
 
     if (today_day >= 7 && today_day <= 9 && !is_second_half) {
-        printf("║  [PRINNI %s - Full Moon Triplet]               ║\n",
+        sink_printf(out, "║  [PRINNI %s - Full Moon Triplet]               ║\n",
                mat ? "LOUD" : "LAG ");
     }
     if (is_second_half && today_day >= 22 && today_day <= 24) {
-        printf("║  [N INIS R - Dark Moon Night]                   ║\n");
+        sink_printf(out, "║  [N INIS R - Dark Moon Night]                   ║\n");
     }
 
     long jd_today = jd_start + today_day - 1;
     if (is_festival_day(month_index, today_day, jd_today)) {
-        printf("║  [IVOS - Festival Day]                           ║\n");
-    }
-
-    printf("╚══════════════════════════════════════════════════╝\n");
-
-    printf("\n┌──────────────────────────────────────────────────┐\n");
-    printf("│ COLIGNY NOTATION KEY:                            │\n");
-    printf("├──────────────────────────────────────────────────┤\n");
-    printf("│ ◎ = Peg hole (marks current day)                 │\n");
-    printf("│ * = M D - Matis Divertomu (auspicious day)       │\n");
-    printf("│   = D - Divertomu (neutral day)                  │\n");
-    printf("│ ! = D AMB - Divertomu Ambrix Ri (inauspicious)   │\n");
-    printf("│ ☆ = IVOS M D - Festival + Auspicious             │\n");
-    printf("│ ⚐ = IVOS D - Festival + Neutral                  │\n");
-    printf("│ ⚠ = IVOS D AMB - Festival + Inauspicious         │\n");
-    printf("│ [] = Today marker inside the grid                │\n");
-    printf("│ N INIS R = Dark moon night (days 22-24)          │\n");
-    printf("│ PRINNI LOUD/LAG = Full moon marker               │\n");
-    printf("│ ƚıı ıƚı ııƚ = Triple marks (daytime divisions)   │\n");
-    printf("│ DIVERTOMU = Virtual 30th day (29-day months)     │\n");
-    printf("└──────────────────────────────────────────────────┘\n");
-}
-
-/* One-time locale init so wcwidth() behaves with emojis */
-static void ensure_locale(void)
-{
-    static int initialized = 0;
-    if (!initialized) {
-        setlocale(LC_ALL, "");
-        initialized = 1;
-    }
-}
-
-/* Treat emoji code points as width 2 on terminals that report 1 */
-static int codepoint_width(wchar_t ch)
-{
-    int w = wcwidth(ch);
-    if (w < 0) w = 1;
-    if (w < 2) {
-        if ((ch >= 0x1F300 && ch <= 0x1FAFF) || /* Misc emoji, moons */
-            (ch >= 0x1F600 && ch <= 0x1F64F)) { /* Emoticons block */
-            w = 2;
-        }
+        sink_printf(out, "║  [IVOS - Festival Day]                           ║\n");
     }
-    return w;
-}
-
-/* Measure displayed width (accounts for double-width emoji) */
-static int display_width(const char *s)
-{
-    ensure_locale();
-    mbstate_t st = {0};
-    int width = 0;
-    const char *p = s;
-    wchar_t wc;
 
-    while (*p) {
-        size_t len = mbrtowc(&wc, p, MB_CUR_MAX, &st);
-        if (len == (size_t)-1 || len == (size_t)-2) {
-            /* Invalid sequence; treat byte as width 1 and advance */
-            ++p;
-            ++width;
-            memset(&st, 0, sizeof(st));
-            continue;
-        }
-        int w = codepoint_width(wc);
-        width += w;
-        p += len;
-    }
-    return width;
+    sink_printf(out, "╚══════════════════════════════════════════════════╝\n");
+
+    sink_printf(out, "\n┌──────────────────────────────────────────────────┐\n");
+    sink_printf(out, "│ COLIGNY NOTATION KEY:                            │\n");
+    sink_printf(out, "├──────────────────────────────────────────────────┤\n");
+    sink_printf(out, "│ ◎ = Peg hole (marks current day)                 │\n");
+    sink_printf(out, "│ * = M D - Matis Divertomu (auspicious day)       │\n");
+    sink_printf(out, "│   = D - Divertomu (neutral day)                  │\n");
+    sink_printf(out, "│ ! = D AMB - Divertomu Ambrix Ri (inauspicious)   │\n");
+    sink_printf(out, "│ ☆ = IVOS M D - Festival + Auspicious             │\n");
+    sink_printf(out, "│ ⚐ = IVOS D - Festival + Neutral                  │\n");
+    sink_printf(out, "│ ⚠ = IVOS D AMB - Festival + Inauspicious         │\n");
+    sink_printf(out, "│ [] = Today marker inside the grid                │\n");
+    sink_printf(out, "│ N INIS R = Dark moon night (days 22-24)          │\n");
+    sink_printf(out, "│ PRINNI LOUD/LAG = Full moon marker               │\n");
+    sink_printf(out, "│ ƚıı ıƚı ııƚ = Triple marks (daytime divisions)   │\n");
+    sink_printf(out, "│ DIVERTOMU = Virtual 30th day (29-day months)     │\n");
+    sink_printf(out, "└──────────────────────────────────────────────────┘\n");
 }
 
 /* Map to display glyphs (keep original emoji markers) */
@@ -310,7 +415,7 @@ static const char* status_glyph(int is_festival, char marker)
 }
 
 /* Render one fixed-width cell while keeping emojis and a bracketed today marker */
-static void print_day_cell(int day, int mp, char marker, int is_festival, int is_today)
+static void print_day_cell(RenderSink *out, int day, int mp, char marker, int is_festival, int is_today)
 {
     const char *status = status_glyph(is_festival, marker);
     char cell[32];
@@ -321,12 +426,12 @@ static void print_day_cell(int day, int mp, char marker, int is_festival, int is
         snprintf(cell, sizeof(cell), " %2d%s%s ", day, moon_symbols[mp], status);
     }
 
-    int w = display_width(cell);
+    int w = text_display_width(cell);
     int pad = CELL_WIDTH - w;
     if (pad < 0) pad = 0;
 
-    fputs(cell, stdout);
-    for (int i = 0; i < pad; i++) putchar(' ');
+    sink_puts(out, cell);
+    for (int i = 0; i < pad; i++) sink_putc(out, ' ');
 }
 
 /* Festival lookup: month/day match or astronomical cross-quarters */
@@ -339,34 +444,26 @@ static int in_festival_window(int offset)
 
 static int is_festival_day(int month_index, int day, long jd)
 {
-    for (int f = 0; f < FESTIVAL_COUNT; f++) {
-        if (festivals[f].month == month_index && festivals[f].day == day) {
-            return 1;
-        }
-    }
-
-    int yule = days_to_yule(jd); int ostara = days_to_ostara(jd);
-    int litha = days_to_litha(jd); int mabon = days_to_mabon(jd);
-    int samhain = days_to_true_samhain(jd); int imbolc = days_to_true_imbolc(jd);
-    int beltane = days_to_true_beltane(jd); int lughnasadh = days_to_true_lughnasadh(jd);
-
-    if (in_festival_window(yule) || in_festival_window(ostara) ||
-        in_festival_window(litha) || in_festival_window(mabon) ||
-        in_festival_window(samhain) || in_festival_window(imbolc) ||
-        in_festival_window(beltane) || in_festival_window(lughnasadh)) {
+    if ((festival_lookup(month_index, day)->flags & FESTIVAL_FLAG_IVOS) || festival_rule_at(jd, NULL)) {
         return 1;
     }
-    return 0;
+
+    /* Quarter and cross-quarter days come from the cached event year */
+    double event_jd;
+    next_eightfold_event(jd, &event_jd);
+    return in_festival_window((int)lround(event_jd - jd));
 }
 
-static void print_grid_half(int month_index, long jd_start, int start_day, int end_day, int today_day)
+static void print_grid_half(RenderSink *out, int month_index, long jd_start, int start_day, int end_day, int today_day,
+                            const MonthEphemeris *eph)
 {
     long jd_of_start = jd_start + start_day - 1;
     int weekday_of_start = (int)((jd_of_start + 1) % 7);
+    const unsigned char *attrs = coligny_day_attr[coligny_row(month_index)];
 
-    printf("│");
+    sink_printf(out, "│");
     for (int i = 0; i < weekday_of_start; i++) {
-        printf("%*s│", CELL_WIDTH, "");
+        sink_printf(out, "%*s│", CELL_WIDTH, "");
     }
 
     for (int day = start_day; day <= end_day; day++) {
@@ -374,22 +471,23 @@ static void print_grid_half(int month_index, long jd_start, int start_day, int e
         int day_weekday = (int)((jd + 1) % 7);
 
         if (day_weekday == 0 && day > start_day) {
-            putchar('\n');
-            print_border("├","┼","┤");
-            printf("│");
+            sink_putc(out, '\n');
+            print_border(out, "├","┼","┤");
+            sink_printf(out, "│");
         }
 
-        int mp = moon_phase(jd);
-        char marker = day_marker(month_index, day);
-        int festival = is_festival_day(month_index, day, jd);
+        int mp = eph->phase[day - 1];
+        char marker = day_marker(attrs[day]);
+        int festival = eph->festival[day - 1];
 
-        print_day_cell(day, mp, marker, festival, day == today_day);
-        printf("│");
+        print_day_cell(out, day, mp, marker, festival, day == today_day);
+        sink_printf(out, "│");
     }
 }
 
-void print_celtic_month(int month_index, long jd_start, long jd_today)
+void render_celtic_month(RenderSink *out, int month_index, long jd_start, long jd_today)
 {
+    PROFILE_BEGIN(PROF_RENDER_MONTH);
     int today_day = (int)(jd_today - jd_start) + 1;
     int weekday = (int)((jd_today + 1) % 7);
     int today_moon = moon_phase(jd_today);
@@ -399,18 +497,18 @@ void print_celtic_month(int month_index, long jd_start, long jd_today)
     int mat = is_mat_month(month_index);
     char line[128];
 
-    info_border("┌", "┐");
+    info_border(out, "┌", "┐");
     snprintf(line, sizeof(line), "  %-12s (%s)",
              get_celtic_month_name(month_index),
              get_month_abbrev(month_index));
-    info_line(line);
+    info_line(out, line);
     snprintf(line, sizeof(line), "  %-36s - %2d days",
              mat ? "Matis (lucky/complete month)" : "Anmatu (unlucky/incomplete month)",
              month_days);
-    info_line(line);
-    info_border("└", "┘");
+    info_line(out, line);
+    info_border(out, "└", "┘");
 
-    info_border("┌", "┐");
+    info_border(out, "┌", "┐");
     snprintf(line, sizeof(line), "  Today: Day %2d - %s - %s%s (%s) - ☉ Sun %s (%s)",
              today_day,
              weekday_glyphs[weekday],
@@ -419,93 +517,106 @@ void print_celtic_month(int month_index, long jd_start, long jd_today)
              zodiac_names[today_moon_zodiac],
              zodiac_glyphs[today_sun_zodiac],
              zodiac_names[today_sun_zodiac]);
-    info_line(line);
-    if (is_atenoux(today_day)) info_line("  ═══ ATENOUX (Second Coicise) ═══");
-    else                       info_line("  ═══ First Coicise ═══");
-    info_border("└", "┘");
+    info_line(out, line);
+    if (is_atenoux(today_day)) info_line(out, "  ═══ ATENOUX (Second Coicise) ═══");
+    else                       info_line(out, "  ═══ First Coicise ═══");
+    info_border(out, "└", "┘");
 
-    info_border("┌", "┐");
+    info_border(out, "┌", "┐");
     int has_festival = 0;
     for (int f = 0; f < FESTIVAL_COUNT; f++) {
         if (festivals[f].month == month_index) {
             snprintf(line, sizeof(line), "  IVOS: %-33s Day %2d", festivals[f].name, festivals[f].day);
-            info_line(line);
+            info_line(out, line);
+            has_festival = 1;
+        }
+    }
+    for (int id = MULTI_FESTIVAL_COUNT; id < multi_festival_total(); id++) {
+        const MultiFestival *mf = multi_festival_by_id(id);
+        if (mf->month == month_index) {
+            snprintf(line, sizeof(line), "  IVOS: %-33s Day %2d", mf->name, mf->start_day);
+            info_line(out, line);
             has_festival = 1;
         }
     }
-    SolarEvent solar_events[8];
-    int se_count = collect_solar_events(jd_start, month_days, solar_events, 8);
-    for (int i = 0; i < se_count; i++) {
-        int celtic_day = solar_events[i].offset + 1;
-        int solilunar = (strstr(solar_events[i].name, "Imbolc") != NULL) &&
-                        is_solilunar_alignment(jd_start, solar_events[i].offset);
-        if (solilunar) {
+    MonthEphemeris eph;
+    CelticCursor cur;
+    cursor_init(&cur, jd_start);
+    month_ephemeris_fill(&eph, month_index, &cur, month_days, NULL);
+    for (int i = 0; i < eph.event_count; i++) {
+        const SolarEvent *se = &eph.events[i];
+        int celtic_day = se->offset + 1;
+        if (se->solilunar) {
             snprintf(line, sizeof(line), "  IVOS: %-20s %s Day %2d [solilunar]",
-                     solar_events[i].name, get_celtic_month_name(month_index), celtic_day);
+                     se->name, get_celtic_month_name(month_index), celtic_day);
         } else {
             snprintf(line, sizeof(line), "  IVOS: %-20s %s Day %2d",
-                     solar_events[i].name, get_celtic_month_name(month_index), celtic_day);
+                     se->name, get_celtic_month_name(month_index), celtic_day);
         }
-        info_line(line);
+        info_line(out, line);
         has_festival = 1;
     }
-    if (!has_festival) info_line("  (No major festivals this month)");
-    info_border("└", "┘");
-
-    info_border("┌", "┐");
-    info_line("  * = M D - Auspicious (MAT month)");
-    info_line("  ! = D AMB - Inauspicious day");
-    info_line("  ☆ = IVOS + Auspicious");
-    info_line("  ⚐ = IVOS + Neutral");
-    info_line("  ⚠ = IVOS + Inauspicious");
-    info_line("  [] = Today (grid marker)");
-    info_border("└", "┘");
-    printf("\n");
-
-    print_border("┌","┬","┐");
-    grid_span_center("FIRST COICISE (Days I - XV)");
-    grid_span_center("🌕 Full Moon → 🌑 New Moon");
-    print_border("├","┼","┤");
-    print_week_header();
-    print_border("├","┼","┤");
-
-    print_grid_half(month_index, jd_start, 1, 15, today_day);
+    if (!has_festival) info_line(out, "  (No major festivals this month)");
+    info_border(out, "└", "┘");
+
+    info_border(out, "┌", "┐");
+    info_line(out, "  * = M D - Auspicious (MAT month)");
+    info_line(out, "  ! = D AMB - Inauspicious day");
+    info_line(out, "  ☆ = IVOS + Auspicious");
+    info_line(out, "  ⚐ = IVOS + Neutral");
+    info_line(out, "  ⚠ = IVOS + Inauspicious");
+    info_line(out, "  [] = Today (grid marker)");
+    info_border(out, "└", "┘");
+    sink_printf(out, "\n");
+
+    print_border(out, "┌","┬","┐");
+    grid_span_center(out, "FIRST COICISE (Days I - XV)");
+    grid_span_center(out, "🌕 Full Moon → 🌑 New Moon");
+    print_border(out, "├","┼","┤");
+    print_week_header(out);
+    print_border(out, "├","┼","┤");
+
+    print_grid_half(out, month_index, jd_start, 1, 15, today_day, &eph);
 
     int last_weekday_first = (int)((jd_start + 15) % 7);
-    for (int i = last_weekday_first; i < 6; i++) printf("%*s│", CELL_WIDTH, "");
-    printf("\n");
-    print_border("└","┴","┘");
-    printf("\n");
+    for (int i = last_weekday_first; i < 6; i++) sink_printf(out, "%*s│", CELL_WIDTH, "");
+    sink_printf(out, "\n");
+    print_border(out, "└","┴","┘");
+    sink_printf(out, "\n");
 
-    printf("        ════════ ATENOUX (🌑) ════════\n");
-    printf("           \"Returning Night\"\n\n");
+    sink_printf(out, "        ════════ ATENOUX (🌑) ════════\n");
+    sink_printf(out, "           \"Returning Night\"\n\n");
 
-    print_border("┌","┬","┐");
+    print_border(out, "┌","┬","┐");
     if (month_days == 30)
-        grid_span_center("SECOND COICISE (Days XVI - XXX)");
+        grid_span_center(out, "SECOND COICISE (Days XVI - XXX)");
     else
-        grid_span_center("SECOND COICISE (Days XVI - XXIX)");
-    grid_span_center("🌑 New Moon → 🌕 Full Moon");
-    print_border("├","┼","┤");
-    print_week_header();
-    print_border("├","┼","┤");
+        grid_span_center(out, "SECOND COICISE (Days XVI - XXIX)");
+    grid_span_center(out, "🌑 New Moon → 🌕 Full Moon");
+    print_border(out, "├","┼","┤");
+    print_week_header(out);
+    print_border(out, "├","┼","┤");
 
-    print_grid_half(month_index, jd_start, 16, month_days, today_day);
+    print_grid_half(out, month_index, jd_start, 16, month_days, today_day, &eph);
 
     int last_day_weekday = (int)((jd_start + month_days) % 7);
-    for (int i = last_day_weekday; i < 6; i++) printf("%*s│", CELL_WIDTH, "");
-    printf("\n");
-    print_border("└","┴","┘");
+    for (int i = last_day_weekday; i < 6; i++) sink_printf(out, "%*s│", CELL_WIDTH, "");
+    sink_printf(out, "\n");
+    print_border(out, "└","┴","┘");
 
     if (month_days == 29) {
-        printf("\n        ◎ XXX  DIVERTOMU  (virtual 30th day)\n");
+        sink_printf(out, "\n        ◎ XXX  DIVERTOMU  (virtual 30th day)\n");
     }
 
-    print_coligny_tablet(month_index, today_day, mat, jd_start);
+    print_coligny_tablet(out, month_index, today_day, mat, jd_start);
+    sink_end_line(out);
+    PROFILE_END(PROF_RENDER_MONTH);
 }
 
-void print_celtic_month_lunar(int month_index, long jd_start, long jd_celtic, long jd_actual, int month_days, int after_sunset)
+void render_celtic_month_lunar(RenderSink *out, int month_index, long jd_start, long jd_celtic, long jd_actual,
+                               int month_days, int after_sunset)
 {
+    PROFILE_BEGIN(PROF_RENDER_MONTH);
     int today_day_raw = (int)(jd_celtic - jd_start) + 1;
     int in_month = (today_day_raw >= 1 && today_day_raw <= month_days);
     int today_day = in_month ? today_day_raw : 0; /* use 0 to keep the panel present even when outside */
@@ -518,19 +629,19 @@ void print_celtic_month_lunar(int month_index, long jd_start, long jd_celtic, lo
 
     (void)after_sunset; /* unused in condensed today panel */
 
-    info_border("┌", "┐");
+    info_border(out, "┌", "┐");
     snprintf(line, sizeof(line), "  %-12s (%s)",
              get_celtic_month_name(month_index),
              get_month_abbrev(month_index));
-    info_line(line);
+    info_line(out, line);
     snprintf(line, sizeof(line), "  %-36s - %2d days",
              mat ? "Matis (lucky/complete month)" : "Anmatu (unlucky/incomplete month)",
              month_days);
-    info_line(line);
-    info_border("└", "┘");
+    info_line(out, line);
+    info_border(out, "└", "┘");
 
     if (in_month) {
-        info_border("┌", "┐");
+        info_border(out, "┌", "┐");
            snprintf(line, sizeof(line), "  Today: Day %2d (%s) - %s%s (%s) - ☉ Sun %s (%s)",
                today_day,
                weekday_glyphs[celtic_weekday],
@@ -539,77 +650,542 @@ void print_celtic_month_lunar(int month_index, long jd_start, long jd_celtic, lo
                zodiac_names[today_moon_zodiac],
                zodiac_glyphs[today_sun_zodiac],
                zodiac_names[today_sun_zodiac]);
-        info_line(line);
-        if (today_day > 15) info_line("  ═══ ATENOUX (Second Coicise) ═══");
-        else               info_line("  ═══ First Coicise ═══");
-        info_border("└", "┘");
+        info_line(out, line);
+        if (today_day > 15) info_line(out, "  ═══ ATENOUX (Second Coicise) ═══");
+        else               info_line(out, "  ═══ First Coicise ═══");
+        info_border(out, "└", "┘");
     }
 
-    info_border("┌", "┐");
+    info_border(out, "┌", "┐");
     int has_festival = 0;
     for (int f = 0; f < FESTIVAL_COUNT; f++) {
         if (festivals[f].month == month_index) {
             snprintf(line, sizeof(line), "  IVOS: %-33s Day %2d", festivals[f].name, festivals[f].day);
-            info_line(line);
+            info_line(out, line);
             has_festival = 1;
         }
     }
-    SolarEvent solar_events[8];
-    int se_count = collect_solar_events(jd_start, month_days, solar_events, 8);
-    for (int i = 0; i < se_count; i++) {
-        int celtic_day = solar_events[i].offset + 1;
-        int solilunar = (strstr(solar_events[i].name, "Imbolc") != NULL) &&
-                        is_solilunar_alignment(jd_start, solar_events[i].offset);
-        if (solilunar) {
+    for (int id = MULTI_FESTIVAL_COUNT; id < multi_festival_total(); id++) {
+        const MultiFestival *mf = multi_festival_by_id(id);
+        if (mf->month == month_index) {
+            snprintf(line, sizeof(line), "  IVOS: %-33s Day %2d", mf->name, mf->start_day);
+            info_line(out, line);
+            has_festival = 1;
+        }
+    }
+    MonthEphemeris eph;
+    CelticCursor cur;
+    cursor_init(&cur, jd_start);
+    month_ephemeris_fill(&eph, month_index, &cur, month_days, NULL);
+    for (int i = 0; i < eph.event_count; i++) {
+        const SolarEvent *se = &eph.events[i];
+        int celtic_day = se->offset + 1;
+        if (se->solilunar) {
             snprintf(line, sizeof(line), "  IVOS: %-20s %s Day %2d [solilunar]",
-                     solar_events[i].name, get_celtic_month_name(month_index), celtic_day);
+                     se->name, get_celtic_month_name(month_index), celtic_day);
         } else {
             snprintf(line, sizeof(line), "  IVOS: %-20s %s Day %2d",
-                     solar_events[i].name, get_celtic_month_name(month_index), celtic_day);
+                     se->name, get_celtic_month_name(month_index), celtic_day);
         }
-        info_line(line);
+        info_line(out, line);
         has_festival = 1;
     }
-    if (!has_festival) info_line("  (No major festivals this month)");
-    info_border("└", "┘");
-    printf("\n");
-
-    print_border("┌","┬","┐");
-    grid_span_center("FIRST COICISE (Days I - XV)");
-    grid_span_center("🌕 Full Moon → 🌑 New Moon");
-    print_border("├","┼","┤");
-    print_week_header();
-    print_border("├","┼","┤");
-
-    print_grid_half(month_index, jd_start, 1, 15, today_day);
+    if (!has_festival) info_line(out, "  (No major festivals this month)");
+    info_border(out, "└", "┘");
+    sink_printf(out, "\n");
+
+    print_border(out, "┌","┬","┐");
+    grid_span_center(out, "FIRST COICISE (Days I - XV)");
+    grid_span_center(out, "🌕 Full Moon → 🌑 New Moon");
+    print_border(out, "├","┼","┤");
+    print_week_header(out);
+    print_border(out, "├","┼","┤");
+
+    print_grid_half(out, month_index, jd_start, 1, 15, today_day, &eph);
     int last_weekday_first = (int)((jd_start + 15) % 7);
-    for (int i = last_weekday_first; i < 6; i++) printf("%*s│", CELL_WIDTH, "");
-    printf("\n");
-    print_border("└","┴","┘");
-    printf("\n");
+    for (int i = last_weekday_first; i < 6; i++) sink_printf(out, "%*s│", CELL_WIDTH, "");
+    sink_printf(out, "\n");
+    print_border(out, "└","┴","┘");
+    sink_printf(out, "\n");
 
-    printf("        ════════ ATENOUX (🌑) ════════\n");
-    printf("           \"Returning Night\"\n\n");
+    sink_printf(out, "        ════════ ATENOUX (🌑) ════════\n");
+    sink_printf(out, "           \"Returning Night\"\n\n");
 
-    print_border("┌","┬","┐");
+    print_border(out, "┌","┬","┐");
     if (month_days == 30)
-        grid_span_center("SECOND COICISE (Days XVI - XXX)");
+        grid_span_center(out, "SECOND COICISE (Days XVI - XXX)");
     else
-        grid_span_center("SECOND COICISE (Days XVI - XXIX)");
-    grid_span_center("🌑 New Moon → 🌕 Full Moon");
-    print_border("├","┼","┤");
-    print_week_header();
-    print_border("├","┼","┤");
+        grid_span_center(out, "SECOND COICISE (Days XVI - XXIX)");
+    grid_span_center(out, "🌑 New Moon → 🌕 Full Moon");
+    print_border(out, "├","┼","┤");
+    print_week_header(out);
+    print_border(out, "├","┼","┤");
 
-    print_grid_half(month_index, jd_start, 16, month_days, today_day);
+    print_grid_half(out, month_index, jd_start, 16, month_days, today_day, &eph);
     int last_day_weekday = (int)((jd_start + month_days) % 7);
-    for (int i = last_day_weekday; i < 6; i++) printf("%*s│", CELL_WIDTH, "");
-    printf("\n");
-    print_border("└","┴","┘");
+    for (int i = last_day_weekday; i < 6; i++) sink_printf(out, "%*s│", CELL_WIDTH, "");
+    sink_printf(out, "\n");
+    print_border(out, "└","┴","┘");
 
-    if (month_days == 29) printf("\n        ◎ XXX  DIVERTOMU  (virtual 30th day)\n");
+    if (month_days == 29) sink_printf(out, "\n        ◎ XXX  DIVERTOMU  (virtual 30th day)\n");
 
     if (in_month) {
-        print_coligny_tablet(month_index, today_day, mat, jd_start);
+        print_coligny_tablet(out, month_index, today_day, mat, jd_start);
     }
+    sink_end_line(out);
+    PROFILE_END(PROF_RENDER_MONTH);
+}
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════════
+ * YEAR SHEETS
+ * Every lunar month of a year as a compact block, SHEET_BLOCK_WIDTH columns
+ * wide, laid out side by side. The calling thread resolves lunar years,
+ * event years, phases and festival flags; workers only format blocks into
+ * their own sinks, which are then joined row by row in month order.
+ * ═══════════════════════════════════════════════════════════════════════════
+ */
+#define SHEET_CELL_WIDTH 7
+#define SHEET_CELLS_PER_ROW 5
+#define SHEET_BLOCK_INNER (SHEET_CELL_WIDTH * SHEET_CELLS_PER_ROW)
+#define SHEET_BLOCK_WIDTH (SHEET_BLOCK_INNER + 2)
+#define SHEET_GUTTER 2
+#define SHEET_BLOCK_FIXED_LINES 13   /* Borders, header, both coicise grids */
+#define SHEET_MAX_THREADS 64
+#define METONIC_CYCLE_YEARS 19
+
+typedef struct {
+    int month_index;
+    long jd_start;
+    int month_days;
+    int today_day;        /* 0 when today falls outside the month */
+    int height;           /* Lines, padded to the tallest block of its row */
+    MonthEphemeris eph;
+    RenderSink sink;
+} SheetMonth;
+
+typedef struct {
+    int samhain_year;
+    LunarYear lunar;
+    EventYear events;
+    SheetMonth *months;
+} SheetYear;
+
+static void format_iso_date(long jd, char *buf, size_t size)
+{
+    int y, m, d;
+    ymd_from_jd(jd, &y, &m, &d);
+    snprintf(buf, size, "%04d-%02d-%02d", y, m, d);
+}
+
+/* Longest prefix of text, cut on a character boundary, that fits in width columns */
+static size_t fit_prefix(const char *text, int width)
+{
+    size_t n = strlen(text);
+    while (n > 0 && text_display_width_n(text, n) > width) {
+        n--;
+        while (n > 0 && ((unsigned char)text[n] & 0xC0) == 0x80) n--;
+    }
+    return n;
+}
+
+/* "│text   │" padded or clipped to the block's inner width */
+static void block_line(RenderSink *out, const char *text)
+{
+    size_t n = fit_prefix(text, SHEET_BLOCK_INNER);
+    int pad = SHEET_BLOCK_INNER - text_display_width_n(text, n);
+    sink_puts(out, "│");
+    sink_write(out, text, n);
+    for (int i = 0; i < pad; i++) sink_putc(out, ' ');
+    sink_puts(out, "│\n");
+}
+
+static void block_rule(RenderSink *out, const char *left, const char *right)
+{
+    sink_puts(out, left);
+    for (int i = 0; i < SHEET_BLOCK_INNER; i++) sink_puts(out, "─");
+    sink_puts(out, right);
+    sink_putc(out, '\n');
+}
+
+static void block_cells(RenderSink *out, const SheetMonth *m, const unsigned char *attrs, int first, int last)
+{
+    for (int row = first; row <= last; row += SHEET_CELLS_PER_ROW) {
+        sink_puts(out, "│");
+        int used = 0;
+        for (int day = row; day <= last && day < row + SHEET_CELLS_PER_ROW; day++) {
+            const char *status = status_glyph(m->eph.festival[day - 1], day_marker(attrs[day]));
+            const char *moon = moon_symbols[m->eph.phase[day - 1]];
+            char cell[32];
+            if (day == m->today_day) snprintf(cell, sizeof(cell), "[%2d%s%s]", day, moon, status);
+            else                     snprintf(cell, sizeof(cell), " %2d%s%s ", day, moon, status);
+            int w = text_display_width(cell);
+            sink_puts(out, cell);
+            for (int i = w; i < SHEET_CELL_WIDTH; i++) sink_putc(out, ' ');
+            used += (w > SHEET_CELL_WIDTH) ? w : SHEET_CELL_WIDTH;
+        }
+        for (int i = used; i < SHEET_BLOCK_INNER; i++) sink_putc(out, ' ');
+        sink_puts(out, "│\n");
+    }
+}
+
+/* Festival and quarter-day notes under a block; the count is fixed before rendering */
+static int sheet_note_count(const SheetMonth *m)
+{
+    int n = m->eph.event_count;
+    for (int f = 0; f < FESTIVAL_COUNT; f++) {
+        if (festivals[f].month == m->month_index) n++;
+    }
+    for (int id = MULTI_FESTIVAL_COUNT; id < multi_festival_total(); id++) {
+        if (multi_festival_by_id(id)->month == m->month_index) n++;
+    }
+    return n ? n : 1;
+}
+
+static void render_sheet_month(SheetMonth *m)
+{
+    RenderSink *out = &m->sink;
+    const unsigned char *attrs = coligny_day_attr[coligny_row(m->month_index)];
+    char line[160], from[24], to[24];
+    int notes = 0;
+
+    block_rule(out, "┌", "┐");
+    snprintf(line, sizeof(line), " %-13s %s  %s · %2d days", get_celtic_month_name(m->month_index),
+             get_month_abbrev(m->month_index), m->month_days == 30 ? "MAT" : "ANM", m->month_days);
+    block_line(out, line);
+    format_iso_date(m->jd_start, from, sizeof(from));
+    format_iso_date(m->jd_start + m->month_days - 1, to, sizeof(to));
+    snprintf(line, sizeof(line), " %s → %s", from, to);
+    block_line(out, line);
+    block_rule(out, "├", "┤");
+
+    block_cells(out, m, attrs, 1, 15);
+    block_line(out, "  ─ ─ ─ ─ ─  ATENOUX 🌑  ─ ─ ─ ─ ─");
+    block_cells(out, m, attrs, 16, m->month_days);
+    block_rule(out, "├", "┤");
+
+    for (int f = 0; f < FESTIVAL_COUNT; f++) {
+        if (festivals[f].month != m->month_index) continue;
+        snprintf(line, sizeof(line), " IVOS %-22s day %2d", festivals[f].name, festivals[f].day);
+        block_line(out, line);
+        notes++;
+    }
+    for (int id = MULTI_FESTIVAL_COUNT; id < multi_festival_total(); id++) {
+        const MultiFestival *mf = multi_festival_by_id(id);
+        if (mf->month != m->month_index) continue;
+        snprintf(line, sizeof(line), " IVOS %-22s day %2d", mf->name, mf->start_day);
+        block_line(out, line);
+        notes++;
+    }
+    for (int i = 0; i < m->eph.event_count; i++) {
+        const SolarEvent *se = &m->eph.events[i];
+        if (se->rule) {
+            snprintf(line, sizeof(line), " IVOS %-22s day %2d", se->name, se->offset + 1);
+        } else {
+            snprintf(line, sizeof(line), " ☉ %-18s day %2d%s", se->name, se->offset + 1,
+                     se->solilunar ? " ☽" : "");
+        }
+        block_line(out, line);
+        notes++;
+    }
+    if (!notes) {
+        block_line(out, " (no festivals)");
+        notes = 1;
+    }
+
+    for (int i = SHEET_BLOCK_FIXED_LINES + notes; i < m->height; i++) block_line(out, "");
+    block_rule(out, "└", "┘");
+    sink_end_line(out);
+    PROFILE_COUNT(PROF_RENDER_MONTH);
+}
+
+/* Months are claimed one at a time; the calling thread works alongside */
+typedef struct {
+    SheetMonth **months;
+    int count;
+    int next;
+    pthread_mutex_t lock;
+} SheetJob;
+
+static void *sheet_worker(void *arg)
+{
+    SheetJob *job = arg;
+    for (;;) {
+        pthread_mutex_lock(&job->lock);
+        int i = job->next++;
+        pthread_mutex_unlock(&job->lock);
+        if (i >= job->count) return NULL;
+        render_sheet_month(job->months[i]);
+    }
+}
+
+static void render_sheet_months(SheetMonth **months, int count, int threads)
+{
+    SheetJob job = {months, count, 0, PTHREAD_MUTEX_INITIALIZER};
+    pthread_t workers[SHEET_MAX_THREADS];
+    int started = 0;
+
+    if (threads > count) threads = count;
+    if (threads > SHEET_MAX_THREADS) threads = SHEET_MAX_THREADS;
+    while (started < threads - 1 && pthread_create(&workers[started], NULL, sheet_worker, &job) == 0) {
+        started++;
+    }
+    sheet_worker(&job);
+    for (int i = 0; i < started; i++) pthread_join(workers[i], NULL);
+    pthread_mutex_destroy(&job.lock);
+}
+
+/* Lunar year, event year and month blocks of one year, ready to format */
+static void sheet_year_resolve(SheetYear *y, int samhain_year, long jd_today)
+{
+    y->samhain_year = samhain_year;
+    y->lunar = *lunar_year(samhain_year);
+    y->events = *event_year(samhain_year);
+
+    /* One span evaluation for the phases of the whole year */
+    long jd_first = y->lunar.full_moons[0];
+    int total = (int)(y->lunar.full_moons[y->lunar.months] - jd_first);
+    int *phases = malloc(sizeof(int) * (size_t)(total > 0 ? total : 1));
+    if (phases) ephemeris_span(jd_first, total, phases, NULL, NULL);
+
+    /* One cursor walks the whole year; the months follow on from each other */
+    CelticCursor cur;
+    cursor_init(&cur, jd_first);
+    for (int k = 0; k < y->lunar.months; k++) {
+        SheetMonth *m = &y->months[k];
+        m->jd_start = y->lunar.full_moons[k];
+        m->month_days = (int)(y->lunar.full_moons[k + 1] - m->jd_start);
+        if (m->month_days > MONTH_MAX_DAYS) m->month_days = MONTH_MAX_DAYS;
+        m->month_index = (k > 11) ? -1 : (k + 6) % 12;   /* As lunar_celtic_month_index() */
+        m->today_day = (jd_today >= m->jd_start && jd_today < m->jd_start + m->month_days)
+                     ? (int)(jd_today - m->jd_start) + 1 : 0;
+        cursor_seek(&cur, m->jd_start);
+        month_ephemeris_fill(&m->eph, m->month_index, &cur, m->month_days,
+                             phases ? phases + (m->jd_start - jd_first) : NULL);
+        render_sink_init(&m->sink);
+    }
+    free(phases);
+}
+
+static void sheet_rows_heights(SheetYear *y, int columns)
+{
+    for (int first = 0; first < y->lunar.months; first += columns) {
+        int last = first + columns < y->lunar.months ? first + columns : y->lunar.months;
+        int height = 0;
+        for (int k = first; k < last; k++) {
+            int h = SHEET_BLOCK_FIXED_LINES + sheet_note_count(&y->months[k]);
+            if (h > height) height = h;
+        }
+        for (int k = first; k < last; k++) y->months[k].height = height;
+    }
+}
+
+/* Double-ruled box around items flowed onto as few lines as fit 'width' */
+static void sheet_banner(RenderSink *out, const char *const *items, int count, int width)
+{
+    int inner = width - 4;
+    sink_puts(out, "╔");
+    for (int i = 0; i < width - 2; i++) sink_puts(out, "═");
+    sink_puts(out, "╗\n");
+
+    int i = 0;
+    while (i < count) {
+        char line[512];
+        size_t len = 0;
+        int used = 0;
+        line[0] = '\0';
+        do {
+            int w = text_display_width(items[i]);
+            int sep = len ? 3 : 0;   /* " · " */
+            if (len && used + sep + w > inner) break;
+            len += (size_t)snprintf(line + len, sizeof(line) - len, "%s%s", len ? " · " : "", items[i]);
+            if (len >= sizeof(line)) len = sizeof(line) - 1;
+            used += sep + w;
+            i++;
+        } while (i < count);
+
+        size_t n = fit_prefix(line, inner);
+        int pad = inner - text_display_width_n(line, n);
+        sink_puts(out, "║ ");
+        sink_write(out, line, n);
+        for (int p = 0; p < pad; p++) sink_putc(out, ' ');
+        sink_puts(out, " ║\n");
+    }
+
+    sink_puts(out, "╚");
+    for (int i2 = 0; i2 < width - 2; i2++) sink_puts(out, "═");
+    sink_puts(out, "╝\n");
+}
+
+static void sheet_year_banner(RenderSink *out, const SheetYear *y, int width)
+{
+    static const char *solar_names[8] = {
+        "Samhain", "Yule", "Imbolc", "Ostara", "Beltane", "Litha", "Lughnasadh", "Mabon"
+    };
+    char text[12][64];
+    const char *items[12];
+    int count = 0;
+    char date[24];
+
+    long samonios = y->lunar.full_moons[0];
+    snprintf(text[count++], sizeof(text[0]), "CELTIC YEAR %d",
+             celtic_year_from_jd(lround(y->events.solar[0]) + 1));
+    format_iso_date(samonios, date, sizeof(date));
+    snprintf(text[count++], sizeof(text[0]), "Samonios %s", date);
+    snprintf(text[count++], sizeof(text[0]), "%d lunations%s", y->lunar.months,
+             y->lunar.months > 12 ? " with Quimonios" : "");
+    snprintf(text[count++], sizeof(text[0]), "Metonic year %d/19", metonic_year(samonios));
+    for (int s8 = 0; s8 < 8; s8++) {
+        format_iso_date(lround(y->events.solar[s8]), date, sizeof(date));
+        snprintf(text[count++], sizeof(text[0]), "%s %s", solar_names[s8], date);
+    }
+    for (int i = 0; i < count; i++) items[i] = text[i];
+    sheet_banner(out, items, count, width);
+}
+
+/* Join blocks row by row: line r of every block in the row, gutters between */
+static void sheet_join(RenderSink *out, const SheetYear *y, int columns)
+{
+    for (int first = 0; first < y->lunar.months; first += columns) {
+        int last = first + columns < y->lunar.months ? first + columns : y->lunar.months;
+        int height = y->months[first].height;
+        for (int r = 0; r < height; r++) {
+            for (int k = first; k < last; k++) {
+                const RenderSink *b = &y->months[k].sink;
+                size_t len = 0;
+                const char *text = render_sink_line(b, r, &len);
+                int w = text ? b->lines[r].width : 0;
+                if (k > first) for (int i = 0; i < SHEET_GUTTER; i++) sink_putc(out, ' ');
+                if (text) sink_write(out, text, len);
+                if (k + 1 < last) for (int i = w; i < SHEET_BLOCK_WIDTH; i++) sink_putc(out, ' ');
+                if (b->failed) out->failed = 1;
+            }
+            sink_putc(out, '\n');
+        }
+    }
+}
+
+static void sheet_legend(RenderSink *out, int width)
+{
+    static const char *items[] = {
+        "* M D auspicious", "! D AMB inauspicious", "☆ ⚐ ⚠ IVOS festival",
+        "[ ] today", "☉ quarter day", "☽ solilunar", "🌕 → 🌑 first coicise",
+    };
+    sheet_banner(out, items, (int)(sizeof(items) / sizeof(items[0])), width);
+}
+
+int celtic_sheet_columns(int width)
+{
+    int columns = (width + SHEET_GUTTER) / (SHEET_BLOCK_WIDTH + SHEET_GUTTER);
+    return columns < 1 ? 1 : columns;
+}
+
+static void render_sheet(RenderSink *out, int first_year, int year_count, long jd_today,
+                         int columns, int threads, int metonic)
+{
+    if (columns < 1) columns = 1;
+    int width = columns * SHEET_BLOCK_WIDTH + (columns - 1) * SHEET_GUTTER;
+
+    /* setlocale() must not race the workers' formatting */
+    text_layout_init();
+
+    SheetYear *years = calloc((size_t)year_count, sizeof(SheetYear));
+    SheetMonth *months = calloc((size_t)year_count * LUNAR_YEAR_SLOTS, sizeof(SheetMonth));
+    SheetMonth **jobs = malloc(sizeof(SheetMonth *) * (size_t)year_count * LUNAR_YEAR_SLOTS);
+    if (!years || !months || !jobs) {
+        out->failed = 1;
+        free(years);
+        free(months);
+        free(jobs);
+        return;
+    }
+
+    int job_count = 0;
+    for (int i = 0; i < year_count; i++) {
+        years[i].months = months + (size_t)i * LUNAR_YEAR_SLOTS;
+        sheet_year_resolve(&years[i], first_year + i, jd_today);
+        sheet_rows_heights(&years[i], columns);
+        for (int k = 0; k < years[i].lunar.months; k++) jobs[job_count++] = &years[i].months[k];
+    }
+
+    render_sheet_months(jobs, job_count, threads);
+
+    if (metonic) {
+        char text[3][64];
+        const char *items[3] = {text[0], text[1], text[2]};
+        long start = years[0].lunar.full_moons[0];
+        int lunations = 0;
+        for (int i = 0; i < year_count; i++) lunations += years[i].lunar.months;
+        snprintf(text[0], sizeof(text[0]), "METONIC CYCLE %d", metonic_cycle_number(start));
+        snprintf(text[1], sizeof(text[1]), "Samhain years %d-%d", first_year, first_year + year_count - 1);
+        snprintf(text[2], sizeof(text[2]), "%d lunations", lunations);
+        sheet_banner(out, items, 3, width);
+        sink_putc(out, '\n');
+    }
+    for (int i = 0; i < year_count; i++) {
+        sheet_year_banner(out, &years[i], width);
+        sheet_join(out, &years[i], columns);
+        sink_putc(out, '\n');
+    }
+    sheet_legend(out, width);
+    sink_end_line(out);
+
+    for (int i = 0; i < job_count; i++) render_sink_free(&jobs[i]->sink);
+    free(jobs);
+    free(months);
+    free(years);
+}
+
+void render_celtic_year(RenderSink *out, int samhain_year, long jd_today, int columns, int threads)
+{
+    render_sheet(out, samhain_year, 1, jd_today, columns, threads, 0);
+}
+
+int metonic_first_year(int samhain_year)
+{
+    return samhain_year - (metonic_year(lunar_year(samhain_year)->full_moons[0]) - 1);
+}
+
+void render_metonic_sheet(RenderSink *out, int samhain_year, long jd_today, int columns, int threads)
+{
+    render_sheet(out, metonic_first_year(samhain_year), METONIC_CYCLE_YEARS, jd_today, columns, threads, 1);
+}
+
+/* stdout front ends for the CLI */
+static void print_sink(RenderSink *out)
+{
+    if (out->len) fwrite(out->buf, 1, out->len, stdout);
+    render_sink_free(out);
+}
+
+void print_celtic_month(int month_index, long jd_start, long jd_today)
+{
+    RenderSink out;
+    render_sink_init(&out);
+    render_celtic_month(&out, month_index, jd_start, jd_today);
+    print_sink(&out);
+}
+
+void print_celtic_month_lunar(int month_index, long jd_start, long jd_celtic, long jd_actual, int month_days, int after_sunset)
+{
+    RenderSink out;
+    render_sink_init(&out);
+    render_celtic_month_lunar(&out, month_index, jd_start, jd_celtic, jd_actual, month_days, after_sunset);
+    print_sink(&out);
+}
+
+void print_celtic_year(int samhain_year, long jd_today, int columns, int threads)
+{
+    RenderSink out;
+    render_sink_init(&out);
+    render_celtic_year(&out, samhain_year, jd_today, columns, threads);
+    print_sink(&out);
+}
+
+void print_metonic_sheet(int samhain_year, long jd_today, int columns, int threads)
+{
+    RenderSink out;
+    render_sink_init(&out);
+    render_metonic_sheet(&out, samhain_year, jd_today, columns, threads);
+    print_sink(&out);
 }
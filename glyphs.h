@@ -1,13 +1,66 @@
 #ifndef GLYPHS_H
 #define GLYPHS_H
 
+#include <stddef.h>
 #include "calendar.h"
 #include "astronomy.h"
 
+/*
+ * Render sink: a caller-owned growable text buffer. Renderers append to it
+ * and every completed line is indexed with its byte range and display width.
+ * Reset (not free) between frames to reuse the storage.
+ */
+typedef struct {
+    size_t offset;   /* Start of the line in buf */
+    size_t length;   /* Bytes, excluding the '\n' */
+    int width;       /* Terminal columns */
+} RenderLine;
+
+typedef struct {
+    char *buf;           /* All rendered text, NUL-terminated */
+    size_t len;
+    size_t cap;
+    size_t line_begin;   /* Start of the line being written */
+    RenderLine *lines;
+    int line_count;
+    int line_cap;
+    int max_width;       /* Widest line so far */
+    int failed;          /* Set when an allocation failed; output is truncated */
+} RenderSink;
+
+void render_sink_init(RenderSink *s);
+void render_sink_reset(RenderSink *s);
+void render_sink_free(RenderSink *s);
+const char *render_sink_line(const RenderSink *s, int index, size_t *length);
+
+/* Render into a sink; these write nothing to stdout */
+void render_celtic_month(RenderSink *out, int month_index, long jd_start, long jd_today);
+void render_celtic_month_lunar(RenderSink *out, int month_index, long jd_start, long jd_celtic, long jd_actual,
+                               int month_days, int after_sunset);
+
+/*
+ * Year-at-a-glance sheets in compact month blocks, 'columns' blocks across
+ * (celtic_sheet_columns() fits a terminal width). The year sheet covers
+ * the lunar year from the Samonios of samhain_year; the Metonic sheet the
+ * 19 years of the cycle containing it. Astronomy is resolved once on the
+ * calling thread, then up to 'threads' threads format the months into
+ * separate sinks that are joined in order. jd_today (a Celtic day) is
+ * bracketed wherever it appears. Festivals must not be registered while
+ * a sheet renders.
+ */
+void render_celtic_year(RenderSink *out, int samhain_year, long jd_today, int columns, int threads);
+void render_metonic_sheet(RenderSink *out, int samhain_year, long jd_today, int columns, int threads);
+int celtic_sheet_columns(int width);
+int metonic_first_year(int samhain_year);   /* Samhain year opening the cycle */
+
 /* Print a Celtic month with festivals, moon phases, and zodiac signs */
 void print_celtic_month(int month_index, long jd_start, long jd_today);
 
 /* Print a lunar-synced Celtic month (starts at full moon) */
 void print_celtic_month_lunar(int month_index, long jd_start, long jd_celtic, long jd_actual, int month_days, int after_sunset);
 
+/* Print year and Metonic sheets */
+void print_celtic_year(int samhain_year, long jd_today, int columns, int threads);
+void print_metonic_sheet(int samhain_year, long jd_today, int columns, int threads);
+
 #endif
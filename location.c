@@ -0,0 +1,299 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+#include <limits.h>
+#include <pthread.h>
+#include "location.h"
+#include "astronomy.h"
+#include "calendar.h"
+
+#define UNIX_EPOCH_JD 2440588L      /* Noon JD of 1970-01-01 */
+#define SECONDS_PER_DAY 86400LL
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════════
+ * SUNSET BLOCKS
+ * Daily sunsets for SUNSET_BLOCK_DAYS consecutive days at one location,
+ * cached direct-mapped by (location, block). Days fill on first use (the
+ * filled bitmap marks which), so scattered queries pay one evaluation and
+ * repeated ones a load. The table is per thread,
+ * allocated on first use and freed when the thread exits; if it cannot be
+ * allocated every query computes directly.
+ * ═══════════════════════════════════════════════════════════════════════════
+ */
+#define SUNSET_BLOCK_DAYS 366
+#define SUNSET_CACHE_SLOTS 64       /* Power of two */
+
+typedef struct {
+    int valid;
+    CelticLocation loc;
+    long block;
+    uint64_t filled[(SUNSET_BLOCK_DAYS + 63) / 64];
+    double sunset[SUNSET_BLOCK_DAYS];
+} SunsetBlock;
+
+static _Thread_local SunsetBlock *sunset_cache;
+static _Thread_local SunsetBlock *sunset_last;   /* Most recent hit */
+
+static pthread_key_t sunset_key;
+static pthread_once_t sunset_key_once = PTHREAD_ONCE_INIT;
+
+static void create_sunset_key(void)
+{
+    pthread_key_create(&sunset_key, free);
+}
+
+static SunsetBlock *thread_sunset_cache(void)
+{
+    if (!sunset_cache) {
+        sunset_cache = calloc(SUNSET_CACHE_SLOTS, sizeof(SunsetBlock));
+        if (sunset_cache) {
+            pthread_once(&sunset_key_once, create_sunset_key);
+            pthread_setspecific(sunset_key, sunset_cache);
+        }
+    }
+    return sunset_cache;
+}
+
+static int location_equal(const CelticLocation *a, const CelticLocation *b)
+{
+    return a->latitude == b->latitude && a->longitude == b->longitude &&
+           a->tz_offset == b->tz_offset && a->solar_time == b->solar_time;
+}
+
+static uint64_t double_bits(double x)
+{
+    uint64_t u;
+    memcpy(&u, &x, sizeof(u));
+    return u;
+}
+
+static unsigned sunset_slot(const CelticLocation *loc, long block)
+{
+    uint64_t h = double_bits(loc->latitude) * 0x9E3779B97F4A7C15ull;
+    h ^= double_bits(loc->longitude) + 0x632BE59BD9B4E019ull + (h << 6) + (h >> 2);
+    h ^= double_bits(loc->tz_offset) + (uint64_t)loc->solar_time + (h << 6) + (h >> 2);
+    h ^= (uint64_t)block * 0xBF58476D1CE4E5B9ull;
+    return (unsigned)(h >> 32) & (SUNSET_CACHE_SLOTS - 1);
+}
+
+static long floor_div(long a, long b)
+{
+    long q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+static double compute_sunset(const CelticLocation *loc, long jd)
+{
+    if (loc->solar_time) return calculate_sunset(jd, loc->latitude);
+    return calculate_sunset_clock(jd, loc->latitude, loc->longitude, loc->tz_offset);
+}
+
+static SunsetBlock *sunset_block(const CelticLocation *loc, long block)
+{
+    SunsetBlock *last = sunset_last;
+    if (last && last->block == block && location_equal(&last->loc, loc)) return last;
+
+    SunsetBlock *table = thread_sunset_cache();
+    if (!table) return NULL;
+
+    SunsetBlock *b = &table[sunset_slot(loc, block)];
+    if (!b->valid || b->block != block || !location_equal(&b->loc, loc)) {
+        memset(b->filled, 0, sizeof(b->filled));
+        b->loc = *loc;
+        b->block = block;
+        b->valid = 1;
+    }
+    sunset_last = b;
+    return b;
+}
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════════
+ * LOCATIONS
+ * ═══════════════════════════════════════════════════════════════════════════
+ */
+CelticLocation location_make(double latitude, double longitude, double tz_offset)
+{
+    CelticLocation loc = {latitude, longitude, tz_offset, 0};
+    return loc;
+}
+
+int location_parse(const char *text, CelticLocation *out)
+{
+    double lat, lon, tz = 0.0;
+    char tail;
+    int n = sscanf(text, "%lf,%lf,%lf%c", &lat, &lon, &tz, &tail);
+    if (n != 2 && n != 3) return -1;
+    if (lat < -90.0 || lat > 90.0 || lon < -180.0 || lon > 180.0 || tz < -14.0 || tz > 14.0) return -1;
+    *out = location_make(lat, lon, tz);
+    return 0;
+}
+
+void location_label(const CelticLocation *loc, char *buffer, size_t size)
+{
+    char zone[24];
+    if (loc->solar_time) {
+        snprintf(zone, sizeof(zone), "solar time");
+    } else {
+        int minutes = (int)lround(fabs(loc->tz_offset) * 60.0);
+        if (minutes % 60) snprintf(zone, sizeof(zone), "UTC%c%d:%02d", loc->tz_offset < 0 ? '-' : '+', minutes / 60, minutes % 60);
+        else snprintf(zone, sizeof(zone), "UTC%c%d", loc->tz_offset < 0 ? '-' : '+', minutes / 60);
+    }
+    snprintf(buffer, size, "%.2f°%c %.2f°%c, %s",
+             fabs(loc->latitude), loc->latitude < 0 ? 'S' : 'N',
+             fabs(loc->longitude), loc->longitude < 0 ? 'W' : 'E', zone);
+}
+
+double location_sunset(const CelticLocation *loc, long jd)
+{
+    long block = floor_div(jd, SUNSET_BLOCK_DAYS);
+    SunsetBlock *b = sunset_block(loc, block);
+    if (!b) return compute_sunset(loc, jd);
+
+    long day = jd - block * SUNSET_BLOCK_DAYS;
+    uint64_t bit = 1ull << (day & 63);
+    if (!(b->filled[day >> 6] & bit)) {
+        b->sunset[day] = compute_sunset(loc, jd);
+        b->filled[day >> 6] |= bit;
+    }
+    return b->sunset[day];
+}
+
+void location_sunset_str(const CelticLocation *loc, long jd, char *buffer, int buf_size)
+{
+    double hours = location_sunset(loc, jd);
+    int h = (int)hours;
+    int m = (int)((hours - h) * 60.0);
+    snprintf(buffer, buf_size, "%02d:%02d", h, m);
+}
+
+int location_is_after_sunset(const CelticLocation *loc, long jd, double hour)
+{
+    return (hour >= location_sunset(loc, jd)) ? 1 : 0;
+}
+
+long location_celtic_jd(const CelticLocation *loc, long jd, double hour)
+{
+    return location_is_after_sunset(loc, jd, hour) ? jd + 1 : jd;
+}
+
+void location_local_time(const CelticLocation *loc, time_t t, long *jd, double *hour)
+{
+    /* Solar time runs ahead of UTC by the longitude; clock time by the zone */
+    double offset_hours = loc->solar_time ? loc->longitude / 15.0 : loc->tz_offset;
+    long long secs = (long long)t + llround(offset_hours * 3600.0);
+
+    long long days = secs / SECONDS_PER_DAY;
+    long long rem = secs % SECONDS_PER_DAY;
+    if (rem < 0) {
+        rem += SECONDS_PER_DAY;
+        days--;
+    }
+    *jd = UNIX_EPOCH_JD + (long)days;
+    *hour = (double)rem / 3600.0;
+}
+
+long location_celtic_jd_at(const CelticLocation *loc, time_t t)
+{
+    long jd;
+    double hour;
+    location_local_time(loc, t, &jd, &hour);
+    return location_celtic_jd(loc, jd, hour);
+}
+
+void location_celtic_days(const CelticLocation *sites, size_t site_count,
+                          const time_t *times, size_t n, long *out)
+{
+    for (size_t s = 0; s < site_count; s++) {
+        long *row = out + s * n;
+        for (size_t i = 0; i < n; i++) row[i] = location_celtic_jd_at(&sites[s], times[i]);
+    }
+}
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════════
+ * PACKED BATCHES
+ * Per civil day: the first second of the evening (the first local second
+ * whose hour compares >= the sunset, so results match location_celtic_jd())
+ * and the packed day on either side of it. Recent days sit in a small
+ * direct-mapped table; sorted input almost always hits the last one.
+ * ═══════════════════════════════════════════════════════════════════════════
+ */
+#define PACK_DAY_SLOTS 64           /* Power of two */
+
+typedef struct {
+    long long day;                  /* Days since 1970-01-01 local */
+    long long evening;              /* Seconds after midnight sunset falls */
+    CelticDayPacked before, after;
+} PackDay;
+
+static void pack_celtic_day(long jd, int evening, CelticDayPacked *out)
+{
+    CelticDate cd;
+    celtic_date_from_jd(jd, &cd);
+    out->jd = (int32_t)jd;
+    out->year = (int16_t)cd.year;
+    out->day_of_year = (uint16_t)cd.day_of_year;
+    out->month_index = (uint8_t)cd.month_index;
+    out->day_of_month = (uint8_t)cd.day_of_month;
+    out->flags = (uint8_t)((cd.is_mat ? CELTIC_DAY_MAT : 0) |
+                           (cd.is_atenoux ? CELTIC_DAY_ATENOUX : 0) |
+                           (cd.is_d_amb ? CELTIC_DAY_D_AMB : 0) |
+                           (evening ? CELTIC_DAY_EVENING : 0));
+    out->reserved = 0;
+}
+
+static void fill_pack_day(const CelticLocation *loc, long long day, PackDay *p)
+{
+    long jd = UNIX_EPOCH_JD + (long)day;
+    double sunset = location_sunset(loc, jd);
+
+    /* Smallest whole second s with s / 3600.0 >= sunset */
+    long long s;
+    if (!(sunset > 0.0)) {
+        s = 0;
+    } else if (sunset >= 24.0) {
+        s = SECONDS_PER_DAY;
+    } else {
+        s = (long long)ceil(sunset * 3600.0);
+        while (s > 0 && (double)(s - 1) / 3600.0 >= sunset) s--;
+        while ((double)s / 3600.0 < sunset) s++;
+    }
+
+    p->day = day;
+    p->evening = s;
+    pack_celtic_day(jd, 0, &p->before);
+    pack_celtic_day(jd + 1, 1, &p->after);
+}
+
+void location_pack_days(const CelticLocation *loc, const time_t *times, size_t n,
+                        CelticDayPacked *out)
+{
+    double offset_hours = loc->solar_time ? loc->longitude / 15.0 : loc->tz_offset;
+    long long offset = llround(offset_hours * 3600.0);
+
+    PackDay table[PACK_DAY_SLOTS];
+    for (int i = 0; i < PACK_DAY_SLOTS; i++) table[i].day = LLONG_MIN;
+    PackDay *last = &table[0];
+
+    for (size_t i = 0; i < n; i++) {
+        long long secs = (long long)times[i] + offset;
+        long long day = secs / SECONDS_PER_DAY;
+        long long rem = secs % SECONDS_PER_DAY;
+        if (rem < 0) {
+            rem += SECONDS_PER_DAY;
+            day--;
+        }
+
+        PackDay *p = last;
+        if (p->day != day) {
+            p = &table[(unsigned long long)day & (PACK_DAY_SLOTS - 1)];
+            if (p->day != day) fill_pack_day(loc, day, p);
+            last = p;
+        }
+        out[i] = rem >= p->evening ? p->after : p->before;
+    }
+}
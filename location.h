@@ -0,0 +1,84 @@
+#ifndef LOCATION_H
+#define LOCATION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+/*
+ * Observer location for sunset reckoning (the Celtic day begins at sunset).
+ *
+ * With solar_time set, hours are local apparent solar time and longitude
+ * and zone are ignored: the historical behaviour of calculate_sunset().
+ * Otherwise hours are clock time in the zone tz_offset hours east of UTC,
+ * corrected for longitude and the equation of time.
+ *
+ * Sunsets are kept per thread in year-sized blocks of daily values keyed by
+ * the location and filled as days are asked for, so repeated queries for
+ * the same sites cost a table load.
+ */
+typedef struct {
+    double latitude;    /* Degrees north */
+    double longitude;   /* Degrees east */
+    double tz_offset;   /* Hours east of UTC */
+    int solar_time;     /* 1 = local solar time (legacy) */
+} CelticLocation;
+
+/* Coligny, France, in local solar time: the reckoning the views have always used */
+#define LOCATION_COLIGNY ((CelticLocation){46.38, 5.35, 1.0, 1})
+
+/* Clock-time location */
+CelticLocation location_make(double latitude, double longitude, double tz_offset);
+
+/* Parse "LAT,LON[,TZ]" (TZ in hours, default 0); returns 0, or -1 if malformed */
+int location_parse(const char *text, CelticLocation *out);
+
+/* Short label such as "46.38°N 5.35°E, UTC+1" */
+void location_label(const CelticLocation *loc, char *buffer, size_t size);
+
+/* Sunset on the civil day jd, in hours after local midnight */
+double location_sunset(const CelticLocation *loc, long jd);
+void location_sunset_str(const CelticLocation *loc, long jd, char *buffer, int buf_size);
+int location_is_after_sunset(const CelticLocation *loc, long jd, double hour);
+long location_celtic_jd(const CelticLocation *loc, long jd, double hour);
+
+/* Civil day (noon JD) and hour of an instant at a location */
+void location_local_time(const CelticLocation *loc, time_t t, long *jd, double *hour);
+
+/* Celtic day of an instant */
+long location_celtic_jd_at(const CelticLocation *loc, time_t t);
+
+/*
+ * Celtic day of every timestamp at every site: out[s * n + i] is the day
+ * of times[i] at sites[s]. Timestamps may be in any order.
+ */
+void location_celtic_days(const CelticLocation *sites, size_t site_count,
+                          const time_t *times, size_t n, long *out);
+
+/* One timestamp's Celtic day, packed for bulk output (12 bytes) */
+typedef struct {
+    int32_t jd;             /* Celtic day (after sunset: the next civil day) */
+    int16_t year;           /* Celtic year */
+    uint16_t day_of_year;   /* 1-based */
+    uint8_t month_index;    /* 0-11, fixed month model */
+    uint8_t day_of_month;   /* 1-based */
+    uint8_t flags;          /* CELTIC_DAY_* */
+    uint8_t reserved;
+} CelticDayPacked;
+
+#define CELTIC_DAY_MAT      0x01
+#define CELTIC_DAY_ATENOUX  0x02
+#define CELTIC_DAY_D_AMB    0x04
+#define CELTIC_DAY_EVENING  0x08   /* Between sunset and civil midnight */
+
+/*
+ * Celtic day of every timestamp at one site, as location_celtic_jd_at()
+ * plus the calendar fields of that day. Sunset and both Celtic dates are
+ * resolved once per civil day and reused for every timestamp on it, so
+ * log-ordered input costs a compare per timestamp; unsorted input works
+ * too, through a small table of recent civil days.
+ */
+void location_pack_days(const CelticLocation *loc, const time_t *times, size_t n,
+                        CelticDayPacked *out);
+
+#endif
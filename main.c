@@ -2,80 +2,256 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
-#include <wchar.h>
-#include <wctype.h>
-#include <locale.h>
 #include <string.h>
+#include <errno.h>
 #include "calendar.h"
 #include "astronomy.h"
 #include "glyphs.h"
+#include "text_layout.h"
+#include "export.h"
+#include "server.h"
+#include "ephemeris.h"
+#include "profile.h"
+#include "location.h"
+#include "search.h"
+#include "festivals.h"
 
-/* Default location: Coligny, France (where the calendar was found) */
-#define LATITUDE 46.38
 /* Match the width of month grids (71 chars including borders) */
 #define BOX_WIDTH 71
 
-/* Locale-aware width helpers so emoji align in boxes */
-static void ensure_locale(void)
+static void box_border(const char *left, const char *right)
+{
+    fputs(left, stdout);
+    for (int i = 0; i < BOX_WIDTH; i++) fputs("─", stdout);
+    fputs(right, stdout);
+    fputc('\n', stdout);
+}
+
+static void box_line(const char *text)
+{
+    int w = text_display_width(text);
+    int pad = BOX_WIDTH - w;
+    if (pad < 0) pad = 0;
+    fputs("│", stdout);
+    fputs(text, stdout);
+    for (int i = 0; i < pad; i++) fputc(' ', stdout);
+    fputs("│\n", stdout);
+}
+
+/* Parse YYYY-MM-DD (negative years allowed) into a JD */
+static int parse_iso_date(const char *text, long *jd)
+{
+    int year, month, day;
+    char tail;
+    if (sscanf(text, "%d-%d-%d%c", &year, &month, &day, &tail) != 3) return -1;
+    if (month < 1 || month > 12 || day < 1 || day > 31) return -1;
+    *jd = jd_from_ymd(year, month, day);
+    return 0;
+}
+
+/* Observer for sunset reckoning: Coligny solar time unless --location is given */
+static CelticLocation site;
+
+/* celtic_calendar --range FROM TO [--format csv|jsonl|ics] [--lat DEG] [--threads N] */
+static int run_range_export(int argc, char *argv[])
 {
-    static int initialized = 0;
-    if (!initialized) {
-        setlocale(LC_ALL, "");
-        initialized = 1;
+    long jd_first, jd_last;
+    int format = EXPORT_CSV;
+    int threads = 1;
+
+    if (argc < 4 || parse_iso_date(argv[2], &jd_first) != 0 || parse_iso_date(argv[3], &jd_last) != 0) {
+        fprintf(stderr, "Usage: %s --range YYYY-MM-DD YYYY-MM-DD [--format csv|jsonl|ics] [--lat DEG] [--threads N]\n", argv[0]);
+        return 1;
+    }
+    for (int i = 4; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--format") == 0) {
+            format = export_format_from_name(argv[++i]);
+            if (format < 0) {
+                fprintf(stderr, "Unknown format '%s' (expected csv, jsonl or ics)\n", argv[i]);
+                return 1;
+            }
+        } else if (i + 1 < argc && strcmp(argv[i], "--lat") == 0) {
+            site.latitude = atof(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--threads") == 0) {
+            threads = atoi(argv[++i]);
+            if (threads < 1) {
+                fprintf(stderr, "--threads needs a positive count\n");
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "Unknown option '%s'\n", argv[i]);
+            return 1;
+        }
     }
+    if (jd_last < jd_first) {
+        fprintf(stderr, "Range end is before its start\n");
+        return 1;
+    }
+    if (format == EXPORT_ICS && (jd_first < jd_from_ymd(1, 1, 1) || jd_last >= jd_from_ymd(9999, 12, 31))) {
+        fprintf(stderr, "iCalendar dates must lie within 0001-01-01 .. 9999-12-30\n");
+        return 1;
+    }
+
+    if (export_range_parallel(stdout, jd_first, jd_last, (ExportFormat)format, &site, threads) != 0) {
+        perror("export");
+        return 1;
+    }
+    return 0;
 }
 
-static int codepoint_width(wchar_t ch)
+/* celtic_calendar --serve [--unix PATH] [--port N] */
+static int run_query_server(int argc, char *argv[])
 {
-    int w = wcwidth(ch);
-    if (w < 0) w = 1;
-    if (w < 2) {
-        if ((ch >= 0x1F300 && ch <= 0x1FAFF) || (ch >= 0x1F600 && ch <= 0x1F64F)) {
-            w = 2;
+    const char *unix_path = NULL;
+    int port = 0;
+
+    for (int i = 2; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--unix") == 0) {
+            unix_path = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--port") == 0) {
+            port = atoi(argv[++i]);
+            if (port < 1 || port > 65535) {
+                fprintf(stderr, "--port needs a value in 1..65535\n");
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "Unknown option '%s'\n", argv[i]);
+            return 1;
         }
     }
-    return w;
+    if (!unix_path && port == 0) {
+        fprintf(stderr, "Usage: %s --serve [--unix PATH] [--port N]\n", argv[0]);
+        return 1;
+    }
+    return run_server(unix_path, port) == 0 ? 0 : 1;
 }
 
-static int display_width(const char *s)
+/* celtic_calendar --year|--metonic [SAMHAIN_YEAR] [--columns N] [--threads N] */
+static int run_sheet(int argc, char *argv[])
 {
-    ensure_locale();
-    mbstate_t st = {0};
-    int width = 0;
-    const char *p = s;
-    wchar_t wc;
-
-    while (*p) {
-        size_t len = mbrtowc(&wc, p, MB_CUR_MAX, &st);
-        if (len == (size_t)-1 || len == (size_t)-2) {
-            ++p;
-            ++width;
-            memset(&st, 0, sizeof(st));
-            continue;
+    int metonic = strcmp(argv[1], "--metonic") == 0;
+    long celtic_today = location_celtic_jd_at(&site, time(NULL));
+    int samhain_year = lunar_samhain_year(celtic_today);
+    int columns = 3;
+    int threads = 1;
+    int i = 2;
+
+    if (i < argc && argv[i][0] != '-') {
+        char *end;
+        samhain_year = (int)strtol(argv[i], &end, 10);
+        if (*end != '\0') {
+            fprintf(stderr, "Usage: %s %s [SAMHAIN_YEAR] [--columns N] [--threads N]\n", argv[0], argv[1]);
+            return 1;
         }
-        width += codepoint_width(wc);
-        p += len;
+        i++;
     }
-    return width;
+    for (; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--columns") == 0) {
+            columns = atoi(argv[++i]);
+            if (columns < 1) {
+                fprintf(stderr, "--columns needs a positive count\n");
+                return 1;
+            }
+        } else if (i + 1 < argc && strcmp(argv[i], "--threads") == 0) {
+            threads = atoi(argv[++i]);
+            if (threads < 1) {
+                fprintf(stderr, "--threads needs a positive count\n");
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "Unknown option '%s'\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (metonic) print_metonic_sheet(samhain_year, celtic_today, columns, threads);
+    else print_celtic_year(samhain_year, celtic_today, columns, threads);
+    return 0;
 }
 
-static void box_border(const char *left, const char *right)
+/* celtic_calendar --find FROM TO TERM... [--limit N] */
+typedef struct {
+    long remaining;     /* Matches still to print, -1 = all */
+} FindOutput;
+
+static int print_match(long jd, void *ctx)
 {
-    fputs(left, stdout);
-    for (int i = 0; i < BOX_WIDTH; i++) fputs("─", stdout);
-    fputs(right, stdout);
-    fputc('\n', stdout);
+    FindOutput *out = ctx;
+    int year, month, day;
+    ymd_from_jd(jd, &year, &month, &day);
+    int lunar_month = lunar_celtic_month_index(jd);
+    printf("%s%04d-%02d-%02d  JD %ld  %2d %-12s %d\n", year < 0 ? "-" : "", year < 0 ? -year : year,
+           month, day, jd, lunar_day_of_month(jd), get_celtic_month_name(lunar_month),
+           celtic_year_from_jd(jd));
+    if (out->remaining > 0) out->remaining--;
+    return out->remaining == 0;
 }
 
-static void box_line(const char *text)
+static int run_find(int argc, char *argv[])
 {
-    int w = display_width(text);
-    int pad = BOX_WIDTH - w;
-    if (pad < 0) pad = 0;
-    fputs("│", stdout);
-    fputs(text, stdout);
-    for (int i = 0; i < pad; i++) fputc(' ', stdout);
-    fputs("│\n", stdout);
+    long jd_first, jd_last;
+    FindOutput out = {-1};
+    CelticQuery query;
+    celtic_query_init(&query);
+
+    if (argc < 4 || parse_iso_date(argv[2], &jd_first) != 0 || parse_iso_date(argv[3], &jd_last) != 0) {
+        fprintf(stderr, "Usage: %s --find YYYY-MM-DD YYYY-MM-DD TERM... [--limit N]\n"
+                        "Terms (all must hold): month=SAM,.. day=N[-M],.. mat anm atenoux d-amb festival[=NAME]\n"
+                        "  phase=full,.. sign=aries,.. event[=yule,..] solilunar pleiades (no-TERM excludes)\n",
+                argv[0]);
+        return 1;
+    }
+    for (int i = 4; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--limit") == 0) {
+            out.remaining = atol(argv[++i]);
+            if (out.remaining < 1) {
+                fprintf(stderr, "--limit needs a positive count\n");
+                return 1;
+            }
+        } else if (celtic_query_parse(&query, argv[i]) != 0) {
+            fprintf(stderr, "Unknown search term '%s'\n", argv[i]);
+            return 1;
+        }
+    }
+    if (jd_last < jd_first) {
+        fprintf(stderr, "Range end is before its start\n");
+        return 1;
+    }
+
+    celtic_search(&query, jd_first, jd_last, print_match, &out);
+    return 0;
+}
+
+static void print_profile_report(void)
+{
+    profile_report(stderr);
+}
+
+/* Remove "option VALUE" from argv wherever it appears; returns VALUE or NULL */
+static const char *take_option(int *argc, char *argv[], const char *option)
+{
+    const char *value = NULL;
+    int out = 1;
+    for (int i = 1; i < *argc; i++) {
+        if (i + 1 < *argc && strcmp(argv[i], option) == 0) value = argv[++i];
+        else argv[out++] = argv[i];
+    }
+    argv[out] = NULL;
+    *argc = out;
+    return value;
+}
+
+/* Remove a bare flag from argv wherever it appears; returns 1 if it was present */
+static int take_flag(int *argc, char *argv[], const char *flag)
+{
+    int found = 0, out = 1;
+    for (int i = 1; i < *argc; i++) {
+        if (strcmp(argv[i], flag) == 0) found = 1;
+        else argv[out++] = argv[i];
+    }
+    argv[out] = NULL;
+    *argc = out;
+    return found;
 }
 
 int main(int argc, char *argv[])
@@ -85,6 +261,72 @@ int main(int argc, char *argv[])
     struct tm local_time;
     struct tm *local;
 
+    /* --profile: counter summary on stderr at exit (needs -DCELTIC_PROFILE) */
+    if (take_flag(&argc, argv, "--profile")) atexit(print_profile_report);
+
+    /* --location LAT,LON[,TZ]: sunsets on that zone's clock instead of Coligny solar time */
+    site = LOCATION_COLIGNY;
+    const char *site_text = take_option(&argc, argv, "--location");
+    if (site_text && location_parse(site_text, &site) != 0) {
+        fprintf(stderr, "Bad --location '%s' (expected LAT,LON[,TZ])\n", site_text);
+        return 1;
+    }
+
+    /* --tier fast|standard|high (or CELTIC_TIER): precision of the Sun, Moon and full moons */
+    const char *tier_text = take_option(&argc, argv, "--tier");
+    if (!tier_text) tier_text = getenv("CELTIC_TIER");
+    if (tier_text && *tier_text) {
+        PrecisionTier tier;
+        if (precision_tier_parse(tier_text, &tier) != 0) {
+            fprintf(stderr, "Bad --tier '%s' (expected fast, standard or high)\n", tier_text);
+            return 1;
+        }
+        if (astronomy_set_tier(tier) != 0) {
+            fprintf(stderr, "The %s tier is not available in this build\n", tier_text);
+            return 1;
+        }
+    }
+
+    /* Optional precomputed ephemeris shared by every process on the host */
+    const char *ephemeris_path = getenv("CELTIC_EPHEMERIS");
+    if (ephemeris_path && *ephemeris_path) {
+        if (ephemeris_open(ephemeris_path) != 0) {
+            fprintf(stderr, "Ignoring ephemeris %s: %s\n", ephemeris_path, strerror(errno));
+        } else if (ephemeris_tier() != (int)astronomy_tier()) {
+            fprintf(stderr, "Ignoring ephemeris %s: generated with the %s tier, running %s\n", ephemeris_path,
+                    precision_tier_name((PrecisionTier)ephemeris_tier()), precision_tier_name(astronomy_tier()));
+            ephemeris_close();
+        }
+    }
+
+    /* --festivals FILE (or CELTIC_FESTIVALS): regional festival definitions (festivals.h);
+     * --serve reloads the file on SIGHUP or RELOAD */
+    const char *festival_file = take_option(&argc, argv, "--festivals");
+    if (!festival_file) festival_file = getenv("CELTIC_FESTIVALS");
+    if (festival_file && *festival_file) {
+        int line;
+        if (festivals_load(festival_file, &line) < 0) {
+            if (line && errno == E2BIG)
+                fprintf(stderr, "%s:%d: more than %d definitions of this kind\n", festival_file, line, FESTIVAL_RULES_MAX);
+            else if (line) fprintf(stderr, "%s:%d: bad festival definition\n", festival_file, line);
+            else perror(festival_file);
+            return 1;
+        }
+    }
+
+    if (argc >= 2 && strcmp(argv[1], "--range") == 0) {
+        return run_range_export(argc, argv);
+    }
+    if (argc >= 2 && strcmp(argv[1], "--serve") == 0) {
+        return run_query_server(argc, argv);
+    }
+    if (argc >= 2 && strcmp(argv[1], "--find") == 0) {
+        return run_find(argc, argv);
+    }
+    if (argc >= 2 && (strcmp(argv[1], "--year") == 0 || strcmp(argv[1], "--metonic") == 0)) {
+        return run_sheet(argc, argv);
+    }
+
     if (argc == 4) {
         /* User specified date: year month day */
         int year = atoi(argv[1]);
@@ -98,26 +340,30 @@ int main(int argc, char *argv[])
         local = &local_time;
     } else {
         /* Use current date/time */
-        jd = jd_today();
         time_t t = time(NULL);
-        local = localtime(&t);
-        current_hour = local->tm_hour + local->tm_min / 60.0;
+        if (site.solar_time) {
+            jd = jd_today();
+            local = localtime(&t);
+            current_hour = local->tm_hour + local->tm_min / 60.0;
+        } else {
+            /* Civil day and time on the site's zone clock */
+            location_local_time(&site, t, &jd, &current_hour);
+            local_time.tm_hour = (int)current_hour;
+            local_time.tm_min = (int)((current_hour - local_time.tm_hour) * 60.0);
+            local = &local_time;
+        }
     }
 
     /* Calculate sunset time */
     char sunset_str[16];
-    get_sunset_time_str(jd, LATITUDE, sunset_str, sizeof(sunset_str));
+    location_sunset_str(&site, jd, sunset_str, sizeof(sunset_str));
 
     /* Check if we're in the Celtic "next day" (after sunset) */
-    int after_sunset = is_after_sunset(jd, current_hour, LATITUDE);
-    long celtic_jd = celtic_jd_from_time(jd, current_hour, LATITUDE);
+    int after_sunset = location_is_after_sunset(&site, jd, current_hour);
+    long celtic_jd = location_celtic_jd(&site, jd, current_hour);
 
-    int year = celtic_year_from_jd(celtic_jd);
-    int doy = day_of_year(celtic_jd);
-    int remaining = days_remaining(celtic_jd);
-    double frac = elapsed_fraction(celtic_jd);
-    int age, year_in_age;
-    age_and_year_in_age(celtic_jd, &age, &year_in_age);
+    CelticDate cd;
+    celtic_date_from_jd(celtic_jd, &cd);
 
     /* Use TRUE lunar-synced month calculation */
     /* Month starts at full moon, ATENOUX at new moon */
@@ -133,10 +379,10 @@ int main(int argc, char *argv[])
 
     printf("Celtic Calendar — Daily View (Lunar-Synced)\n");
     printf("═══════════════════════════════════════════════════\n");
-    printf("Celtic Year: %d\n", year);
-    printf("Elapsed fraction of current year: %.2f\n", frac);
-    printf("Age: %d | Year in Age: %d\n", age, year_in_age);
-    printf("Day of Year: %d / %d | Days Remaining: %d\n", doy, current_year_length(celtic_jd), remaining);
+    printf("Celtic Year: %d\n", cd.year);
+    printf("Elapsed fraction of current year: %.2f\n", cd.elapsed_fraction);
+    printf("Age: %d | Year in Age: %d\n", cd.age, cd.year_in_age);
+    printf("Day of Year: %d / %d | Days Remaining: %d\n", cd.day_of_year, cd.year_length, cd.days_remaining);
     printf("═══════════════════════════════════════════════════\n");
 
     /* Celtic day timing information */
@@ -146,7 +392,13 @@ int main(int argc, char *argv[])
     box_border("├", "┤");
     snprintf(line, sizeof(line), " Current Time: %02d:%02d", local->tm_hour, local->tm_min);
     box_line(line);
-    snprintf(line, sizeof(line), " Sunset Today: %s (Coligny, 46.38°N)", sunset_str);
+    if (site.solar_time) {
+        snprintf(line, sizeof(line), " Sunset Today: %s (Coligny, %.2f°N)", sunset_str, site.latitude);
+    } else {
+        char where[48];
+        location_label(&site, where, sizeof(where));
+        snprintf(line, sizeof(line), " Sunset Today: %s (%s)", sunset_str, where);
+    }
     box_line(line);
     if (after_sunset) {
         box_line(" ☽ After Sunset — Celtic day has begun");
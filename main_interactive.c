@@ -2,15 +2,61 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <errno.h>
+#include <stdio.h>
+#include "ephemeris.h"
+#include "astronomy.h"
+#include "festivals.h"
+#include "profile.h"
 
 /* Declare the clean UI function */
 void run_interactive_ui(void);
 
 int main(int argc, char *argv[])
 {
-    (void)argc;
-    (void)argv;
+    int show_profile = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--profile") == 0) show_profile = 1;
+    }
+
+    /* Precision tier of the Sun, Moon and full moons (precision.h) */
+    const char *tier_text = getenv("CELTIC_TIER");
+    if (tier_text && *tier_text) {
+        PrecisionTier tier;
+        if (precision_tier_parse(tier_text, &tier) != 0 || astronomy_set_tier(tier) != 0) {
+            fprintf(stderr, "Ignoring CELTIC_TIER=%s (expected fast, standard or high)\n", tier_text);
+        }
+    }
+
+    /* Optional precomputed ephemeris shared by every process on the host */
+    const char *ephemeris_path = getenv("CELTIC_EPHEMERIS");
+    if (ephemeris_path && *ephemeris_path) {
+        if (ephemeris_open(ephemeris_path) != 0) {
+            fprintf(stderr, "Ignoring ephemeris %s: %s\n", ephemeris_path, strerror(errno));
+        } else if (ephemeris_tier() != (int)astronomy_tier()) {
+            fprintf(stderr, "Ignoring ephemeris %s: generated with the %s tier, running %s\n", ephemeris_path,
+                    precision_tier_name((PrecisionTier)ephemeris_tier()), precision_tier_name(astronomy_tier()));
+            ephemeris_close();
+        }
+    }
+
+    /* Regional festival definitions (festivals.h) */
+    const char *festival_file = getenv("CELTIC_FESTIVALS");
+    if (festival_file && *festival_file) {
+        int line;
+        if (festivals_load(festival_file, &line) < 0) {
+            if (line && errno == E2BIG)
+                fprintf(stderr, "Ignoring %s: more than %d definitions of this kind on line %d\n",
+                        festival_file, FESTIVAL_RULES_MAX, line);
+            else if (line) fprintf(stderr, "Ignoring %s: bad festival definition on line %d\n", festival_file, line);
+            else fprintf(stderr, "Ignoring %s: %s\n", festival_file, strerror(errno));
+        }
+    }
+
     /* Launch interactive UI by default */
     run_interactive_ui();
+
+    /* After endwin(), so the table lands on the normal screen */
+    if (show_profile) profile_report(stderr);
     return 0;
 }
@@ -0,0 +1,49 @@
+#ifndef PRECISION_H
+#define PRECISION_H
+
+/*
+ * Ephemeris precision tiers.
+ *
+ * astronomy.c computes the Sun, the Moon and the lunations from one of
+ * these models, chosen with astronomy_set_tier(). Every quantity derived
+ * from them follows: signs, phases, full-moon days and lunar months,
+ * cross-quarters, Samhain, event years, sunsets. gen_ephemeris can bake any tier into a mapped file, so
+ * the cost is paid once where dates are published.
+ *
+ *   fast      The built-in mean formulas: ~0.01 deg solar series, mean
+ *             lunation of 29.53058867 days, no perturbations, no Delta T.
+ *             Full moons can land a day off. Default.
+ *   standard  Sun by the ~0.01 deg series in T with nutation and
+ *             aberration, Moon by the main ELP-2000/82 terms (~0.05 deg),
+ *             full moons by the perturbed phase series (minutes), Delta T.
+ *   high      Sun by truncated VSOP87 (~1"), Moon by the 60-term ELP
+ *             series (~10"), full moons solved from those longitudes.
+ *
+ * Times are JD in UT (civil days are whole JD at noon, as everywhere in
+ * the calendar); the standard and high series run in TT and convert with
+ * the Espenak-Meeus Delta T polynomials.
+ */
+typedef enum {
+    PRECISION_FAST = 0,
+    PRECISION_STANDARD,
+    PRECISION_HIGH,
+    PRECISION_TIERS
+} PrecisionTier;
+
+typedef struct {
+    const char *name;
+    double (*sun_longitude)(double jd);    /* Apparent geocentric ecliptic longitude, degrees 0-360 */
+    double (*moon_longitude)(double jd);   /* Same for the Moon */
+    double (*full_moon)(long lunation);    /* JD of the full moon opening lunation k (lunation_number()) */
+} EphemerisModel;
+
+/* The model of a tier; NULL for fast, which astronomy.c computes inline */
+const EphemerisModel *precision_model(PrecisionTier tier);
+
+const char *precision_tier_name(PrecisionTier tier);    /* "fast", "standard", "high" */
+int precision_tier_parse(const char *name, PrecisionTier *out);  /* 0, or -1 if unknown */
+
+/* TT - UT in days at a JD (Espenak-Meeus polynomials, long-term parabola outside -1999..3000) */
+double precision_delta_t(double jd);
+
+#endif
@@ -0,0 +1,194 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "profile.h"
+
+static const char *counter_names[PROF_COUNTER_COUNT] = {
+    "solar_series",
+    "solar_crossing",
+    "find_full_moon_before",
+    "lunar_month_index",
+    "lunar_year_hit",
+    "lunar_year_miss",
+    "event_year_hit",
+    "event_year_miss",
+    "samhain_hit",
+    "samhain_miss",
+    "celtic_date",
+    "sunset",
+    "render_month",
+    "render_bytes",
+};
+
+#ifdef CELTIC_PROFILE
+
+#include <pthread.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════════
+ * THREAD BLOCKS
+ * Every thread that touches a counter gets a heap block linked into the
+ * live list; the key destructor folds it into retired_stats at exit.
+ * ═══════════════════════════════════════════════════════════════════════════
+ */
+_Thread_local ProfileThread *profile_thread = NULL;
+
+static pthread_mutex_t profile_lock = PTHREAD_MUTEX_INITIALIZER;
+static ProfileThread *live_threads = NULL;
+static ProfileStats retired_stats;
+
+static pthread_key_t profile_key;
+static pthread_once_t profile_key_once = PTHREAD_ONCE_INIT;
+
+static void add_stats(ProfileStats *into, const ProfileStats *from)
+{
+    for (int i = 0; i < PROF_COUNTER_COUNT; i++) {
+        into->count[i] += __atomic_load_n(&from->count[i], __ATOMIC_RELAXED);
+        into->ticks[i] += __atomic_load_n(&from->ticks[i], __ATOMIC_RELAXED);
+    }
+}
+
+static void profile_thread_exit(void *arg)
+{
+    ProfileThread *t = arg;
+    pthread_mutex_lock(&profile_lock);
+    add_stats(&retired_stats, &t->stats);
+    if (t->prev) t->prev->next = t->next;
+    else live_threads = t->next;
+    if (t->next) t->next->prev = t->prev;
+    pthread_mutex_unlock(&profile_lock);
+    free(t);
+    profile_thread = NULL;   /* Counters hit by later destructors attach a fresh block */
+}
+
+static void create_profile_key(void)
+{
+    pthread_key_create(&profile_key, profile_thread_exit);
+}
+
+/* A thread whose block cannot be allocated counts into this shared sink */
+static ProfileThread overflow_thread = { .shared = 1 };
+
+ProfileThread *profile_thread_attach(void)
+{
+    ProfileThread *t = calloc(1, sizeof(ProfileThread));
+    if (!t) return &overflow_thread;
+
+    pthread_once(&profile_key_once, create_profile_key);
+    pthread_mutex_lock(&profile_lock);
+    t->next = live_threads;
+    if (live_threads) live_threads->prev = t;
+    live_threads = t;
+    pthread_mutex_unlock(&profile_lock);
+    pthread_setspecific(profile_key, t);
+
+    profile_thread = t;
+    return t;
+}
+
+uint64_t profile_ticks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+void profile_snapshot(ProfileStats *out)
+{
+    pthread_mutex_lock(&profile_lock);
+    *out = retired_stats;
+    for (ProfileThread *t = live_threads; t; t = t->next) add_stats(out, &t->stats);
+    pthread_mutex_unlock(&profile_lock);
+    add_stats(out, &overflow_thread.stats);
+}
+
+int profile_enabled(void)
+{
+    return 1;
+}
+
+#else
+
+void profile_snapshot(ProfileStats *out)
+{
+    memset(out, 0, sizeof(*out));
+}
+
+int profile_enabled(void)
+{
+    return 0;
+}
+
+#endif
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════════
+ * REPORTS
+ * ═══════════════════════════════════════════════════════════════════════════
+ */
+void profile_report(FILE *out)
+{
+    if (!profile_enabled()) {
+        fprintf(out, "Profiling is not compiled in (rebuild with -DCELTIC_PROFILE)\n");
+        return;
+    }
+
+    ProfileStats st;
+    profile_snapshot(&st);
+#if defined(__x86_64__) || defined(__i386__)
+    const char *unit = "cycles";
+#else
+    const char *unit = "ns";
+#endif
+
+    fprintf(out, "%-24s %14s %16s %14s\n", "counter", "count", unit, "per call");
+    for (int i = 0; i < PROF_COUNTER_COUNT; i++) {
+        if (st.count[i] == 0) continue;
+        if (st.ticks[i]) {
+            fprintf(out, "%-24s %14llu %16llu %14.1f\n", counter_names[i],
+                    (unsigned long long)st.count[i], (unsigned long long)st.ticks[i],
+                    (double)st.ticks[i] / (double)st.count[i]);
+        } else {
+            fprintf(out, "%-24s %14llu %16s %14s\n", counter_names[i],
+                    (unsigned long long)st.count[i], "-", "-");
+        }
+    }
+
+    /* Cache hit rates, where both sides were seen */
+    static const int pairs[][2] = {
+        {PROF_SAMHAIN_HIT, PROF_SAMHAIN_MISS},
+        {PROF_EVENT_YEAR_HIT, PROF_EVENT_YEAR_MISS},
+        {PROF_LUNAR_YEAR_HIT, PROF_LUNAR_YEAR_MISS},
+    };
+    for (size_t p = 0; p < sizeof(pairs) / sizeof(pairs[0]); p++) {
+        uint64_t hit = st.count[pairs[p][0]], miss = st.count[pairs[p][1]];
+        if (hit + miss == 0) continue;
+        size_t len = strlen(counter_names[pairs[p][0]]) - 4;   /* Drop "_hit" */
+        fprintf(out, "%.*s hit rate: %.2f%%\n", (int)len, counter_names[pairs[p][0]],
+                100.0 * (double)hit / (double)(hit + miss));
+    }
+}
+
+int profile_format_line(char *buf, size_t size)
+{
+    ProfileStats st;
+    profile_snapshot(&st);
+
+    size_t len = 0;
+    buf[0] = '\0';
+    for (int i = 0; i < PROF_COUNTER_COUNT && len < size; i++) {
+        int n = snprintf(buf + len, size - len, "%s%s=%llu/%llu", len ? " " : "", counter_names[i],
+                         (unsigned long long)st.count[i], (unsigned long long)st.ticks[i]);
+        if (n < 0) break;
+        len += (size_t)n;
+    }
+    return (int)(len < size ? len : size - 1);
+}
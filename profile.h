@@ -0,0 +1,116 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/*
+ * Hot-path instrumentation, compiled in only with -DCELTIC_PROFILE.
+ *
+ * Each thread counts into its own block, the only writer to it; the
+ * stores are relaxed atomics so a report can read a live block. A thread
+ * whose block cannot be allocated counts into one shared overflow block
+ * instead, which any number of such threads bump at once, so its counts
+ * are atomic adds. A thread's totals are folded into the process totals
+ * when it exits, and a report adds the threads still running and the
+ * overflow block. Without CELTIC_PROFILE every PROFILE_* macro expands to
+ * nothing and the report says so.
+ *
+ *   PROFILE_COUNT(id)        one event
+ *   PROFILE_ADD(id, n)       n units (bytes, slots, ...)
+ *   PROFILE_BEGIN(id) ... PROFILE_END(id)
+ *                            one call plus the ticks spent between the two
+ *                            (TSC cycles on x86, nanoseconds elsewhere)
+ */
+typedef enum {
+    PROF_SOLAR_SERIES,          /* Evaluations of the solar longitude series */
+    PROF_SOLAR_CROSSING,        /* solar_longitude_crossing() */
+    PROF_FULL_MOON_BEFORE,      /* find_full_moon_before() */
+    PROF_LUNAR_MONTH_INDEX,     /* lunar_celtic_month_index() */
+    PROF_LUNAR_YEAR_HIT,
+    PROF_LUNAR_YEAR_MISS,
+    PROF_EVENT_YEAR_HIT,
+    PROF_EVENT_YEAR_MISS,       /* Ticks: building the year */
+    PROF_SAMHAIN_HIT,
+    PROF_SAMHAIN_MISS,          /* Ticks: the crossing search */
+    PROF_CELTIC_DATE,           /* celtic_date_from_jd() */
+    PROF_SUNSET,                /* calculate_sunset() */
+    PROF_RENDER_MONTH,          /* Month views rendered */
+    PROF_RENDER_BYTES,          /* Bytes written into render sinks */
+    PROF_COUNTER_COUNT
+} ProfileCounter;
+
+typedef struct {
+    uint64_t count[PROF_COUNTER_COUNT];
+    uint64_t ticks[PROF_COUNTER_COUNT];
+} ProfileStats;
+
+/* Process totals so far: exited threads plus a snapshot of live ones */
+void profile_snapshot(ProfileStats *out);
+
+/* Human-readable table of the non-zero counters */
+void profile_report(FILE *out);
+
+/* One line "name=count/ticks ..." (daemon STATS); returns the length written */
+int profile_format_line(char *buf, size_t size);
+
+/* 1 if built with CELTIC_PROFILE */
+int profile_enabled(void);
+
+#ifdef CELTIC_PROFILE
+
+typedef struct ProfileThread {
+    ProfileStats stats;
+    int shared;      /* The overflow block, bumped by any thread without one */
+    struct ProfileThread *next;
+    struct ProfileThread *prev;
+} ProfileThread;
+
+extern _Thread_local ProfileThread *profile_thread;
+ProfileThread *profile_thread_attach(void);
+uint64_t profile_ticks(void);
+
+static inline ProfileThread *profile_local(void)
+{
+    ProfileThread *t = profile_thread;
+    return t ? t : profile_thread_attach();
+}
+
+/*
+ * Relaxed stores: the owner is the only writer, reports may read
+ * concurrently. The shared overflow block needs a real atomic add.
+ */
+static inline void profile_bump(const ProfileThread *t, uint64_t *slot, uint64_t n)
+{
+    if (t->shared) __atomic_fetch_add(slot, n, __ATOMIC_RELAXED);
+    else __atomic_store_n(slot, __atomic_load_n(slot, __ATOMIC_RELAXED) + n, __ATOMIC_RELAXED);
+}
+
+#define PROFILE_COUNT(id)                                                     \
+    do {                                                                      \
+        ProfileThread *profile_t_ = profile_local();                          \
+        profile_bump(profile_t_, &profile_t_->stats.count[id], 1);            \
+    } while (0)
+#define PROFILE_ADD(id, n)                                                    \
+    do {                                                                      \
+        ProfileThread *profile_t_ = profile_local();                          \
+        profile_bump(profile_t_, &profile_t_->stats.count[id], (uint64_t)(n)); \
+    } while (0)
+#define PROFILE_BEGIN(id) uint64_t profile_t0_##id = profile_ticks()
+#define PROFILE_END(id)                                                       \
+    do {                                                                      \
+        ProfileThread *profile_t_ = profile_local();                          \
+        profile_bump(profile_t_, &profile_t_->stats.count[id], 1);            \
+        profile_bump(profile_t_, &profile_t_->stats.ticks[id], profile_ticks() - profile_t0_##id); \
+    } while (0)
+
+#else
+
+#define PROFILE_COUNT(id) ((void)0)
+#define PROFILE_ADD(id, n) ((void)0)
+#define PROFILE_BEGIN(id) ((void)0)
+#define PROFILE_END(id) ((void)0)
+
+#endif
+
+#endif
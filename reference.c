@@ -0,0 +1,1054 @@
+/*
+ * Reference engine: the original per-day implementations of calendar.c,
+ * astronomy.c and festivals.c, renamed with a ref_ prefix and otherwise
+ * kept as they were (daily longitude scans for Samhain, lunation stepping,
+ * the Gregorian conversions of the time). They exist so the optimised code
+ * paths can be checked against them (test_engines.c); do not optimise or
+ * "fix" them here, or the comparison loses its meaning.
+ */
+#include <math.h>
+#include <stdio.h>
+#include "reference.h"
+#include "festivals.h"
+
+#define PI 3.14159265358979323846
+
+/* Moon phases (8-step): 0=new, 1=waxing crescent, 2=first quarter, 3=waxing gibbous,
+ * 4=full, 5=waning gibbous, 6=last quarter, 7=waning crescent. Primary phases stay
+ * single-day using a narrow window. */
+int ref_moon_phase(long jd)
+{
+    /* Reference: New Moon on Jan 6, 2000 at JD 2451550.1 */
+    const double synodic = 29.53058867;
+    double phase = fmod((jd - 2451550.1) / synodic, 1.0);
+    if (phase < 0) phase += 1.0;
+
+    double age_days = phase * synodic;          /* 0 .. ~29.53 */
+    double d_new   = fmin(age_days, synodic - age_days);          /* distance to nearest new */
+    double d_full  = fabs(age_days - synodic * 0.5);              /* distance to full */
+    double d_fq    = fabs(age_days - synodic * 0.25);             /* distance to first quarter */
+    double d_lq    = fabs(age_days - synodic * 0.75);             /* distance to last quarter */
+
+    /* Window for primary phases; keep it narrow but not too tight so new/full land visibly */
+    const double peak_window = 0.55;  /* in days */
+
+    /* Snap to the closest primary phase if within the narrow window */
+    if (d_new  <= peak_window) return 0;
+    if (d_fq   <= peak_window) return 2;
+    if (d_full <= peak_window) return 4;
+    if (d_lq   <= peak_window) return 6;
+
+    /* Round to the nearest octant, but demote primaries outside the peak window */
+    int idx = (int)floor((phase * 8.0) + 0.5) % 8;
+
+    if (idx == 0 && d_new  > peak_window) idx = (phase < 0.5) ? 1 : 7;
+    if (idx == 2 && d_fq   > peak_window) idx = (phase < 0.25) ? 1 : 3;
+    if (idx == 4 && d_full > peak_window) idx = (phase < 0.5) ? 3 : 5;
+    if (idx == 6 && d_lq   > peak_window) idx = (phase < 0.75) ? 5 : 7;
+
+    return idx;
+}
+
+/*
+ * Sun's ecliptic longitude (tropical zodiac)
+ * Uses simplified formula accurate to ~1°
+ * Reference: Vernal Equinox (Sun at 0° Aries) occurs around March 20
+ */
+int ref_sun_sign(long jd)
+{
+    /* Days since J2000.0 epoch (Jan 1, 2000 12:00 TT) */
+    double d = jd - 2451545.0;
+
+    /* Mean longitude of the Sun (degrees) */
+    double L = fmod(280.460 + 0.9856474 * d, 360.0);
+    if (L < 0) L += 360.0;
+
+    /* Mean anomaly of the Sun (degrees) */
+    double g = fmod(357.528 + 0.9856003 * d, 360.0);
+    if (g < 0) g += 360.0;
+
+    /* Ecliptic longitude (with equation of center correction) */
+    double lambda = L + 1.915 * sin(g * PI / 180.0) + 0.020 * sin(2 * g * PI / 180.0);
+    lambda = fmod(lambda, 360.0);
+    if (lambda < 0) lambda += 360.0;
+
+    /* Convert to zodiac sign (0=Aries, 1=Taurus, ... 11=Pisces) */
+    return (int)(lambda / 30.0);
+}
+
+/*
+ * Moon's ecliptic longitude (tropical zodiac)
+ * Simplified formula - Moon moves ~13.2° per day
+ * Reference: Known Moon position at J2000.0
+ */
+int ref_moon_sign(long jd)
+{
+    /* Days since J2000.0 */
+    double d = jd - 2451545.0;
+
+    /* Moon's mean longitude (degrees) */
+    /* At J2000.0, Moon was at ~218° (Scorpio) */
+    double L = fmod(218.32 + 13.176396 * d, 360.0);
+    if (L < 0) L += 360.0;
+
+    /* Convert to zodiac sign */
+    return (int)(L / 30.0);
+}
+
+/*
+ * Calculate approximate ecliptic longitude of the Sun
+ * Returns degrees (0-360)
+ */
+double ref_sun_longitude(long jd)
+{
+    double d = jd - 2451545.0;
+    double L = fmod(280.460 + 0.9856474 * d, 360.0);
+    if (L < 0) L += 360.0;
+    double g = fmod(357.528 + 0.9856003 * d, 360.0);
+    if (g < 0) g += 360.0;
+    double lambda = L + 1.915 * sin(g * PI / 180.0) + 0.020 * sin(2 * g * PI / 180.0);
+    lambda = fmod(lambda, 360.0);
+    if (lambda < 0) lambda += 360.0;
+    return lambda;
+}
+
+/*
+ * Find the JD of the most recent full moon before or on given JD
+ * Celtic months begin at the full moon
+ */
+long ref_find_full_moon_before(long jd)
+{
+    /* Reference: New Moon on Jan 6, 2000 at JD 2451550.1 */
+    double synodic = 29.53058867;
+    double new_moon_ref = 2451550.1;
+
+    /* Phase: 0=new, 0.5=full */
+    double phase = fmod((jd - new_moon_ref) / synodic, 1.0);
+    if (phase < 0) phase += 1.0;
+
+    /* Days since last full moon (full moon is at phase 0.5) */
+    double days_since_full;
+    if (phase >= 0.5) {
+        days_since_full = (phase - 0.5) * synodic;
+    } else {
+        days_since_full = (phase + 0.5) * synodic;
+    }
+
+    return jd - (long)days_since_full;
+}
+
+/*
+ * Get the day within the current lunar month (1-30)
+ * Month starts at full moon, ATENOUX falls at new moon (~day 15)
+ */
+int ref_lunar_day_of_month(long jd)
+{
+    long month_start = ref_find_full_moon_before(jd);
+    return (int)(jd - month_start) + 1;
+}
+
+/*
+ * Get the length of the current lunar month (29 or 30 days)
+ * Based on actual time to next full moon
+ */
+int ref_lunar_month_length(long jd)
+{
+    long this_full = ref_find_full_moon_before(jd);
+    long next_full = ref_find_full_moon_before(jd + 30);  /* Find next full moon */
+    if (next_full <= this_full) {
+        next_full = ref_find_full_moon_before(jd + 35);
+    }
+    int length = (int)(next_full - this_full);
+    return (length >= 30) ? 30 : 29;
+}
+
+/*
+ * Find the full moon nearest to Samhain (sun at 225°) for a given Gregorian year
+ * This marks the start of Samonios and the Celtic year
+ */
+long ref_find_samonios_start(int greg_year)
+{
+    /* Find when sun is at 225° (Samhain) - typically Nov 7 */
+    long jd_nov1 = ref_jd_from_ymd(greg_year, 11, 1);
+    long jd_samhain = jd_nov1;
+
+    for (int d = 0; d < 15; d++) {
+        double sun = ref_sun_longitude(jd_nov1 + d);
+        if (sun >= 224.5 && sun <= 225.5) {
+            jd_samhain = jd_nov1 + d;
+            break;
+        }
+    }
+
+    /* Find the full moon nearest to Samhain (within ~7 days before) */
+    /* The full moon before or around Samhain starts Samonios */
+    long jd_full = ref_find_full_moon_before(jd_samhain + 3);
+
+    return jd_full;
+}
+
+/*
+ * Get the lunar Celtic month index (0-11 or 12 for intercalary)
+ * Based on counting lunations from Samonios start (full moon near Samhain)
+ */
+int ref_lunar_celtic_month_index(long jd)
+{
+    /* Determine which Gregorian year's Samhain we're relative to */
+    /* Celtic year starts around Nov, so:
+     * - Jan-Oct: use previous year's Samhain
+     * - Nov-Dec: check if before/after this year's Samhain
+     */
+
+    /* Get approximate Gregorian date from JD */
+    long z = jd + 1;
+    long alpha = (long)((z - 1867216.25) / 36524.25);
+    long a = z + 1 + alpha - alpha/4;
+    long b = a + 1524;
+    long c = (long)((b - 122.1) / 365.25);
+    long dd = (long)(365.25 * c);
+    long e = (long)((b - dd) / 30.6001);
+    int greg_month = (e < 14) ? e - 1 : e - 13;
+    int greg_year = (greg_month > 2) ? c - 4716 : c - 4715;
+
+
+    /* Find Samonios start for this Celtic year */
+    int samhain_year = (greg_month >= 11) ? greg_year : greg_year - 1;
+    long jd_samonios = ref_find_samonios_start(samhain_year);
+
+    /* If we're before this year's Samonios, use previous year */
+    if (jd < jd_samonios) {
+        samhain_year--;
+        jd_samonios = ref_find_samonios_start(samhain_year);
+    }
+
+    /* Count lunations since Samonios start */
+    long jd_current_month = ref_find_full_moon_before(jd);
+    int month_count = 0;
+    long jd_check = jd_samonios;
+
+    while (jd_check < jd_current_month) {
+        jd_check = ref_find_full_moon_before(jd_check + 32);  /* Jump to next full moon */
+        month_count++;
+        if (month_count > 13) break;  /* Safety limit */
+    }
+
+    /* Patch: shift so 0 = Giamonios, not Samonios */
+    int shifted = (month_count + 6) % 12; // 0=GIA, 6=SAM
+    return (month_count > 11) ? -1 : shifted;  /* -1 for intercalary */
+}
+
+/*
+ * ============================================================
+ * SUNSET CALCULATIONS
+ * The Celtic day begins at sunset, not midnight.
+ * "For two divisions were formerly on the year... and the night
+ *  in each case precedes the day." - Cormac's Glossary
+ * ============================================================
+ */
+
+/*
+ * Calculate sunset time for a given Julian Day and latitude
+ * Returns hours after midnight (local solar time)
+ * Uses simplified sunrise equation
+ */
+double ref_calculate_sunset(long jd, double latitude)
+{
+    /* Days since J2000.0 */
+    double d = jd - 2451545.0;
+
+    /* Sun's mean anomaly */
+    double g = fmod(357.529 + 0.98560028 * d, 360.0);
+    if (g < 0) g += 360.0;
+    double g_rad = g * PI / 180.0;
+
+    /* Sun's mean longitude */
+    double L = fmod(280.459 + 0.98564736 * d, 360.0);
+    if (L < 0) L += 360.0;
+
+    /* Ecliptic longitude */
+    double lambda = L + 1.915 * sin(g_rad) + 0.020 * sin(2 * g_rad);
+    lambda = fmod(lambda, 360.0);
+    if (lambda < 0) lambda += 360.0;
+    double lambda_rad = lambda * PI / 180.0;
+
+    /* Obliquity of ecliptic */
+    double epsilon = 23.439 - 0.0000004 * d;
+    double epsilon_rad = epsilon * PI / 180.0;
+
+    /* Solar declination */
+    double delta = asin(sin(epsilon_rad) * sin(lambda_rad));
+
+    /* Hour angle at sunset (-0.833° for atmospheric refraction) */
+    double lat_rad = latitude * PI / 180.0;
+    double cos_H = (sin(-0.833 * PI / 180.0) - sin(lat_rad) * sin(delta))
+                   / (cos(lat_rad) * cos(delta));
+
+    /* Clamp for polar regions */
+    if (cos_H > 1.0) return 12.0;   /* No sunset - return noon */
+    if (cos_H < -1.0) return 24.0;  /* No sunrise - return midnight */
+
+    /* Hour angle in hours */
+    double H = acos(cos_H) * 180.0 / PI / 15.0;
+
+    /* Sunset time = solar noon + hour angle */
+    /* Solar noon is approximately 12:00 local solar time */
+    double sunset_hour = 12.0 + H;
+
+
+    return sunset_hour;
+}
+
+/*
+ * Check if current time is after sunset (i.e., Celtic "next day")
+ * Returns 1 if after sunset, 0 if before
+ */
+int ref_is_after_sunset(long jd, double current_hour, double latitude)
+{
+    double sunset_hour = ref_calculate_sunset(jd, latitude);
+    return (current_hour >= sunset_hour) ? 1 : 0;
+}
+
+/*
+ * Get the Celtic day (accounting for sunset start)
+ * If after sunset, we're in the next Celtic day
+ */
+long ref_celtic_jd_from_time(long jd, double current_hour, double latitude)
+{
+    if (ref_is_after_sunset(jd, current_hour, latitude)) {
+        return jd + 1;  /* After sunset = next Celtic day */
+    }
+    return jd;
+}
+
+/*
+ * Get sunset time as hours:minutes string
+ */
+void ref_get_sunset_time_str(long jd, double latitude, char *buffer, int buf_size)
+{
+    double hours = ref_calculate_sunset(jd, latitude);
+    int h = (int)hours;
+    int m = (int)((hours - h) * 60.0);
+    snprintf(buffer, buf_size, "%02d:%02d", h, m);
+}
+
+/*
+ * ============================================================
+ * METONIC CYCLE (19-Year Lunisolar Synchronization)
+ *
+ * The Metonic cycle is the period after which the phases of the
+ * Moon recur on the same day of the solar year:
+ *   - 19 tropical years ≈ 6939.602 days
+ *   - 235 synodic months ≈ 6939.688 days
+ *   - Difference: only ~2 hours over 19 years!
+ *
+ * Reference: First Metonic cycle of our era began at the
+ * new moon closest to the vernal equinox of year 1 CE.
+ * ============================================================
+ */
+
+#define METONIC_YEARS 19
+#define METONIC_MONTHS 235
+#define METONIC_DAYS 6939.688
+#define SYNODIC_MONTH 29.53058867
+
+/* Reference: New Moon near vernal equinox, ~March 23, 1 CE = JD 1721424 */
+#define METONIC_EPOCH_JD 1721424L
+
+/*
+ * Get the current position in the Metonic cycle
+ * Returns: year within cycle (1-19)
+ */
+int ref_metonic_year(long jd)
+{
+    double cycles = (jd - METONIC_EPOCH_JD) / METONIC_DAYS;
+    double position = fmod(cycles, 1.0);
+    if (position < 0) position += 1.0;
+    return (int)(position * METONIC_YEARS) + 1;
+}
+
+/*
+ * Get the current lunation number within the Metonic cycle
+ * Returns: lunation (1-235)
+ */
+int ref_metonic_lunation(long jd)
+{
+    double cycles = (jd - METONIC_EPOCH_JD) / METONIC_DAYS;
+    double position = fmod(cycles, 1.0);
+    if (position < 0) position += 1.0;
+    return (int)(position * METONIC_MONTHS) + 1;
+}
+
+/*
+ * Get the total number of Metonic cycles since epoch
+ */
+int ref_metonic_cycle_number(long jd)
+{
+    return (int)((jd - METONIC_EPOCH_JD) / METONIC_DAYS) + 1;
+}
+
+/*
+ * Calculate drift from ideal Metonic alignment (in hours)
+ * Positive = ahead of moon, Negative = behind
+ */
+double ref_metonic_drift_hours(long jd)
+{
+    int cycle = ref_metonic_cycle_number(jd);
+    /* Each cycle drifts by ~0.086 days = ~2.07 hours */
+    return cycle * 2.07;
+}
+
+/*
+ * ============================================================
+ * PLEIADES HELIACAL RISING
+ *
+ * The heliacal rising of the Pleiades (when they first become
+ * visible before dawn after being hidden by the sun) was a
+ * crucial astronomical marker for many ancient cultures.
+ *
+ * For the Celts, Samhain may have been timed to coincide with
+ * the heliacal rising of the Pleiades in late October/early
+ * November.
+ *
+ * The Pleiades have an ecliptic longitude of ~60° (in Taurus).
+ * Heliacal rising occurs when the Sun is ~15-18° below them.
+ * ============================================================
+ */
+
+#define PLEIADES_LONGITUDE 60.0  /* Ecliptic longitude in degrees */
+#define HELIACAL_OFFSET 17.0     /* Sun degrees below for visibility */
+
+/*
+ * Check if today is near the heliacal rising of the Pleiades
+ * Returns: days until/since heliacal rising (negative = past)
+ */
+int ref_days_to_pleiades_rising(long jd)
+{
+    double sun_long = ref_sun_longitude(jd);
+
+    /* Heliacal rising when Sun is ~17° behind Pleiades */
+    double rising_sun_long = PLEIADES_LONGITUDE - HELIACAL_OFFSET;
+    if (rising_sun_long < 0) rising_sun_long += 360.0;
+
+    /* Calculate angular distance */
+    double diff = rising_sun_long - sun_long;
+    if (diff > 180.0) diff -= 360.0;
+    if (diff < -180.0) diff += 360.0;
+
+    /* Convert to days (sun moves ~1°/day) */
+    return (int)(diff);
+}
+
+/*
+ * Check if Pleiades are currently in heliacal rising period
+ * Returns: 1 if within ±3 days of heliacal rising
+ */
+int ref_is_pleiades_rising(long jd)
+{
+    int days = ref_days_to_pleiades_rising(jd);
+    return (days >= -3 && days <= 3) ? 1 : 0;
+}
+
+/*
+ * ============================================================
+ * TRUE CROSS-QUARTER DAYS
+ *
+ * The astronomical cross-quarter days are the exact midpoints
+ * between solstices and equinoxes:
+ *   - Samhain: midpoint between Autumn Equinox & Winter Solstice (~225°)
+ *   - Imbolc: midpoint between Winter Solstice & Vernal Equinox (~315°)
+ *   - Beltane: midpoint between Vernal Equinox & Summer Solstice (~45°)
+ *   - Lughnasadh: midpoint between Summer Solstice & Autumn Equinox (~135°)
+ *
+ * These differ from the traditional calendar dates by several days.
+ * ============================================================
+ */
+
+/* Solar longitudes for astronomical events */
+#define WINTER_SOLSTICE  270.0
+#define VERNAL_EQUINOX   0.0
+#define SUMMER_SOLSTICE  90.0
+#define AUTUMN_EQUINOX   180.0
+
+/* True cross-quarter points (midpoints between quarter days) */
+#define SAMHAIN_LONGITUDE    225.0  /* (180 + 270) / 2 */
+#define IMBOLC_LONGITUDE     315.0  /* (270 + 360) / 2 */
+#define BELTANE_LONGITUDE    45.0   /* (0 + 90) / 2 */
+#define LUGHNASADH_LONGITUDE 135.0  /* (90 + 180) / 2 */
+
+/*
+ * Calculate days until a specific solar longitude
+ * Returns: days until sun reaches target longitude (can be negative if past)
+ */
+int ref_days_to_solar_longitude(long jd, double target_longitude)
+{
+    double sun_long = ref_sun_longitude(jd);
+
+    double diff = target_longitude - sun_long;
+    if (diff > 180.0) diff -= 360.0;
+    if (diff < -180.0) diff += 360.0;
+
+    /* Sun moves ~0.9856° per day; round to nearest day to avoid double-counting */
+    double days = diff / 0.9856;
+    return (int)lround(days);
+}
+
+/*
+ * Get days to next astronomical Samhain (true cross-quarter)
+ */
+int ref_days_to_true_samhain(long jd)
+{
+    return ref_days_to_solar_longitude(jd, SAMHAIN_LONGITUDE);
+}
+
+/*
+ * Get days to next astronomical Imbolc
+ */
+int ref_days_to_true_imbolc(long jd)
+{
+    return ref_days_to_solar_longitude(jd, IMBOLC_LONGITUDE);
+}
+
+/*
+ * Get days to next astronomical Beltane
+ */
+int ref_days_to_true_beltane(long jd)
+{
+    return ref_days_to_solar_longitude(jd, BELTANE_LONGITUDE);
+}
+
+/*
+ * Get days to next astronomical Lughnasadh
+ */
+int ref_days_to_true_lughnasadh(long jd)
+{
+    return ref_days_to_solar_longitude(jd, LUGHNASADH_LONGITUDE);
+}
+
+/*
+ * Get the nearest cross-quarter event and days to it
+ * Returns: 0=Samhain, 1=Imbolc, 2=Beltane, 3=Lughnasadh
+ */
+int ref_nearest_cross_quarter(long jd, int *days_to_event)
+{
+    int sam = ref_days_to_true_samhain(jd);
+    int imb = ref_days_to_true_imbolc(jd);
+    int bel = ref_days_to_true_beltane(jd);
+    int lug = ref_days_to_true_lughnasadh(jd);
+
+    /* Make all positive (days until) */
+    if (sam < 0) sam += 365;
+    if (imb < 0) imb += 365;
+    if (bel < 0) bel += 365;
+    if (lug < 0) lug += 365;
+
+    /* Find minimum */
+    int min_days = sam;
+    int event = 0;
+
+    if (imb < min_days) { min_days = imb; event = 1; }
+    if (bel < min_days) { min_days = bel; event = 2; }
+    if (lug < min_days) { min_days = lug; event = 3; }
+
+    *days_to_event = min_days;
+    return event;
+}
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════════
+ * SOLILUNAR FESTIVAL CALCULATIONS
+ * The Celtic festivals were likely solilunar - combining solar position with
+ * lunar phase. The festival occurs when:
+ *   - Sun reaches the cross-quarter longitude (e.g., 225° for Samhain)
+ *   - AND Moon is at Full or New (or nearest such phase)
+ * ═══════════════════════════════════════════════════════════════════════════
+ */
+
+/*
+ * Find the JD of solilunar Samhain for a given Gregorian year
+ * Returns the Full Moon nearest to when Sun is at 225°
+ */
+long ref_find_solilunar_samhain(int greg_year)
+{
+    /* Find when sun reaches 225° */
+    long jd_nov1 = ref_jd_from_ymd(greg_year, 11, 1);
+    long jd_solar = jd_nov1;
+
+    for (int d = 0; d < 20; d++) {
+        double sun = ref_sun_longitude(jd_nov1 + d);
+        if (sun >= 224.5 && sun <= 225.5) {
+            jd_solar = jd_nov1 + d;
+            break;
+        }
+    }
+
+    /* Check if Full Moon or New Moon falls on solar Samhain (perfect alignment) */
+    int phase = ref_moon_phase(jd_solar);
+    if (phase == 4 || phase == 0) {
+        return jd_solar;  /* Perfect solilunar alignment! */
+    }
+
+    /* Find Full Moon nearest to solar Samhain */
+    long jd_full = ref_find_full_moon_before(jd_solar + 10);
+
+    /* Distance from solar Samhain to full moon */
+    int days_to_full = (int)(jd_full - jd_solar);
+
+    /* If full moon is more than 7 days away, check previous full moon */
+    if (days_to_full > 7) {
+        long jd_prev_full = ref_find_full_moon_before(jd_solar - 1);
+        int days_to_prev = (int)(jd_solar - jd_prev_full);
+        if (days_to_prev < days_to_full) {
+            jd_full = jd_prev_full;
+        }
+    }
+
+    return jd_full;
+}
+
+/*
+ * Check if a given JD is a solilunar festival (Sun at cross-quarter + significant moon)
+ * Returns: 0=not festival, 1=Full Moon alignment, 2=New Moon alignment
+ */
+int ref_is_solilunar_festival(long jd)
+{
+    double sun = ref_sun_longitude(jd);
+    int phase = ref_moon_phase(jd);
+
+    /* Check if sun is near any cross-quarter */
+    double cross_quarters[] = {225.0, 315.0, 45.0, 135.0};  /* Sam, Imb, Bel, Lug */
+
+    for (int i = 0; i < 4; i++) {
+        double diff = sun - cross_quarters[i];
+        if (diff > 180) diff -= 360;
+        if (diff < -180) diff += 360;
+
+        if (diff >= -2.0 && diff <= 2.0) {
+            /* Sun is at cross-quarter! Check moon */
+            if (phase == 4) return 1;  /* Full Moon */
+            if (phase == 0) return 2;  /* New Moon */
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Get days to next solilunar Samhain (Full Moon nearest Sun at 225°)
+ */
+int ref_days_to_solilunar_samhain(long jd)
+{
+    /* Get current Gregorian year */
+    long z = jd + 1;
+    long alpha = (long)((z - 1867216.25) / 36524.25);
+    long a = z + 1 + alpha - alpha/4;
+    long b = a + 1524;
+    long c = (long)((b - 122.1) / 365.25);
+    long dd = (long)(365.25 * c);
+    long e = (long)((b - dd) / 30.6001);
+    int greg_month = (e < 14) ? e - 1 : e - 13;
+    int greg_year = (greg_month > 2) ? c - 4716 : c - 4715;
+
+    /* Find solilunar Samhain for this year */
+    long jd_samhain = ref_find_solilunar_samhain(greg_year);
+
+    /* If already passed, find next year's */
+    if (jd_samhain < jd) {
+        jd_samhain = ref_find_solilunar_samhain(greg_year + 1);
+    }
+
+    return (int)(jd_samhain - jd);
+}
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════════
+ * SOLSTICES AND EQUINOXES (Quarter Days)
+ * ═══════════════════════════════════════════════════════════════════════════
+ */
+
+/*
+ * Days to Winter Solstice (Yule) - Sun at 270°
+ */
+int ref_days_to_yule(long jd)
+{
+    return ref_days_to_solar_longitude(jd, WINTER_SOLSTICE);
+}
+
+/*
+ * Days to Vernal Equinox (Ostara) - Sun at 0°
+ */
+int ref_days_to_ostara(long jd)
+{
+    return ref_days_to_solar_longitude(jd, VERNAL_EQUINOX);
+}
+
+/*
+ * Days to Summer Solstice (Litha) - Sun at 90°
+ */
+int ref_days_to_litha(long jd)
+{
+    return ref_days_to_solar_longitude(jd, SUMMER_SOLSTICE);
+}
+
+/*
+ * Days to Autumn Equinox (Mabon) - Sun at 180°
+ */
+int ref_days_to_mabon(long jd)
+{
+    return ref_days_to_solar_longitude(jd, AUTUMN_EQUINOX);
+}
+
+/*
+ * Get the nearest event from the eight-fold year
+ * Returns: 0-7 for the eight festivals
+ * 0=Yule, 1=Imbolc, 2=Ostara, 3=Beltane, 4=Litha, 5=Lughnasadh, 6=Mabon, 7=Samhain
+ */
+int ref_nearest_eightfold_event(long jd, int *days_to_event)
+{
+    int events[8];
+    events[0] = ref_days_to_yule(jd);        /* 270° */
+    events[1] = ref_days_to_true_imbolc(jd); /* 315° */
+    events[2] = ref_days_to_ostara(jd);      /* 0° */
+    events[3] = ref_days_to_true_beltane(jd);/* 45° */
+    events[4] = ref_days_to_litha(jd);       /* 90° */
+    events[5] = ref_days_to_true_lughnasadh(jd); /* 135° */
+    events[6] = ref_days_to_mabon(jd);       /* 180° */
+    events[7] = ref_days_to_true_samhain(jd);/* 225° */
+
+    /* Make all positive (days until next occurrence) */
+    for (int i = 0; i < 8; i++) {
+        if (events[i] < 0) events[i] += 365;
+    }
+
+    /* Find minimum */
+    int min_days = events[0];
+    int nearest = 0;
+
+    for (int i = 1; i < 8; i++) {
+        if (events[i] < min_days) {
+            min_days = events[i];
+            nearest = i;
+        }
+    }
+
+    *days_to_event = min_days;
+    return nearest;
+}
+
+
+/*
+ * Celtic Calendar Epoch and Cycle Constants
+ *
+ * The Coligny calendar uses a 5-year cycle (lustrum):
+ * - Normal year: 354 days (6×30 + 6×29)
+ * - Years 1 and 3 have a 30-day intercalary month = 384 days
+ * - 5-year cycle: 354 + 384 + 354 + 384 + 354 = 1830 days
+ *
+ * Epoch: Aligned with Kali Yuga (Vedic Tradition)
+ * Kali Yuga began February 17/18, 3102 BCE (JD 588465.5)
+ * Celtic Year 1 = Samhain 3102 BCE (approximately Nov 3102 BCE)
+ * We anchor Year 5127 to Nov 1, 2025 (JD 2460981)
+ * This aligns Celtic Year 1 with Kali Yuga Year 1
+ */
+
+#define ANCHOR_YEAR 5127        /* Celtic Year 5127 starts at Samhain of 2025 */
+#define ANCHOR_SAMHAIN_YEAR 2025/* Gregorian year whose Samhain anchors the Celtic year */
+
+#define AGE_YEARS 31            /* Years per Age (Saturnian cycle) */
+#define AGE_OFFSET (-16)        /* Offset to align age calculation */
+
+/*
+ * Cumulative days at start of each month (Giamos-first ordering)
+ * Order: Giamonios, Simivisonnos, Equos, Elembivios, Aedrinios, Cantlos,
+ *        Samonios, Dumannios, Riuros, Anagantios, Ogronnios, Cutios
+ * This labels the Samhain start month as Giamonios.
+ */
+static const int month_start[12] = {0, 29, 59, 88, 117, 147, 176, 206, 235, 265, 294, 324};
+
+/* Legacy cycle constants retained for documentation (unused) */
+/* static const int year_days_in_cycle[5] = {384, 354, 384, 354, 354}; */
+/* static const int cycle_year_start[5] = {0, 384, 738, 1122, 1476}; */
+
+/* Target solar longitude for Samhain */
+#define SAMHAIN_LONG 225.0
+
+/* Find the JD of Samhain (Sun ≈ 225°) for a given Gregorian year */
+static long ref_jd_true_samhain_for_year(int greg_year)
+{
+    long start = ref_jd_from_ymd(greg_year, 10, 15); /* search window Oct 15 */
+    double best_diff = 1e9;
+    long best_jd = start;
+    for (int d = 0; d <= 60; d++) {
+        long jd = start + d;
+        double diff = ref_sun_longitude(jd) - SAMHAIN_LONG;
+        if (diff > 180.0) diff -= 360.0;
+        if (diff < -180.0) diff += 360.0;
+        double ad = (diff < 0) ? -diff : diff;
+        if (ad < best_diff) {
+            best_diff = ad;
+            best_jd = jd;
+        }
+    }
+    return best_jd;
+}
+
+/* Convert JD to Gregorian year (rough, good enough for selecting Samhain year) */
+static int ref_gregorian_year_from_jd(long jd)
+{
+    long z = jd + 1;
+    long alpha = (long)((z - 1867216.25) / 36524.25);
+    long a = z + 1 + alpha - alpha/4;
+    long b = a + 1524;
+    long c = (long)((b - 122.1) / 365.25);
+    int greg_month = (int)(((b - (long)(365.25 * c)) / 30.6001) < 14 ? ((b - (long)(365.25 * c)) / 30.6001) - 1 : ((b - (long)(365.25 * c)) / 30.6001) - 13);
+    int greg_year = (greg_month > 2) ? (int)(c - 4716) : (int)(c - 4715);
+    return greg_year;
+}
+
+/* Get Samhain boundaries around a JD (solar Samhain ≈ 225°) */
+static void ref_samhain_bounds(long jd, long *prev_sam, long *next_sam, int *prev_sam_year)
+{
+    int gy = ref_gregorian_year_from_jd(jd);
+    long this_sam = ref_jd_true_samhain_for_year(gy);
+    if (jd < this_sam) {
+        *prev_sam_year = gy - 1;
+        *prev_sam = ref_jd_true_samhain_for_year(gy - 1);
+        *next_sam = this_sam;
+    } else {
+        *prev_sam_year = gy;
+        *prev_sam = this_sam;
+        *next_sam = ref_jd_true_samhain_for_year(gy + 1);
+    }
+}
+
+long ref_jd_from_ymd(int Y, int M, int D)
+{
+    if (M <= 2) { Y--; M += 12; }
+    int A = Y / 100;
+    int B = 2 - A + A / 4;
+    return (long)(365.25 * (Y + 4716)) +
+           (long)(30.6001 * (M + 1)) +
+           D + B - 1524;
+}
+
+
+/*
+ * Calculate Celtic year from Julian Day
+ * Uses the 5-year cycle for precision
+ */
+int ref_celtic_year_from_jd(long jd)
+{
+    long prev_sam, next_sam;
+    int prev_year;
+    ref_samhain_bounds(jd, &prev_sam, &next_sam, &prev_year);
+    int delta_years = prev_year - ANCHOR_SAMHAIN_YEAR;
+    return ANCHOR_YEAR + delta_years;
+}
+
+/*
+ * Calculate day of year (1-354 or 1-384 for intercalary years)
+ */
+int ref_day_of_year(long jd)
+{
+    long prev_sam, next_sam;
+    int prev_year;
+    ref_samhain_bounds(jd, &prev_sam, &next_sam, &prev_year);
+    (void)prev_year;
+    return (int)(jd - prev_sam) + 1;
+}
+
+/*
+ * Helper: get year_in_cycle (0-4) from Celtic year number
+ * Uses ANCHOR_CYCLE_POS to correctly align cycle position
+ */
+/* Legacy placeholder; no longer used with Samhain-based year starts */
+/*
+ * Helper: get year_in_cycle (0-4) directly from JD
+ */
+/* Legacy placeholder; no longer used with Samhain-based year starts */
+/* Cycle helpers removed; Samhain-based year start replaces cycle math */
+
+/*
+ * Get the length of the current Celtic year
+ */
+int ref_current_year_length(long jd)
+{
+    long prev_sam, next_sam;
+    int prev_year;
+    ref_samhain_bounds(jd, &prev_sam, &next_sam, &prev_year);
+    (void)prev_year;
+    return (int)(next_sam - prev_sam);
+}
+
+/*
+ * Calculate month index (0-11, or 0-12 for intercalary years)
+ * For simplicity, we ignore intercalary month and use 0-11
+ */
+int ref_celtic_month_index(long jd)
+{
+    int doy = ref_day_of_year(jd);
+    for (int m = 11; m >= 0; m--) {
+        if (doy > month_start[m]) {
+            return m;
+        }
+    }
+    return 0;
+}
+
+int ref_day_of_month(long jd)
+{
+    int doy = ref_day_of_year(jd);
+    int month = ref_celtic_month_index(jd);
+    return doy - month_start[month];
+}
+
+long ref_jd_start_of_celtic_month(int year, int month)
+{
+    int samhain_year = ANCHOR_SAMHAIN_YEAR + (year - ANCHOR_YEAR);
+    long jd_year_start = ref_jd_true_samhain_for_year(samhain_year);
+    if (month > 0 && month < 12) {
+        jd_year_start += month_start[month];
+    }
+    return jd_year_start;
+}
+
+/*
+ * Get JD for start of a Celtic year (day 1, including intercalary if present)
+ */
+long ref_jd_start_of_celtic_year(int year)
+{
+    int samhain_year = ANCHOR_SAMHAIN_YEAR + (year - ANCHOR_YEAR);
+    return ref_jd_true_samhain_for_year(samhain_year);
+}
+
+double ref_elapsed_fraction(long jd)
+{
+    int day = ref_day_of_year(jd);
+    int year_len = ref_current_year_length(jd);
+    return (double)(day - 1) / (double)year_len;
+}
+
+int ref_days_remaining(long jd)
+{
+    return ref_current_year_length(jd) - ref_day_of_year(jd);
+}
+
+void ref_age_and_year_in_age(long jd, int *age, int *year_in_age)
+{
+    int year = ref_celtic_year_from_jd(jd);
+    int adjusted = year + AGE_OFFSET;
+    *age = adjusted / AGE_YEARS;
+    *year_in_age = (adjusted - 1) % AGE_YEARS + 1;
+}
+
+
+const char *ref_get_celtic_month_name(int month_index)
+{
+    static const char *months[] = {
+        "Giamonios", "Simivisonnos", "Equos", "Elembivios",
+        "Aedrinios", "Cantlos", "Samonios", "Dumannios",
+        "Riuros", "Anagantios", "Ogronnios", "Cutios"
+    };
+    if (month_index == -1) return "Quimonios";  /* Intercalary month */
+    if(month_index < 0 || month_index > 11) return "Unknown";
+    return months[month_index];
+}
+
+
+const char *ref_get_month_abbrev(int month_index)
+{
+    static const char *abbrevs[] = {
+        "GIA", "SIM", "EQU", "ELE", "AED", "CAN",
+        "SAM", "DUM", "RIV", "ANA", "OGR", "CUT"
+    };
+    if (month_index == -1) return "QUI";  /* Intercalary month */
+    if(month_index < 0 || month_index > 11) return "???";
+    return abbrevs[month_index];
+}
+
+/*
+ * MAT (good/auspicious) months: SAM, RIV, OGR, CUT, SIM, AED
+ * ANM (not good) months: DUM, ANA, GIA, EQU, ELE, CAN
+ * Summer season (SAM-CUT) has 4 MAT, Winter (GIA-CAN) has 2 MAT
+ */
+int ref_is_mat_month(int month_index)
+{
+    /* MAT months in Giamos-first order: SIM, AED, SAM, RIV, OGR, CUT */
+    static const int mat[] = {0, 1, 0, 0, 1, 0, 1, 0, 1, 0, 1, 1};
+    if(month_index < 0 || month_index > 11) return 0;
+    return mat[month_index];
+}
+
+/*
+ * Authentic Coligny month lengths:
+ * 30 days: SAM, RIV, OGR, CUT, SIM, AED (MAT months)
+ * 29 days: DUM, ANA, GIA, ELE, CAN (ANM months)
+ * Variable: EQU (29 or 30, we use 29 by default)
+ */
+int ref_get_month_days(int month_index)
+{
+    /* Authentic lengths rotated so Giamonios opens the year */
+    static const int days[] = {29, 30, 29, 29, 30, 29, 30, 29, 30, 29, 30, 30};
+    if(month_index < 0 || month_index > 11) return 30;
+    return days[month_index];
+}
+
+/*
+ * ATENOUX divides month at day 15/16. Days 1-15 are first coicíse,
+ * days 16-29/30 are second coicíse (after ATENOUX "renewal")
+ */
+int ref_is_atenoux(int day_of_month)
+{
+    return (day_of_month > 15) ? 1 : 0;
+}
+
+/*
+ * D AMB (D AMBRIX RI) - inauspicious days pattern from Coligny:
+ * First half (1-15): Days 5 and 11 only
+ * Second half (16-30): Every odd day EXCEPT day 16 (=day 1a) */
+int ref_is_d_amb(int day_of_month)
+{
+    if (day_of_month <= 15) {
+        /* First coicíse: only days 5 and 11 are D AMB */
+        return (day_of_month == 5 || day_of_month == 11) ? 1 : 0;
+    } else {
+        /* Second coicíse (after ATENOUX): odd days except 16 (=day 1a) */
+        if (day_of_month == 16) return 0;  /* Day 16 (1a) not inauspicious */
+        return (day_of_month % 2 == 1) ? 1 : 0;  /* Odd days */
+    }
+}
+
+
+/*
+ * Check if a given day falls within a multi-day festival
+ * Returns: festival index (0-7) or -1 if not a festival day
+ */
+int ref_get_multi_festival(int month, int day)
+{
+    for (int i = 0; i < MULTI_FESTIVAL_COUNT; i++) {
+        if (month == multi_festivals[i].month) {
+            int start = multi_festivals[i].start_day;
+            int end = start + multi_festivals[i].duration - 1;
+            if (day >= start && day <= end) {
+                return i;
+            }
+        }
+    }
+    return -1;
+}
+
+/*
+ * Get the day number within a multi-day festival (1, 2, 3...)
+ */
+int ref_get_festival_day_number(int month, int day)
+{
+    for (int i = 0; i < MULTI_FESTIVAL_COUNT; i++) {
+        if (month == multi_festivals[i].month) {
+            int start = multi_festivals[i].start_day;
+            int end = start + multi_festivals[i].duration - 1;
+            if (day >= start && day <= end) {
+                return day - start + 1;
+            }
+        }
+    }
+    return 0;
+}
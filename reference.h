@@ -0,0 +1,69 @@
+#ifndef REFERENCE_H
+#define REFERENCE_H
+
+/*
+ * Reference engine (reference.c): the original brute-force implementations
+ * of the public calendar, astronomy and festival functions, one ref_ twin
+ * per function. Same signatures and results the optimised engine must
+ * reproduce; test_engines.c sweeps both and reports any difference.
+ */
+
+/* astronomy.h */
+int ref_moon_phase(long jd);
+int ref_sun_sign(long jd);
+int ref_moon_sign(long jd);
+double ref_sun_longitude(long jd);
+long ref_find_full_moon_before(long jd);
+int ref_lunar_day_of_month(long jd);
+int ref_lunar_month_length(long jd);
+long ref_find_samonios_start(int greg_year);
+int ref_lunar_celtic_month_index(long jd);
+double ref_calculate_sunset(long jd, double latitude);
+int ref_is_after_sunset(long jd, double current_hour, double latitude);
+long ref_celtic_jd_from_time(long jd, double current_hour, double latitude);
+void ref_get_sunset_time_str(long jd, double latitude, char *buffer, int buf_size);
+int ref_metonic_year(long jd);
+int ref_metonic_lunation(long jd);
+int ref_metonic_cycle_number(long jd);
+double ref_metonic_drift_hours(long jd);
+int ref_days_to_pleiades_rising(long jd);
+int ref_is_pleiades_rising(long jd);
+int ref_days_to_solar_longitude(long jd, double target_longitude);
+int ref_days_to_true_samhain(long jd);
+int ref_days_to_true_imbolc(long jd);
+int ref_days_to_true_beltane(long jd);
+int ref_days_to_true_lughnasadh(long jd);
+int ref_nearest_cross_quarter(long jd, int *days_to_event);
+long ref_find_solilunar_samhain(int greg_year);
+int ref_is_solilunar_festival(long jd);
+int ref_days_to_solilunar_samhain(long jd);
+int ref_days_to_yule(long jd);
+int ref_days_to_ostara(long jd);
+int ref_days_to_litha(long jd);
+int ref_days_to_mabon(long jd);
+int ref_nearest_eightfold_event(long jd, int *days_to_event);
+
+/* calendar.h */
+long ref_jd_from_ymd(int Y, int M, int D);
+int ref_celtic_year_from_jd(long jd);
+int ref_day_of_year(long jd);
+int ref_day_of_month(long jd);
+int ref_celtic_month_index(long jd);
+long ref_jd_start_of_celtic_month(int year, int month);
+long ref_jd_start_of_celtic_year(int year);
+double ref_elapsed_fraction(long jd);
+int ref_days_remaining(long jd);
+int ref_current_year_length(long jd);
+void ref_age_and_year_in_age(long jd, int *age, int *year_in_age);
+const char *ref_get_celtic_month_name(int month_index);
+int ref_is_mat_month(int month_index);
+int ref_get_month_days(int month_index);
+int ref_is_atenoux(int day_of_month);
+int ref_is_d_amb(int day_of_month);
+const char *ref_get_month_abbrev(int month_index);
+
+/* festivals.h */
+int ref_get_multi_festival(int month, int day);
+int ref_get_festival_day_number(int month, int day);
+
+#endif
@@ -0,0 +1,367 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <stdint.h>
+#include "search.h"
+#include "astronomy.h"
+#include "calendar.h"
+#include "festivals.h"
+#include "data.h"
+
+#define LUNAR_DAYS_MAX 30
+#define SUN_MAX_DAILY_MOTION 1.02   /* Degrees per day, at perihelion */
+#define PLEIADES_REACH 6.0          /* Days around the rising that is_pleiades_rising() can hold */
+
+static const char *phase_names[8] = {
+    "new", "waxing-crescent", "first-quarter", "waxing-gibbous",
+    "full", "waning-gibbous", "last-quarter", "waning-crescent"
+};
+
+static const char *sign_names[12] = {
+    "aries", "taurus", "gemini", "cancer", "leo", "virgo",
+    "libra", "scorpio", "sagittarius", "capricorn", "aquarius", "pisces"
+};
+
+/* By eight-fold id, as nearest_eightfold_event() */
+static const char *event_names[8] = {
+    "yule", "imbolc", "ostara", "beltane", "litha", "lughnasadh", "mabon", "samhain"
+};
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════════
+ * QUERY TERMS
+ * ═══════════════════════════════════════════════════════════════════════════
+ */
+void celtic_query_init(CelticQuery *q)
+{
+    memset(q, 0, sizeof(*q));
+    q->festival_id = -1;
+}
+
+static int name_equal(const char *a, const char *b)
+{
+    for (; *a && *b; a++, b++) {
+        if (tolower((unsigned char)*a) != tolower((unsigned char)*b)) return 0;
+    }
+    return *a == *b;
+}
+
+static int name_index(const char *name, const char *const *names, int count)
+{
+    for (int i = 0; i < count; i++) {
+        if (name_equal(name, names[i])) return i;
+    }
+    return -1;
+}
+
+/* Month bit of a name or abbreviation (bit 12 = Quimonios), -1 if unknown */
+static int month_bit(const char *name)
+{
+    for (int m = -1; m < 12; m++) {
+        if (name_equal(name, get_celtic_month_name(m)) || name_equal(name, get_month_abbrev(m)))
+            return coligny_row(m);
+    }
+    return -1;
+}
+
+/* Bits of "N" or "N-M" within 1..LUNAR_DAYS_MAX, 0 if malformed */
+static unsigned day_bits(const char *item)
+{
+    int lo, hi;
+    char tail;
+    int n = sscanf(item, "%d-%d%c", &lo, &hi, &tail);
+    if (n == 1) hi = lo;
+    else if (n != 2) return 0;
+    if (lo < 1 || hi > LUNAR_DAYS_MAX || lo > hi) return 0;
+
+    unsigned bits = 0;
+    for (int d = lo; d <= hi; d++) bits |= 1u << d;
+    return bits;
+}
+
+/* Parse a comma-separated list into a bit set; 0 if any item is unknown */
+static unsigned list_bits(const char *list, int (*bit_of)(const char *), unsigned (*bits_of)(const char *))
+{
+    unsigned bits = 0;
+    char item[48];
+    while (*list) {
+        size_t len = strcspn(list, ",");
+        if (len == 0 || len >= sizeof(item)) return 0;
+        memcpy(item, list, len);
+        item[len] = '\0';
+
+        if (bit_of) {
+            int bit = bit_of(item);
+            if (bit < 0) return 0;
+            bits |= 1u << bit;
+        } else {
+            unsigned b = bits_of(item);
+            if (!b) return 0;
+            bits |= b;
+        }
+        list += len;
+        if (*list == ',') list++;
+    }
+    return bits;
+}
+
+static int phase_bit(const char *name) { return name_index(name, phase_names, 8); }
+static int sign_bit(const char *name) { return name_index(name, sign_names, 12); }
+static int event_bit(const char *name) { return name_index(name, event_names, 8); }
+
+static int festival_id_of(const char *name)
+{
+    int total = multi_festival_total();
+    for (int id = 0; id < total; id++) {
+        const MultiFestival *f = multi_festival_by_id(id);
+        if (name_equal(name, f->name) || name_equal(name, f->coligny_name)) return id;
+    }
+    return -1;
+}
+
+int celtic_query_parse(CelticQuery *q, const char *term)
+{
+    const char *eq = strchr(term, '=');
+    if (eq) {
+        size_t key = (size_t)(eq - term);
+        const char *value = eq + 1;
+        unsigned bits;
+        if (key == 5 && strncmp(term, "month", 5) == 0) {
+            if (!(bits = list_bits(value, month_bit, NULL))) return -1;
+            q->months |= bits;
+        } else if (key == 3 && strncmp(term, "day", 3) == 0) {
+            if (!(bits = list_bits(value, NULL, day_bits))) return -1;
+            q->days |= bits;
+        } else if (key == 5 && strncmp(term, "phase", 5) == 0) {
+            if (!(bits = list_bits(value, phase_bit, NULL))) return -1;
+            q->phases |= bits;
+        } else if (key == 4 && strncmp(term, "sign", 4) == 0) {
+            if (!(bits = list_bits(value, sign_bit, NULL))) return -1;
+            q->signs |= bits;
+        } else if (key == 5 && strncmp(term, "event", 5) == 0) {
+            if (!(bits = list_bits(value, event_bit, NULL))) return -1;
+            q->events |= bits;
+        } else if (key == 8 && strncmp(term, "festival", 8) == 0) {
+            if ((q->festival_id = festival_id_of(value)) < 0) return -1;
+        } else {
+            return -1;
+        }
+        return 0;
+    }
+
+    if (strcmp(term, "event") == 0) {
+        q->events = 0xff;
+        return 0;
+    }
+    if (strcmp(term, "mat") == 0 || strcmp(term, "anm") == 0) {
+        q->mat = term[0] == 'm' ? SEARCH_YES : SEARCH_NO;
+        return 0;
+    }
+
+    SearchFlag flag = SEARCH_YES;
+    if (strncmp(term, "no-", 3) == 0) {
+        flag = SEARCH_NO;
+        term += 3;
+    }
+    if (strcmp(term, "atenoux") == 0) q->atenoux = flag;
+    else if (strcmp(term, "d-amb") == 0) q->d_amb = flag;
+    else if (strcmp(term, "festival") == 0) q->festival = flag;
+    else if (strcmp(term, "solilunar") == 0) q->solilunar = flag;
+    else if (strcmp(term, "pleiades") == 0) q->pleiades = flag;
+    else return -1;
+    return 0;
+}
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════════
+ * SEARCH PLAN
+ * The lunation-level terms are folded into one bit set of allowed days per
+ * (month row, lunation length), so a lunation is skipped or entered at its
+ * first wanted day with one mask operation.
+ * ═══════════════════════════════════════════════════════════════════════════
+ */
+typedef struct {
+    CelticQuery q;
+    int calendar;                       /* Any lunation-level term */
+    uint32_t day_mask[COLIGNY_ROWS][2]; /* [row][30-day lunation], bit d = lunar day d */
+} SearchPlan;
+
+static int flag_allows(SearchFlag flag, int value)
+{
+    return flag == SEARCH_ANY || (flag == SEARCH_YES) == (value != 0);
+}
+
+/* Returns 0 if the query can never match */
+static int compile_plan(SearchPlan *p, const CelticQuery *q)
+{
+    p->q = *q;
+    p->calendar = q->months || q->days || q->mat || q->atenoux || q->d_amb ||
+                  q->festival || q->festival_id >= 0;
+    if ((q->phases && !(q->phases & 0xff)) || (q->signs && !(q->signs & 0xfff)) ||
+        (q->events && !(q->events & 0xff)))
+        return 0;
+    if (!p->calendar) return 1;
+
+    int any = 0;
+    for (int row = 0; row < COLIGNY_ROWS; row++) {
+        int month = row == COLIGNY_QUIMONIOS_ROW ? -1 : row;
+        for (int full = 0; full < 2; full++) {
+            uint32_t mask = 0;
+            if ((!q->months || (q->months & (1u << row))) && flag_allows(q->mat, full)) {
+                for (int d = 1; d <= 29 + full; d++) {
+                    if (q->days && !(q->days & (1u << d))) continue;
+                    if (!flag_allows(q->atenoux, is_atenoux(d)) || !flag_allows(q->d_amb, is_d_amb(d))) continue;
+                    const FestivalIndexEntry *e = d < FESTIVAL_INDEX_DAYS ? festival_lookup(month, d) : NULL;
+                    int multi = e ? e->multi : -1;
+                    if (!flag_allows(q->festival, multi >= 0)) continue;
+                    if (q->festival_id >= 0 && multi != q->festival_id) continue;
+                    mask |= 1u << d;
+                }
+            }
+            p->day_mask[row][full] = mask;
+            any |= mask != 0;
+        }
+    }
+    return any;
+}
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════════
+ * SKIPS
+ * Each returns jd if its term holds on jd, otherwise a later day with no
+ * match for the term in between.
+ * ═══════════════════════════════════════════════════════════════════════════
+ */
+static int lowest_bit(uint32_t bits)
+{
+    return __builtin_ctz(bits);
+}
+
+/*
+ * Within a lunation the month changes at most once: a Samonios that opens
+ * in October is counted as Quimonios until 1 November (see
+ * lunar_samhain_year()). A skip is taken only when the month at its target
+ * (or at the lunation's last day) is the one at jd.
+ */
+static long skip_calendar(const SearchPlan *p, long jd)
+{
+    long k = lunation_number(jd);
+    long start = jd_of_full_moon(k);
+    long next = jd_of_full_moon(k + 1);
+    int full = next - start >= 30;      /* As lunar_month_length() */
+    int month = lunar_celtic_month_index(jd);
+
+    int day = (int)(jd - start) + 1;
+    uint32_t bits = p->day_mask[coligny_row(month)][full] & ~((1u << day) - 1u);
+    long target = bits ? start + lowest_bit(bits) - 1 : next;
+    if (target == jd) return jd;
+
+    long last = bits ? target : next - 1;
+    if (last > jd && lunar_celtic_month_index(last) != month) return jd + 1;
+    return target;
+}
+
+static long skip_sign(unsigned signs, long jd)
+{
+    if (signs & (1u << sun_sign(jd))) return jd;
+
+    double lon = sun_longitude(jd);
+    double wait = 360.0;
+    for (int s = 0; s < 12; s++) {
+        if (!(signs & (1u << s))) continue;
+        double d = s * 30.0 - lon;
+        if (d <= 0.0) d += 360.0;
+        if (d < wait) wait = d;
+    }
+    long step = (long)floor(wait / SUN_MAX_DAILY_MOTION);
+    return jd + (step > 1 ? step : 1);
+}
+
+static long skip_events(unsigned events, long jd)
+{
+    for (;;) {
+        double at;
+        int e = next_eightfold_event(jd, &at);
+        long day = jd + lround(at - jd);    /* As nearest_eightfold_event() */
+        if (events & (1u << e)) return day;
+        jd = day + 1;
+    }
+}
+
+/* Next full or new moon inside a cross-quarter window, as is_solilunar_festival() */
+static long skip_solilunar(long jd)
+{
+    if (is_solilunar_festival(jd)) return jd;
+
+    int year, month, day;
+    ymd_from_jd(jd, &year, &month, &day);
+
+    double covered = jd;
+    for (int y = year - 1; y <= year + 1; y++) {
+        const EventYear *ey = event_year(y);
+        for (int q = 0; q < 4; q++) {
+            double lo = ey->cross_window[q][0], hi = ey->cross_window[q][1];
+            if (hi < jd + 1) continue;
+            long from = (long)ceil(lo);
+            if (from <= jd) from = jd + 1;
+            long hit = next_moon_phase(from, (1u << 0) | (1u << 4));
+            if (hit <= hi) return hit;
+            if (hi > covered) covered = hi;
+        }
+    }
+    return (long)floor(covered) + 1;
+}
+
+static long skip_pleiades(long jd)
+{
+    if (is_pleiades_rising(jd)) return jd;
+
+    int year, month, day;
+    ymd_from_jd(jd, &year, &month, &day);
+    for (int y = year - 1; y <= year + 1; y++) {
+        double rising = event_year(y)->pleiades_rising;
+        if (rising + PLEIADES_REACH < jd + 1) continue;
+        long from = (long)ceil(rising - PLEIADES_REACH);
+        return from > jd ? from : jd + 1;
+    }
+    return jd + 1;
+}
+
+/* Sparse terms first: their skips are the longest */
+static long advance(const SearchPlan *p, long jd)
+{
+    const CelticQuery *q = &p->q;
+    long next;
+
+    if (q->events && (next = skip_events(q->events, jd)) != jd) return next;
+    if (q->solilunar == SEARCH_YES && (next = skip_solilunar(jd)) != jd) return next;
+    if (q->pleiades == SEARCH_YES && (next = skip_pleiades(jd)) != jd) return next;
+    if (p->calendar && (next = skip_calendar(p, jd)) != jd) return next;
+    if (q->phases && (next = next_moon_phase(jd, q->phases)) != jd) return next;
+    if (q->signs && (next = skip_sign(q->signs, jd)) != jd) return next;
+    if (q->solilunar == SEARCH_NO && is_solilunar_festival(jd)) return jd + 1;
+    if (q->pleiades == SEARCH_NO && is_pleiades_rising(jd)) return jd + 1;
+    return jd;
+}
+
+long celtic_search(const CelticQuery *q, long jd_first, long jd_last, CelticMatchFn fn, void *ctx)
+{
+    SearchPlan plan;
+    if (!compile_plan(&plan, q)) return 0;
+
+    long found = 0;
+    long jd = jd_first;
+    while (jd <= jd_last) {
+        long next = advance(&plan, jd);
+        if (next != jd) {
+            jd = next;
+            continue;
+        }
+        found++;
+        if (fn && fn(jd, ctx)) break;
+        jd++;
+    }
+    return found;
+}
@@ -0,0 +1,63 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+/*
+ * Day search: every day in a range that satisfies all the terms of a query.
+ *
+ * Calendar terms follow the lunar-synced months the views and --range use
+ * (month = lunar_celtic_month_index(), day = lunar_day_of_month(), MAT = a
+ * 30-day lunation, festivals looked up by that month and day). Each term
+ * knows the next day it can hold on (the next wanted day of this lunation
+ * or the next lunation, the next wanted moon octant, the next cross-quarter
+ * window or eight-fold event of the year), and the search jumps straight
+ * to the latest of those until every term agrees, so sparse queries cost
+ * a few evaluations per match rather than one per day.
+ */
+typedef enum {
+    SEARCH_ANY = 0,
+    SEARCH_YES,
+    SEARCH_NO
+} SearchFlag;
+
+typedef struct {
+    unsigned months;      /* Bit m = lunar month m (0-11), bit 12 = Quimonios; 0 = any */
+    unsigned days;        /* Bit d = lunar day d (1-30); 0 = any */
+    SearchFlag mat;       /* YES = MAT (30-day) lunation, NO = ANM */
+    SearchFlag atenoux;   /* Second half-month */
+    SearchFlag d_amb;
+    SearchFlag festival;  /* On a multi-day festival day */
+    int festival_id;      /* >= 0: on that festival (multi_festival_by_id()) */
+    unsigned phases;      /* Bit p = moon_phase() p; 0 = any */
+    unsigned signs;       /* Bit s = sun_sign() s; 0 = any */
+    unsigned events;      /* Bit e = eight-fold event e (0=Yule .. 7=Samhain) on the day */
+    SearchFlag solilunar; /* is_solilunar_festival() */
+    SearchFlag pleiades;  /* is_pleiades_rising() */
+} CelticQuery;
+
+/* Called per match in date order; return non-zero to stop the search */
+typedef int (*CelticMatchFn)(long jd, void *ctx);
+
+/* Empty query: matches every day */
+void celtic_query_init(CelticQuery *q);
+
+/*
+ * Add one term to a query; returns 0, or -1 if it is not understood.
+ *   month=NAME[,NAME..]   Samonios, SAM, Quimonios, ...
+ *   day=N[-M][,..]        lunar days
+ *   mat | anm | atenoux | d-amb | festival | solilunar | pleiades
+ *   festival=NAME         "Trinox Samoni", "TRINVX SAMONI", ...
+ *   phase=NAME[,..]       new, waxing-crescent, first-quarter, waxing-gibbous,
+ *                         full, waning-gibbous, last-quarter, waning-crescent
+ *   sign=NAME[,..]        aries .. pisces
+ *   event[=NAME[,..]]     yule, imbolc, ostara, beltane, litha, lughnasadh, mabon, samhain
+ * Flag terms take a "no-" prefix to exclude them (no-d-amb, no-festival, ...).
+ */
+int celtic_query_parse(CelticQuery *q, const char *term);
+
+/*
+ * Report every matching day in [jd_first, jd_last] to fn. Returns the
+ * number of matches reported (including the one that stopped the search).
+ */
+long celtic_search(const CelticQuery *q, long jd_first, long jd_last, CelticMatchFn fn, void *ctx);
+
+#endif
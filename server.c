@@ -0,0 +1,588 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include "server.h"
+#include "calendar.h"
+#include "astronomy.h"
+#include "festivals.h"
+#include "profile.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define SERVER_MAX_EVENTS 64
+#define SERVER_LINE_MAX 8192           /* Longest request line accepted */
+#define SERVER_OUT_HIGH_WATER (1 << 20) /* Stop reading a client with this much unsent output */
+#define SERVER_BACKLOG 128
+#define SERVER_BATCH_MAX 256           /* JDs or dates answered per request line */
+
+static const char *event_names[8] = {
+    "samhain", "yule", "imbolc", "ostara", "beltane", "litha", "lughnasadh", "mabon"
+};
+static const char *cross_quarter_names[4] = {"samhain", "imbolc", "beltane", "lughnasadh"};
+
+typedef struct Connection {
+    int fd;
+    int is_listener;
+    char in[SERVER_LINE_MAX];
+    size_t in_len;
+    char *out;
+    size_t out_len;
+    size_t out_sent;
+    size_t out_cap;
+    int closing;        /* Close once the output has drained */
+    int peer_eof;       /* Peer stopped sending; answer what is buffered */
+    unsigned events;    /* Current epoll interest */
+    struct Connection *prev, *next;   /* Open clients, closed on shutdown */
+} Connection;
+
+static Connection *clients;
+static int reserve_fd = -1;           /* Spare descriptor, given up to refuse a client */
+static int listeners_paused;          /* Listeners out of epoll until a client closes */
+
+static volatile sig_atomic_t server_stop = 0;
+static volatile sig_atomic_t server_reload = 0;
+
+static void handle_stop_signal(int sig)
+{
+    (void)sig;
+    server_stop = 1;
+}
+
+static void handle_reload_signal(int sig)
+{
+    (void)sig;
+    server_reload = 1;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * RESPONSES
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static int out_reserve(Connection *c, size_t n)
+{
+    if (c->out_sent > 0 && c->out_sent == c->out_len) {
+        c->out_len = c->out_sent = 0;
+    }
+    if (c->out_len + n <= c->out_cap) return 0;
+
+    size_t cap = c->out_cap ? c->out_cap : 4096;
+    while (cap < c->out_len + n) cap *= 2;
+    char *out = realloc(c->out, cap);
+    if (!out) return -1;
+    c->out = out;
+    c->out_cap = cap;
+    return 0;
+}
+
+static void out_printf(Connection *c, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+static void out_printf(Connection *c, const char *fmt, ...)
+{
+    char tmp[512];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(tmp, sizeof(tmp), fmt, ap);
+    va_end(ap);
+    if (n < 0) return;
+    if ((size_t)n >= sizeof(tmp)) n = (int)sizeof(tmp) - 1;
+
+    if (out_reserve(c, (size_t)n) != 0) {
+        c->closing = 1;
+        return;
+    }
+    memcpy(c->out + c->out_len, tmp, (size_t)n);
+    c->out_len += (size_t)n;
+}
+
+/* Replace a partly written response with an error line */
+static void reply_error(Connection *c, size_t mark, const char *reason)
+{
+    c->out_len = mark;
+    out_printf(c, "ERR %s\n", reason);
+}
+
+static void reply_date(Connection *c, char *args)
+{
+    char *save = NULL;
+    int count = 0;
+    out_printf(c, "OK");
+    if (c->closing) return;
+    size_t mark = c->out_len - 2;   /* Start of this response, for error rewinds */
+    for (char *tok = strtok_r(args, " \t", &save); tok; tok = strtok_r(NULL, " \t", &save)) {
+        if (count == SERVER_BATCH_MAX) {
+            reply_error(c, mark, "batch-too-long");
+            return;
+        }
+        char *end;
+        long jd = strtol(tok, &end, 10);
+        if (end == tok || *end) {
+            reply_error(c, mark, "bad-jd");
+            return;
+        }
+        CelticDate cd;
+        celtic_date_from_jd(jd, &cd);
+        out_printf(c, " %ld,%d,%d,%d,%d,%d,%d,%d", jd, cd.year, cd.day_of_year, cd.month_index,
+                   cd.day_of_month, lunar_celtic_month_index(jd), lunar_day_of_month(jd),
+                   lunar_month_length(jd) == 30);
+        count++;
+    }
+    out_printf(c, "\n");
+}
+
+static void reply_jd(Connection *c, char *args)
+{
+    char *save = NULL;
+    int count = 0;
+    out_printf(c, "OK");
+    if (c->closing) return;
+    size_t mark = c->out_len - 2;   /* Start of this response, for error rewinds */
+    for (char *tok = strtok_r(args, " \t", &save); tok; tok = strtok_r(NULL, " \t", &save)) {
+        if (count++ == SERVER_BATCH_MAX) {
+            reply_error(c, mark, "batch-too-long");
+            return;
+        }
+        int year, month, day;
+        char tail;
+        if (sscanf(tok, "%d-%d-%d%c", &year, &month, &day, &tail) != 3 ||
+            month < 1 || month > 12 || day < 1 || day > 31) {
+            reply_error(c, mark, "bad-date");
+            return;
+        }
+        out_printf(c, " %ld", jd_from_ymd(year, month, day));
+    }
+    out_printf(c, "\n");
+}
+
+/* CELTIC / LUNAR: Celtic dates <year>/<month>/<day> back to JDs (month -1 = Quimonios) */
+static void reply_celtic(Connection *c, char *args, int lunar)
+{
+    char *save = NULL;
+    int count = 0;
+    out_printf(c, "OK");
+    if (c->closing) return;
+    size_t mark = c->out_len - 2;   /* Start of this response, for error rewinds */
+    for (char *tok = strtok_r(args, " \t", &save); tok; tok = strtok_r(NULL, " \t", &save)) {
+        if (count++ == SERVER_BATCH_MAX) {
+            reply_error(c, mark, "batch-too-long");
+            return;
+        }
+        int year, month, day;
+        char tail;
+        if (sscanf(tok, "%d/%d/%d%c", &year, &month, &day, &tail) != 3) {
+            reply_error(c, mark, "bad-date");
+            return;
+        }
+        long jd;
+        int rc = lunar ? jd_from_lunar_celtic(year, month, day, &jd) : jd_from_celtic(year, month, day, &jd);
+        if (rc != 0) {
+            reply_error(c, mark, "no-such-day");
+            return;
+        }
+        out_printf(c, " %ld", jd);
+    }
+    out_printf(c, "\n");
+}
+
+static void reply_events(Connection *c, char *args)
+{
+    char *end;
+    long year = strtol(args, &end, 10);
+    while (*end == ' ' || *end == '\t') end++;
+    if (end == args || *end || year < -100000 || year > 100000) {
+        out_printf(c, "ERR usage: EVENTS <samhain_year>\n");
+        return;
+    }
+
+    const EventYear *ey = event_year((int)year);
+    out_printf(c, "OK year=%d", ey->samhain_year);
+    for (int i = 0; i < 8; i++) out_printf(c, " %s=%.5f", event_names[i], ey->solar[i]);
+    out_printf(c, " next_samhain=%.5f", ey->next_samhain);
+    for (int q = 0; q < 4; q++) out_printf(c, " solilunar_%s=%ld", cross_quarter_names[q], ey->solilunar[q]);
+    out_printf(c, " pleiades=%.5f samonios=%ld\n", ey->pleiades_rising, ey->samonios);
+}
+
+/* Festival file read again and swapped in; queries keep the old set until it lands */
+static int reload_festivals(char *reason, size_t size)
+{
+    int line;
+    int count = festivals_reload(&line);
+    if (count < 0) {
+        if (line && errno == E2BIG) snprintf(reason, size, "festival-limit-line-%d", line);
+        else if (line) snprintf(reason, size, "bad-festival-line-%d", line);
+        else snprintf(reason, size, "festival-file-%s", errno == ENOENT ? "missing" : "unreadable");
+    }
+    return count;
+}
+
+static void reply_reload(Connection *c)
+{
+    char reason[64];
+    int count = reload_festivals(reason, sizeof(reason));
+    if (count < 0) out_printf(c, "ERR %s\n", reason);
+    else out_printf(c, "OK festivals=%d\n", count);
+}
+
+static void reply_stats(Connection *c)
+{
+    if (!profile_enabled()) {
+        out_printf(c, "ERR profiling-not-compiled-in\n");
+        return;
+    }
+    char line[2048];
+    int n = profile_format_line(line, sizeof(line));
+    if (out_reserve(c, (size_t)n + 4) != 0) {
+        c->closing = 1;
+        return;
+    }
+    memcpy(c->out + c->out_len, "OK ", 3);
+    memcpy(c->out + c->out_len + 3, line, (size_t)n);
+    c->out[c->out_len + 3 + n] = '\n';
+    c->out_len += (size_t)n + 4;
+}
+
+static void handle_line(Connection *c, char *line)
+{
+    size_t len = strlen(line);
+    while (len && (line[len - 1] == '\r' || line[len - 1] == ' ')) line[--len] = '\0';
+
+    char *args = line;
+    while (*args && *args != ' ' && *args != '\t') args++;
+    if (*args) *args++ = '\0';
+
+    if (strcmp(line, "DATE") == 0)        reply_date(c, args);
+    else if (strcmp(line, "JD") == 0)     reply_jd(c, args);
+    else if (strcmp(line, "CELTIC") == 0) reply_celtic(c, args, 0);
+    else if (strcmp(line, "LUNAR") == 0)  reply_celtic(c, args, 1);
+    else if (strcmp(line, "EVENTS") == 0) reply_events(c, args);
+    else if (strcmp(line, "STATS") == 0)  reply_stats(c);
+    else if (strcmp(line, "RELOAD") == 0) reply_reload(c);
+    else if (strcmp(line, "PING") == 0)   out_printf(c, "OK PONG\n");
+    else if (strcmp(line, "QUIT") == 0)   c->closing = 1;
+    else if (*line)                       out_printf(c, "ERR unknown-command\n");
+}
+
+/* Answer every complete buffered line, pausing when the client stops reading */
+static void process_input(Connection *c)
+{
+    size_t start = 0;
+    while (!c->closing && c->out_len - c->out_sent < SERVER_OUT_HIGH_WATER) {
+        char *nl = memchr(c->in + start, '\n', c->in_len - start);
+        if (!nl) break;
+        *nl = '\0';
+        handle_line(c, c->in + start);
+        start = (size_t)(nl - c->in) + 1;
+    }
+    memmove(c->in, c->in + start, c->in_len - start);
+    c->in_len -= start;
+
+    if (c->in_len == sizeof(c->in)) {
+        out_printf(c, "ERR line-too-long\n");
+        c->closing = 1;
+    } else if (c->peer_eof && c->in_len && !c->closing && !memchr(c->in, '\n', c->in_len) &&
+               c->out_len - c->out_sent < SERVER_OUT_HIGH_WATER) {
+        /* The peer's last line had no newline: answer it like the others */
+        c->in[c->in_len] = '\0';
+        c->in_len = 0;
+        handle_line(c, c->in);
+    }
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * EVENT LOOP
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static void set_listeners(int ep, Connection *const *listeners, unsigned events)
+{
+    for (int i = 0; i < 2; i++) {
+        if (!listeners[i]) continue;
+        struct epoll_event ev = {.events = events, .data.ptr = listeners[i]};
+        epoll_ctl(ep, EPOLL_CTL_MOD, listeners[i]->fd, &ev);
+    }
+}
+
+static void connection_close(int ep, Connection *c, Connection *const *listeners)
+{
+    epoll_ctl(ep, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    if (c->prev) c->prev->next = c->next;
+    else clients = c->next;
+    if (c->next) c->next->prev = c->prev;
+    free(c->out);
+    free(c);
+
+    /* A descriptor is free again: take the reserve back, then new clients */
+    if (reserve_fd < 0) reserve_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    if (listeners_paused && reserve_fd >= 0) {
+        set_listeners(ep, listeners, EPOLLIN);
+        listeners_paused = 0;
+    }
+}
+
+static void connection_rearm(int ep, Connection *c)
+{
+    int pending = c->out_len > c->out_sent;
+    unsigned want = pending ? EPOLLOUT : 0;
+    if (!c->closing && !c->peer_eof && c->out_len - c->out_sent < SERVER_OUT_HIGH_WATER) {
+        want |= EPOLLIN | EPOLLRDHUP;
+    }
+
+    if (want != c->events) {
+        struct epoll_event ev = {.events = want, .data.ptr = c};
+        epoll_ctl(ep, EPOLL_CTL_MOD, c->fd, &ev);
+        c->events = want;
+    }
+}
+
+/* Returns -1 if the peer is gone */
+static int connection_flush(Connection *c)
+{
+    while (c->out_sent < c->out_len) {
+        ssize_t n = send(c->fd, c->out + c->out_sent, c->out_len - c->out_sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        c->out_sent += (size_t)n;
+    }
+    c->out_len = c->out_sent = 0;
+    return 0;
+}
+
+/* Returns -1 if the connection should be closed now */
+static int connection_read(Connection *c)
+{
+    for (;;) {
+        if (c->in_len == sizeof(c->in)) return 0;
+        ssize_t n = recv(c->fd, c->in + c->in_len, sizeof(c->in) - c->in_len, 0);
+        if (n > 0) {
+            c->in_len += (size_t)n;
+            process_input(c);
+            if (c->closing || c->out_len - c->out_sent >= SERVER_OUT_HIGH_WATER) return 0;
+            continue;
+        }
+        if (n == 0) {
+            c->peer_eof = 1;
+            return 0;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+        if (errno == EINTR) continue;
+        return -1;
+    }
+}
+
+static int add_listener(int ep, int fd, Connection **out)
+{
+    Connection *l = calloc(1, sizeof(Connection));
+    if (!l) return -1;
+    l->fd = fd;
+    l->is_listener = 1;
+    struct epoll_event ev = {.events = EPOLLIN, .data.ptr = l};
+    if (epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        free(l);
+        return -1;
+    }
+    *out = l;
+    return 0;
+}
+
+static int open_unix_listener(const char *path)
+{
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "server: socket path too long\n");
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, SERVER_BACKLOG) != 0) {
+        perror("server: unix socket");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* TCP is bound to loopback only; put a proxy in front for remote clients */
+static int open_tcp_listener(int port)
+{
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_port = htons((unsigned short)port)};
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, SERVER_BACKLOG) != 0) {
+        perror("server: tcp socket");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/*
+ * Out of descriptors, the pending connection would keep the level-triggered
+ * listener ready: give up the reserve to accept and drop it. Without a
+ * reserve, take the listeners out of epoll until a client closes.
+ */
+static int refuse_client(int ep, Connection *listener, Connection *const *listeners)
+{
+    if (reserve_fd >= 0) {
+        close(reserve_fd);
+        int fd = accept4(listener->fd, NULL, NULL, SOCK_CLOEXEC);
+        if (fd >= 0) close(fd);
+        reserve_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+        if (fd >= 0 && reserve_fd >= 0) return 0;
+    }
+    set_listeners(ep, listeners, 0);
+    listeners_paused = 1;
+    return -1;
+}
+
+static void accept_clients(int ep, Connection *listener, Connection *const *listeners)
+{
+    for (;;) {
+        int fd = accept4(listener->fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            if ((errno == EMFILE || errno == ENFILE) && refuse_client(ep, listener, listeners) == 0) continue;
+            return;   /* EAGAIN, or paused until a descriptor frees up */
+        }
+        Connection *c = calloc(1, sizeof(Connection));
+        if (!c) {
+            close(fd);
+            continue;
+        }
+        c->fd = fd;
+        c->events = EPOLLIN | EPOLLRDHUP;
+        struct epoll_event ev = {.events = c->events, .data.ptr = c};
+        if (epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            close(fd);
+            free(c);
+            continue;
+        }
+        c->next = clients;
+        if (clients) clients->prev = c;
+        clients = c;
+    }
+}
+
+int run_server(const char *unix_path, int tcp_port)
+{
+    if (!unix_path && tcp_port <= 0) {
+        fprintf(stderr, "server: nothing to listen on\n");
+        return -1;
+    }
+
+    int ep = epoll_create1(EPOLL_CLOEXEC);
+    if (ep < 0) {
+        perror("server: epoll");
+        return -1;
+    }
+
+    Connection *listeners[2] = {NULL, NULL};
+    int status = 0;
+    if (unix_path) {
+        int fd = open_unix_listener(unix_path);
+        if (fd < 0 || add_listener(ep, fd, &listeners[0]) != 0) status = -1;
+    }
+    if (status == 0 && tcp_port > 0) {
+        int fd = open_tcp_listener(tcp_port);
+        if (fd < 0 || add_listener(ep, fd, &listeners[1]) != 0) status = -1;
+    }
+
+    struct sigaction sa = {0};
+    sa.sa_handler = handle_stop_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    sa.sa_handler = handle_reload_signal;
+    sigaction(SIGHUP, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    /* Warm the cache every query starts from */
+    if (status == 0) samhain_cache_prefill();
+    reserve_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+
+    struct epoll_event events[SERVER_MAX_EVENTS];
+    while (status == 0 && !server_stop) {
+        /* No festival pointer outlives a request: retired sets can go */
+        festivals_quiescent();
+        int n = epoll_wait(ep, events, SERVER_MAX_EVENTS, -1);
+        if (n < 0 && errno != EINTR) {
+            perror("server: epoll_wait");
+            status = -1;
+            break;
+        }
+        if (server_reload) {
+            char reason[64];
+            server_reload = 0;
+            if (reload_festivals(reason, sizeof(reason)) < 0) fprintf(stderr, "server: reload: %s\n", reason);
+        }
+        if (n < 0) continue;
+
+        for (int i = 0; i < n; i++) {
+            Connection *c = events[i].data.ptr;
+            if (c->is_listener) {
+                accept_clients(ep, c, listeners);
+                continue;
+            }
+
+            int gone = 0;
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) gone = 1;
+            if (!gone && (events[i].events & (EPOLLIN | EPOLLRDHUP))) gone = connection_read(c) != 0;
+            if (!gone) {
+                /* Output drained below the high-water mark: resume buffered lines */
+                if (!c->closing && c->in_len) process_input(c);
+                gone = connection_flush(c) != 0;
+            }
+            if (!gone && c->out_len == c->out_sent &&
+                (c->closing || (c->peer_eof && !memchr(c->in, '\n', c->in_len)))) {
+                gone = 1;
+            }
+
+            if (gone) connection_close(ep, c, listeners);
+            else connection_rearm(ep, c);
+        }
+    }
+
+    while (clients) connection_close(ep, clients, listeners);
+    if (reserve_fd >= 0) close(reserve_fd);
+    reserve_fd = -1;
+    listeners_paused = 0;
+    for (int i = 0; i < 2; i++) {
+        if (!listeners[i]) continue;
+        close(listeners[i]->fd);
+        free(listeners[i]);
+    }
+    if (unix_path && listeners[0]) unlink(unix_path);
+    close(ep);
+    return status;
+}
+
+#else
+
+int run_server(const char *unix_path, int tcp_port)
+{
+    (void)unix_path;
+    (void)tcp_port;
+    fprintf(stderr, "server: --serve needs epoll (Linux)\n");
+    return -1;
+}
+
+#endif
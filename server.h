@@ -0,0 +1,28 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+/*
+ * Query daemon: keeps the Samhain, lunation and event-year caches warm and
+ * answers a line protocol over a Unix socket and/or a loopback TCP port.
+ * One epoll loop serves every connection; requests may be pipelined and are
+ * answered in order, one response line per request line (a last line the
+ * client ends with EOF instead of a newline included). Out of descriptors,
+ * new connections are accepted and closed at once.
+ *
+ *   PING                    -> OK PONG
+ *   JD <Y-M-D> ...          -> OK <jd> ...
+ *   DATE <jd> ...           -> OK <jd>,<year>,<day_of_year>,<month>,<day>,<lunar_month>,<lunar_day>,<mat> ...
+ *   CELTIC <y>/<m>/<d> ...  -> OK <jd> ...   (year, month_index, day_of_month as DATE)
+ *   LUNAR <y>/<m>/<d> ...   -> OK <jd> ...   (lunar month, -1 = Quimonios, and lunar day)
+ *   EVENTS <samhain_year>   -> OK year=<y> samhain=<jd> yule=<jd> ... samonios=<jd>
+ *   STATS                   -> OK <counter>=<count>/<ticks> ...   (CELTIC_PROFILE builds)
+ *   RELOAD                  -> OK festivals=<n>   (festival file read again, as on SIGHUP)
+ *   QUIT                    -> closes the connection
+ *
+ * Errors answer "ERR <reason>". Event times are fractional JDs.
+ */
+
+/* Serve until SIGINT/SIGTERM; unix_path may be NULL, tcp_port 0 to skip TCP */
+int run_server(const char *unix_path, int tcp_port);
+
+#endif
@@ -0,0 +1,998 @@
+/*
+ * test_engines — differential test of the calendar engine against the
+ * reference implementations kept in reference.c
+ *
+ * Every public calendar.h / astronomy.h / festivals.h function with a
+ * reference twin is evaluated on both engines over every day of the sweep
+ * (3102 BCE .. 3000 CE by default), every Samhain year of it for the
+ * year-keyed functions, and every month/day pair (valid or not) for the
+ * table lookups. Batch and composite APIs (ephemeris_span, solar_state,
+ * celtic_date_from_jd, celtic_dates_from_jd_array, festival_lookup and
+ * the day cursor) are checked against the per-value reference functions
+ * they replace; the inverse conversions are checked as round trips.
+ * celtic_search() is checked against a day-by-day evaluation of each
+ * query through the per-day calls its skips jump over, and the runs
+ * festival_rule_at() resolves per Samhain year against a search from the
+ * day itself for the crossing and full moon that would open its run.
+ *
+ * Some results changed on purpose when the fast paths replaced the daily
+ * approximations (exact crossings, one solar series); those checks carry
+ * a note and a bound, and differences within the bound are counted as
+ * divergences rather than mismatches.
+ *
+ * One line per check: samples, mismatches, divergences, worst difference,
+ * ns per call on each engine and the speedup; then the first few
+ * mismatching inputs. Exits 1 if any check mismatched.
+ *
+ * Usage: test_engines [-y FIRST:LAST] [-s stride-days] [-f name-substring]
+ *                     [-e ephemeris.eph]   (fast engine answers from a mapped file)
+ *
+ * The full sweep evaluates the reference engine's daily Samhain scans some
+ * 2.2 million times per check and takes a while; -s 7 or a narrower -y gives
+ * a quick pass.
+ */
+#define _XOPEN_SOURCE 700
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include "calendar.h"
+#include "astronomy.h"
+#include "festivals.h"
+#include "ephemeris.h"
+#include "reference.h"
+#include "cursor.h"
+#include "search.h"
+
+#define SWEEP_FIRST_YEAR   (-3101)   /* 3102 BCE (astronomical numbering) */
+#define SWEEP_LAST_YEAR    3000
+#define BATCH_SAMPLES      1024      /* Samples per batch API call */
+#define MISMATCH_REPORT    5         /* Mismatching inputs listed per check */
+#define ANCHOR_YEAR        5127      /* Celtic year opened by Samhain 2025 */
+#define ANCHOR_SAMHAIN_YEAR 2025
+
+/* Table lookups are swept over months -2..13 and days 0..40 */
+#define DOMAIN_MONTH_FIRST (-2)
+#define DOMAIN_MONTHS      16
+#define DOMAIN_DAYS        41
+
+/* astronomy.c's fixed-point series stays within 3e-7 deg of the double one */
+#ifdef CELTIC_FIXED_POINT
+#define LONGITUDE_TOLERANCE 3e-7
+#else
+#define LONGITUDE_TOLERANCE 1e-9
+#endif
+
+/* ephemeris.h quantizes longitudes to 1/65536 of a turn */
+#define EPHEMERIS_LONGITUDE_TOLERANCE (360.0 / 65536.0)
+
+typedef enum { SAMPLE_DAY, SAMPLE_YEAR, SAMPLE_DOMAIN } SampleKind;
+
+/* Both engines reduce one sample to a number; strings and structs are hashed */
+typedef double (*SampleFn)(long x);
+
+typedef struct {
+    const char *name;
+    SampleKind kind;
+    SampleFn ref;
+    SampleFn fast;
+    double tolerance;
+    int quantized;         /* Longitude from ephemeris records when one is loaded */
+    double bound;          /* Differences up to this are the documented divergence */
+    const char *divergence;
+} Check;
+
+typedef struct {
+    long first;
+    long last;
+    long stride;
+} Sweep;
+
+static Sweep day_sweep, year_sweep;
+static const Sweep domain_sweep = {0, DOMAIN_MONTHS * DOMAIN_DAYS - 1, 1};
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * SAMPLE HELPERS
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static int domain_month(long x)
+{
+    return (int)(x / DOMAIN_DAYS) + DOMAIN_MONTH_FIRST;
+}
+
+static int domain_day(long x)
+{
+    return (int)(x % DOMAIN_DAYS);
+}
+
+static int celtic_year_of(long greg_year)
+{
+    return ANCHOR_YEAR + (int)(greg_year - ANCHOR_SAMHAIN_YEAR);
+}
+
+/* FNV-1a over a list of ints, folded to 32 bits so the double is exact */
+static double hash_ints(const long *v, int n)
+{
+    unsigned long long h = 0xcbf29ce484222325ULL;
+    for (int i = 0; i < n; i++) {
+        unsigned long long x = (unsigned long long)v[i];
+        for (int b = 0; b < 8; b++) {
+            h ^= (x >> (b * 8)) & 0xff;
+            h *= 0x100000001b3ULL;
+        }
+    }
+    return (double)(unsigned)(h ^ (h >> 32));
+}
+
+static double hash_string(const char *s)
+{
+    unsigned h = 2166136261u;
+    for (; *s; s++) {
+        h ^= (unsigned char)*s;
+        h *= 16777619u;
+    }
+    return (double)h;
+}
+
+static double sunset_minutes(const char *hhmm)
+{
+    int h = 0, m = 0;
+    if (sscanf(hhmm, "%d:%d", &h, &m) != 2) return -1.0;
+    return h * 60.0 + m;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * PER-DAY CHECKS
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+#define DAY_PAIR(fn)                                                          \
+    static double ref_day_##fn(long jd) { return (double)ref_##fn(jd); }      \
+    static double fast_day_##fn(long jd) { return (double)fn(jd); }
+
+DAY_PAIR(moon_phase)
+DAY_PAIR(sun_sign)
+DAY_PAIR(moon_sign)
+DAY_PAIR(sun_longitude)
+DAY_PAIR(find_full_moon_before)
+DAY_PAIR(lunar_day_of_month)
+DAY_PAIR(lunar_month_length)
+DAY_PAIR(lunar_celtic_month_index)
+DAY_PAIR(metonic_year)
+DAY_PAIR(metonic_lunation)
+DAY_PAIR(metonic_cycle_number)
+DAY_PAIR(metonic_drift_hours)
+DAY_PAIR(days_to_pleiades_rising)
+DAY_PAIR(is_pleiades_rising)
+DAY_PAIR(days_to_true_samhain)
+DAY_PAIR(days_to_true_imbolc)
+DAY_PAIR(days_to_true_beltane)
+DAY_PAIR(days_to_true_lughnasadh)
+DAY_PAIR(is_solilunar_festival)
+DAY_PAIR(days_to_solilunar_samhain)
+DAY_PAIR(days_to_yule)
+DAY_PAIR(days_to_ostara)
+DAY_PAIR(days_to_litha)
+DAY_PAIR(days_to_mabon)
+DAY_PAIR(celtic_year_from_jd)
+DAY_PAIR(day_of_year)
+DAY_PAIR(day_of_month)
+DAY_PAIR(celtic_month_index)
+DAY_PAIR(elapsed_fraction)
+DAY_PAIR(days_remaining)
+DAY_PAIR(current_year_length)
+
+static double ref_day_solar_longitude_100(long jd) { return ref_days_to_solar_longitude(jd, 100.0); }
+static double fast_day_solar_longitude_100(long jd) { return days_to_solar_longitude(jd, 100.0); }
+
+/* Event id and countdown packed as event * 1000 + days */
+static double ref_day_nearest_cross_quarter(long jd)
+{
+    int days = 0;
+    int event = ref_nearest_cross_quarter(jd, &days);
+    return event * 1000.0 + days;
+}
+
+static double fast_day_nearest_cross_quarter(long jd)
+{
+    int days = 0;
+    int event = nearest_cross_quarter(jd, &days);
+    return event * 1000.0 + days;
+}
+
+static double ref_day_nearest_eightfold_event(long jd)
+{
+    int days = 0;
+    int event = ref_nearest_eightfold_event(jd, &days);
+    return event * 1000.0 + days;
+}
+
+static double fast_day_nearest_eightfold_event(long jd)
+{
+    int days = 0;
+    int event = nearest_eightfold_event(jd, &days);
+    return event * 1000.0 + days;
+}
+
+static double ref_day_age_and_year_in_age(long jd)
+{
+    int age = 0, year_in_age = 0;
+    ref_age_and_year_in_age(jd, &age, &year_in_age);
+    return age * 1000.0 + year_in_age;
+}
+
+static double fast_day_age_and_year_in_age(long jd)
+{
+    int age = 0, year_in_age = 0;
+    age_and_year_in_age(jd, &age, &year_in_age);
+    return age * 1000.0 + year_in_age;
+}
+
+/* Gregorian round trip: ymd_from_jd() picks the date, both engines map it back */
+static double ref_day_jd_from_ymd(long jd)
+{
+    int y, m, d;
+    ymd_from_jd(jd, &y, &m, &d);
+    return (double)ref_jd_from_ymd(y, m, d);
+}
+
+static double fast_day_jd_from_ymd(long jd)
+{
+    int y, m, d;
+    ymd_from_jd(jd, &y, &m, &d);
+    return (double)jd_from_ymd(y, m, d);
+}
+
+/* Celtic round trips: the forward conversion picks the date, the inverse maps it back */
+static double ref_day_identity(long jd) { return (double)jd; }
+
+static double fast_day_jd_from_celtic(long jd)
+{
+    CelticDate cd;
+    long back;
+    celtic_date_from_jd(jd, &cd);
+    return jd_from_celtic(cd.year, cd.month_index, cd.day_of_month, &back) == 0 ? (double)back : -1.0;
+}
+
+/* Lunar date as the year views number it: lunations past the year's last roll into the next */
+static double fast_day_jd_from_lunar_celtic(long jd)
+{
+    int samhain_year = lunar_samhain_year(jd);
+    const LunarYear *ly = lunar_year(samhain_year);
+    int k = lunar_year_month_of(ly, jd);
+    if (k >= ly->months) {
+        ly = lunar_year(++samhain_year);
+        k = lunar_year_month_of(ly, jd);
+    }
+    long back;
+    int month = (k > 11) ? -1 : (k + 6) % 12;
+    int rc = jd_from_lunar_celtic(celtic_year_of(samhain_year), month, lunar_day_of_month(jd), &back);
+    return rc == 0 ? (double)back : -1.0;
+}
+
+/* Sunsets on the sweep day at Coligny, the equator, Iceland and Tasmania */
+#define SUNSET_PAIR(tag, lat)                                                                   \
+    static double ref_day_sunset_##tag(long jd) { return ref_calculate_sunset(jd, lat); }        \
+    static double fast_day_sunset_##tag(long jd) { return calculate_sunset(jd, lat); }
+
+SUNSET_PAIR(coligny, 46.38)
+SUNSET_PAIR(equator, 0.0)
+SUNSET_PAIR(iceland, 64.15)
+SUNSET_PAIR(tasmania, -42.88)
+
+static double ref_day_is_after_sunset(long jd) { return ref_is_after_sunset(jd, 18.5, 46.38); }
+static double fast_day_is_after_sunset(long jd) { return is_after_sunset(jd, 18.5, 46.38); }
+
+static double ref_day_celtic_jd_from_time(long jd) { return (double)(ref_celtic_jd_from_time(jd, 19.25, 46.38) - jd); }
+static double fast_day_celtic_jd_from_time(long jd) { return (double)(celtic_jd_from_time(jd, 19.25, 46.38) - jd); }
+
+static double ref_day_sunset_time_str(long jd)
+{
+    char buf[16];
+    ref_get_sunset_time_str(jd, 46.38, buf, sizeof(buf));
+    return sunset_minutes(buf);
+}
+
+static double fast_day_sunset_time_str(long jd)
+{
+    char buf[16];
+    get_sunset_time_str(jd, 46.38, buf, sizeof(buf));
+    return sunset_minutes(buf);
+}
+
+/* solar_state() against the per-field functions */
+static double fast_day_solar_state_longitude(long jd)
+{
+    SolarState s;
+    solar_state(jd, &s);
+    return s.longitude;
+}
+
+static double fast_day_solar_state_sign(long jd)
+{
+    SolarState s;
+    solar_state(jd, &s);
+    return s.sign;
+}
+
+/* celtic_date_from_jd(): integer fields hashed, elapsed fraction on its own */
+static double ref_day_celtic_date(long jd)
+{
+    int age = 0, year_in_age = 0;
+    ref_age_and_year_in_age(jd, &age, &year_in_age);
+    int doy = ref_day_of_year(jd);
+    int month = ref_celtic_month_index(jd);
+    int dom = ref_day_of_month(jd);
+    long v[] = {
+        jd, jd - doy + 1, ref_celtic_year_from_jd(jd), doy, ref_current_year_length(jd),
+        ref_days_remaining(jd), month, dom, age, year_in_age,
+        ref_is_mat_month(month), ref_is_atenoux(dom), ref_is_d_amb(dom),
+    };
+    return hash_ints(v, (int)(sizeof(v) / sizeof(v[0])));
+}
+
+static double fast_day_celtic_date(long jd)
+{
+    CelticDate cd;
+    celtic_date_from_jd(jd, &cd);
+    long v[] = {
+        cd.jd, cd.year_start, cd.year, cd.day_of_year, cd.year_length,
+        cd.days_remaining, cd.month_index, cd.day_of_month, cd.age, cd.year_in_age,
+        cd.is_mat, cd.is_atenoux, cd.is_d_amb,
+    };
+    return hash_ints(v, (int)(sizeof(v) / sizeof(v[0])));
+}
+
+static double fast_day_celtic_date_elapsed(long jd)
+{
+    CelticDate cd;
+    celtic_date_from_jd(jd, &cd);
+    return cd.elapsed_fraction;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * BATCH CHECKS
+ * The fast side converts BATCH_SAMPLES sweep samples per call and serves
+ * the following samples from the batch, so the timing is per sample.
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static struct {
+    long first;            /* JD of span day 0, LONG_MIN if empty */
+    int days;
+    int phase[BATCH_SAMPLES];
+    double sunlong[BATCH_SAMPLES];
+    int moonsign[BATCH_SAMPLES];
+} span = {-2147483647L, 0, {0}, {0}, {0}};
+
+/* ephemeris_span() wants consecutive days; longer strides get one-day spans */
+static int span_index(long jd)
+{
+    if (jd < span.first || jd >= span.first + span.days) {
+        span.first = jd;
+        span.days = day_sweep.stride < BATCH_SAMPLES ? BATCH_SAMPLES : 1;
+        ephemeris_span(jd, span.days, span.phase, span.sunlong, span.moonsign);
+    }
+    return (int)(jd - span.first);
+}
+
+static double fast_day_span_phase(long jd) { return span.phase[span_index(jd)]; }
+static double fast_day_span_sunlong(long jd) { return span.sunlong[span_index(jd)]; }
+static double fast_day_span_moonsign(long jd) { return span.moonsign[span_index(jd)]; }
+
+static struct {
+    long first;
+    int count;
+    long jd[BATCH_SAMPLES];
+    int year[BATCH_SAMPLES];
+    int day_of_year[BATCH_SAMPLES];
+    int month_index[BATCH_SAMPLES];
+    int day_of_month[BATCH_SAMPLES];
+    int lunar_month[BATCH_SAMPLES];
+} column = {-2147483647L, 0, {0}, {0}, {0}, {0}, {0}, {0}};
+
+static int column_index(long jd)
+{
+    long i = (jd - column.first) / day_sweep.stride;
+    if (jd < column.first || i >= column.count) {
+        column.first = jd;
+        column.count = 0;
+        for (long d = jd; d <= day_sweep.last && column.count < BATCH_SAMPLES; d += day_sweep.stride)
+            column.jd[column.count++] = d;
+        CelticDateColumns out = {column.year, column.day_of_year, column.month_index,
+                                 column.day_of_month, column.lunar_month};
+        celtic_dates_from_jd_array(column.jd, (size_t)column.count, &out);
+        i = 0;
+    }
+    return (int)i;
+}
+
+static double ref_day_columns(long jd)
+{
+    long v[] = {ref_celtic_year_from_jd(jd), ref_day_of_year(jd), ref_celtic_month_index(jd),
+                ref_day_of_month(jd)};
+    return hash_ints(v, 4);
+}
+
+static double fast_day_columns(long jd)
+{
+    int i = column_index(jd);
+    long v[] = {column.year[i], column.day_of_year[i], column.month_index[i], column.day_of_month[i]};
+    return hash_ints(v, 4);
+}
+
+static double fast_day_columns_lunar(long jd)
+{
+    return column.lunar_month[column_index(jd)];
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * CURSOR CHECKS
+ * One cursor follows the sweep, so each sample is a step of the stride and
+ * the fields come from its spans rather than fresh lookups.
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static struct {
+    int valid;
+    CelticCursor c;
+} walk;
+
+static const CelticCursor *walk_to(long jd)
+{
+    if (!walk.valid) {
+        cursor_init(&walk.c, jd);
+        walk.valid = 1;
+    } else {
+        cursor_seek(&walk.c, jd);
+    }
+    return &walk.c;
+}
+
+static double fast_day_cursor_date(long jd)
+{
+    const CelticCursor *c = walk_to(jd);
+    long v[] = {
+        c->date.jd, c->date.year_start, c->date.year, c->date.day_of_year, c->date.year_length,
+        c->date.days_remaining, c->date.month_index, c->date.day_of_month, c->date.age,
+        c->date.year_in_age, c->date.is_mat, c->date.is_atenoux, c->date.is_d_amb,
+    };
+    return hash_ints(v, (int)(sizeof(v) / sizeof(v[0])));
+}
+
+static double fast_day_cursor_lunation(long jd) { return (double)walk_to(jd)->lunation_start; }
+static double fast_day_cursor_lunar_day(long jd) { return walk_to(jd)->lunar_day; }
+static double fast_day_cursor_month_length(long jd) { return walk_to(jd)->lunar_month_length; }
+static double fast_day_cursor_lunar_month(long jd) { return walk_to(jd)->lunar_month; }
+static double fast_day_cursor_metonic_year(long jd) { return walk_to(jd)->metonic_year; }
+static double fast_day_cursor_metonic_lunation(long jd) { return walk_to(jd)->metonic_lunation; }
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * SEARCH CHECKS
+ * Each sample day is looked up in the matches of one celtic_search() over
+ * a block starting at it; the block lengths cycle so block edges fall on
+ * every kind of day. The brute force evaluates the query on the day alone.
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+#define SEARCH_BLOCK_MAX 4000
+
+static const char *const search_queries[][5] = {
+    {"month=Samonios,Quimonios", "day=1-5,15", NULL},
+    {"phase=full", "festival", NULL},
+    {"event=samhain,beltane,yule", NULL},
+    {"mat", "atenoux", "no-d-amb", "sign=scorpio,taurus", NULL},
+    {"solilunar", "no-festival", NULL},
+    {"pleiades", "phase=waxing-gibbous,full", NULL},
+    {"festival=TRINVX SAMONI", "anm", NULL},
+    {"event", "no-solilunar", "no-pleiades", "phase=new,first-quarter", NULL},
+};
+#define SEARCH_QUERIES ((int)(sizeof(search_queries) / sizeof(search_queries[0])))
+
+static const long search_block_days[] = {1, 29, 366, SEARCH_BLOCK_MAX};
+
+static struct {
+    int parsed;
+    CelticQuery q[SEARCH_QUERIES];
+    int query;              /* Query of the current block, -1 before the first */
+    long first, last;       /* Days the block's search covered */
+    int blocks;
+    int disorder;           /* A match out of order or out of the block */
+    long previous;
+    unsigned char hit[SEARCH_BLOCK_MAX];
+} found = {0, {{0}}, -1, 0, -1, 0, 0, 0, {0}};
+
+static const CelticQuery *search_query(int i)
+{
+    if (!found.parsed) {
+        for (int k = 0; k < SEARCH_QUERIES; k++) {
+            celtic_query_init(&found.q[k]);
+            for (int t = 0; search_queries[k][t]; t++) {
+                if (celtic_query_parse(&found.q[k], search_queries[k][t]) != 0) {
+                    fprintf(stderr, "test_engines: bad search term '%s'\n", search_queries[k][t]);
+                    exit(1);
+                }
+            }
+        }
+        found.parsed = 1;
+    }
+    return &found.q[i];
+}
+
+static int search_holds(const CelticQuery *q, long jd)
+{
+    int month = lunar_celtic_month_index(jd);
+    int day = lunar_day_of_month(jd);
+    int multi = get_multi_festival(month, day);
+    int days_to_event;
+    int event = nearest_eightfold_event(jd, &days_to_event);
+
+    if (q->months && !(q->months & (1u << (month < 0 ? 12 : month)))) return 0;
+    if (q->days && !(q->days & (1u << day))) return 0;
+    if (q->mat && (q->mat == SEARCH_YES) != (lunar_month_length(jd) >= 30)) return 0;
+    if (q->atenoux && (q->atenoux == SEARCH_YES) != (is_atenoux(day) != 0)) return 0;
+    if (q->d_amb && (q->d_amb == SEARCH_YES) != (is_d_amb(day) != 0)) return 0;
+    if (q->festival && (q->festival == SEARCH_YES) != (multi >= 0)) return 0;
+    if (q->festival_id >= 0 && multi != q->festival_id) return 0;
+    if (q->phases && !(q->phases & (1u << moon_phase(jd)))) return 0;
+    if (q->signs && !(q->signs & (1u << sun_sign(jd)))) return 0;
+    if (q->events && !(days_to_event == 0 && (q->events & (1u << event)))) return 0;
+    if (q->solilunar && (q->solilunar == SEARCH_YES) != (is_solilunar_festival(jd) != 0)) return 0;
+    if (q->pleiades && (q->pleiades == SEARCH_YES) != (is_pleiades_rising(jd) != 0)) return 0;
+    return 1;
+}
+
+static int search_mark(long jd, void *ctx)
+{
+    (void)ctx;
+    if (jd < found.first || jd > found.last || jd <= found.previous) found.disorder = 1;
+    else found.hit[jd - found.first] = 1;
+    found.previous = jd;
+    return 0;
+}
+
+/* 1 if jd matched in its block's search, -1 if that search misreported */
+static double search_found(int i, long jd)
+{
+    if (found.query != i || jd < found.first || jd > found.last) {
+        long days = search_block_days[found.blocks++ % (sizeof(search_block_days) / sizeof(search_block_days[0]))];
+        found.query = i;
+        found.first = jd;
+        found.last = jd + days - 1 < day_sweep.last ? jd + days - 1 : day_sweep.last;
+        found.disorder = 0;
+        found.previous = jd - 1;
+        memset(found.hit, 0, sizeof(found.hit));
+
+        long reported = celtic_search(search_query(i), found.first, found.last, search_mark, NULL);
+        long marked = 0;
+        for (long d = 0; d <= found.last - found.first; d++) marked += found.hit[d];
+        if (reported != marked) found.disorder = 1;
+    }
+    return found.disorder ? -1.0 : found.hit[jd - found.first];
+}
+
+#define SEARCH_PAIR(i)                                                                \
+    static double ref_day_search_##i(long jd) { return search_holds(search_query(i), jd); } \
+    static double fast_day_search_##i(long jd) { return search_found(i, jd); }
+
+SEARCH_PAIR(0)
+SEARCH_PAIR(1)
+SEARCH_PAIR(2)
+SEARCH_PAIR(3)
+SEARCH_PAIR(4)
+SEARCH_PAIR(5)
+SEARCH_PAIR(6)
+SEARCH_PAIR(7)
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * FESTIVAL RULE CHECKS
+ * A festival file of astronomical definitions only (the index checks see no
+ * change), written and loaded on first use. The run answered for a day is
+ * its first day, 0 if none; the brute force starts from the day and looks
+ * back for a crossing or full moon close enough to open a run over it.
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+#define RULE_SUN_LONGITUDE   135.0   /* sun 135 ±15 */
+#define RULE_SUN_WINDOW      15
+#define RULE_MOON_LONGITUDE  224.0   /* fullmoon after sun 224 30: runs past 31 Dec */
+#define RULE_MOON_DAYS       30
+
+static void load_festival_rules(void)
+{
+    static int loaded;
+    if (loaded) return;
+    char path[] = "/tmp/test_engines_XXXXXX";
+    int fd = mkstemp(path);
+    FILE *fp = fd >= 0 ? fdopen(fd, "w") : NULL;
+    int line = 0;
+    if (!fp || fprintf(fp, "sun %g +-%d : Test Sun\nfullmoon after sun %g %d : Test Moon\n",
+                       RULE_SUN_LONGITUDE, RULE_SUN_WINDOW, RULE_MOON_LONGITUDE, RULE_MOON_DAYS) < 0 ||
+        fclose(fp) != 0 || festivals_load(path, &line) != 2) {
+        fprintf(stderr, "test_engines: cannot load the test festival file (line %d)\n", line);
+        exit(1);
+    }
+    unlink(path);
+    loaded = 1;
+}
+
+static double ref_day_festival_rule(long jd)
+{
+    long sun = lround(solar_longitude_crossing((double)jd, RULE_SUN_LONGITUDE));
+    if (labs(jd - sun) <= RULE_SUN_WINDOW) return (double)(sun - RULE_SUN_WINDOW);
+
+    long lunation = lunation_number(jd);
+    for (long k = lunation - 2; k <= lunation; k++) {
+        long full = jd_of_full_moon(k);
+        if (full > jd || full < jd - (RULE_MOON_DAYS - 1)) continue;
+        /* The run opens on full only if the crossing day lies in the lunation before */
+        long before = jd_of_full_moon(k - 1);
+        long cross = lround(solar_longitude_crossing((double)(before + full) / 2.0, RULE_MOON_LONGITUDE));
+        if (cross >= before && cross < full) return (double)full;
+    }
+    return 0.0;
+}
+
+static double fast_day_festival_rule(long jd)
+{
+    FestivalOccurrence occ;
+    load_festival_rules();
+    return festival_rule_at(jd, &occ) ? (double)occ.first : 0.0;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * PER-YEAR CHECKS (sample = Gregorian year of the Samhain)
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static double ref_year_samonios(long gy) { return (double)ref_find_samonios_start((int)gy); }
+static double fast_year_samonios(long gy) { return (double)find_samonios_start((int)gy); }
+
+static double ref_year_solilunar(long gy) { return (double)ref_find_solilunar_samhain((int)gy); }
+static double fast_year_solilunar(long gy) { return (double)find_solilunar_samhain((int)gy); }
+
+static double ref_year_start(long gy) { return (double)ref_jd_start_of_celtic_year(celtic_year_of(gy)); }
+static double fast_year_start(long gy) { return (double)jd_start_of_celtic_year(celtic_year_of(gy)); }
+
+/* Month starts -1..12 (in and out of range), hashed */
+static double ref_year_month_starts(long gy)
+{
+    long v[14];
+    for (int m = -1; m <= 12; m++) v[m + 1] = ref_jd_start_of_celtic_month(celtic_year_of(gy), m);
+    return hash_ints(v, 14);
+}
+
+static double fast_year_month_starts(long gy)
+{
+    long v[14];
+    for (int m = -1; m <= 12; m++) v[m + 1] = jd_start_of_celtic_month(celtic_year_of(gy), m);
+    return hash_ints(v, 14);
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * TABLE CHECKS (sample = month, day pair)
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static double ref_dom_month_name(long x) { return hash_string(ref_get_celtic_month_name(domain_month(x))); }
+static double fast_dom_month_name(long x) { return hash_string(get_celtic_month_name(domain_month(x))); }
+
+static double ref_dom_month_abbrev(long x) { return hash_string(ref_get_month_abbrev(domain_month(x))); }
+static double fast_dom_month_abbrev(long x) { return hash_string(get_month_abbrev(domain_month(x))); }
+
+static double ref_dom_is_mat(long x) { return ref_is_mat_month(domain_month(x)); }
+static double fast_dom_is_mat(long x) { return is_mat_month(domain_month(x)); }
+
+static double ref_dom_month_days(long x) { return ref_get_month_days(domain_month(x)); }
+static double fast_dom_month_days(long x) { return get_month_days(domain_month(x)); }
+
+static double ref_dom_is_atenoux(long x) { return ref_is_atenoux(domain_day(x)); }
+static double fast_dom_is_atenoux(long x) { return is_atenoux(domain_day(x)); }
+
+static double ref_dom_is_d_amb(long x) { return ref_is_d_amb(domain_day(x)); }
+static double fast_dom_is_d_amb(long x) { return is_d_amb(domain_day(x)); }
+
+static double ref_dom_multi_festival(long x) { return ref_get_multi_festival(domain_month(x), domain_day(x)); }
+static double fast_dom_multi_festival(long x) { return get_multi_festival(domain_month(x), domain_day(x)); }
+
+static double ref_dom_festival_day(long x) { return ref_get_festival_day_number(domain_month(x), domain_day(x)); }
+static double fast_dom_festival_day(long x) { return get_festival_day_number(domain_month(x), domain_day(x)); }
+
+/* festival_lookup() covers months 0-11 and days 1..FESTIVAL_INDEX_DAYS-1 */
+static int in_festival_index(long x)
+{
+    int m = domain_month(x), d = domain_day(x);
+    return m >= 0 && m <= 11 && d >= 1 && d < FESTIVAL_INDEX_DAYS;
+}
+
+static double ref_dom_festival_lookup(long x)
+{
+    if (!in_festival_index(x)) return 0.0;
+    int m = domain_month(x), d = domain_day(x);
+    return ref_get_multi_festival(m, d) * 1000.0 + ref_get_festival_day_number(m, d);
+}
+
+static double fast_dom_festival_lookup(long x)
+{
+    if (!in_festival_index(x)) return 0.0;
+    const FestivalIndexEntry *e = festival_lookup(domain_month(x), domain_day(x));
+    return e->multi * 1000.0 + e->day_number;
+}
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * CHECK TABLE
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+#define DAY_CHECK(fn) {#fn, SAMPLE_DAY, ref_day_##fn, fast_day_##fn, 0.0, 0, 0.0, NULL}
+#define DAY_DIVERGES(fn, bound, why) {#fn, SAMPLE_DAY, ref_day_##fn, fast_day_##fn, 0.0, 0, bound, why}
+
+/* Documented divergences */
+#define SUNSET_SERIES "declination from the shared solar series (reference: own series)"
+#define SUNSET_MINUTE "follows the sunset hour across minute/hour boundaries"
+#define EXACT_CROSSING "exact crossing (reference: offset / 0.9856 deg per day)"
+#define NEAREST_EVENT "follows the days_to_* countdowns"
+#define SAMHAIN_WINDOW "exact 225 deg day (reference: first day within 0.5 deg, Nov 1 if none)"
+
+static const Check checks[] = {
+    DAY_CHECK(moon_phase),
+    DAY_CHECK(sun_sign),
+    DAY_CHECK(moon_sign),
+    {"sun_longitude", SAMPLE_DAY, ref_day_sun_longitude, fast_day_sun_longitude, LONGITUDE_TOLERANCE, 1, 0.0, NULL},
+    {"solar_state.longitude", SAMPLE_DAY, ref_day_sun_longitude, fast_day_solar_state_longitude, LONGITUDE_TOLERANCE, 0, 0.0, NULL},
+    {"solar_state.sign", SAMPLE_DAY, ref_day_sun_sign, fast_day_solar_state_sign, 0.0, 0, 0.0, NULL},
+    {"ephemeris_span.phase", SAMPLE_DAY, ref_day_moon_phase, fast_day_span_phase, 0.0, 0, 0.0, NULL},
+    {"ephemeris_span.sunlong", SAMPLE_DAY, ref_day_sun_longitude, fast_day_span_sunlong, LONGITUDE_TOLERANCE, 1, 0.0, NULL},
+    {"ephemeris_span.moonsign", SAMPLE_DAY, ref_day_moon_sign, fast_day_span_moonsign, 0.0, 0, 0.0, NULL},
+    DAY_CHECK(find_full_moon_before),
+    DAY_CHECK(lunar_day_of_month),
+    DAY_CHECK(lunar_month_length),
+    DAY_DIVERGES(lunar_celtic_month_index, 12.0, SAMHAIN_WINDOW),
+    DAY_DIVERGES(sunset_coligny, 0.01, SUNSET_SERIES),
+    DAY_DIVERGES(sunset_equator, 0.01, SUNSET_SERIES),
+    DAY_DIVERGES(sunset_iceland, 0.01, SUNSET_SERIES),
+    DAY_DIVERGES(sunset_tasmania, 0.01, SUNSET_SERIES),
+    DAY_DIVERGES(is_after_sunset, 1.0, SUNSET_MINUTE),
+    DAY_DIVERGES(celtic_jd_from_time, 1.0, SUNSET_MINUTE),
+    DAY_DIVERGES(sunset_time_str, 1.0, SUNSET_MINUTE),
+    DAY_CHECK(metonic_year),
+    DAY_CHECK(metonic_lunation),
+    DAY_CHECK(metonic_cycle_number),
+    {"metonic_drift_hours", SAMPLE_DAY, ref_day_metonic_drift_hours, fast_day_metonic_drift_hours, 1e-9, 0, 0.0, NULL},
+    DAY_CHECK(days_to_pleiades_rising),
+    DAY_CHECK(is_pleiades_rising),
+    {"days_to_solar_longitude", SAMPLE_DAY, ref_day_solar_longitude_100, fast_day_solar_longitude_100, 0.0, 0, 5.0, EXACT_CROSSING},
+    DAY_DIVERGES(days_to_true_samhain, 5.0, EXACT_CROSSING),
+    DAY_DIVERGES(days_to_true_imbolc, 5.0, EXACT_CROSSING),
+    DAY_DIVERGES(days_to_true_beltane, 5.0, EXACT_CROSSING),
+    DAY_DIVERGES(days_to_true_lughnasadh, 5.0, EXACT_CROSSING),
+    DAY_DIVERGES(nearest_cross_quarter, HUGE_VAL, NEAREST_EVENT),
+    DAY_CHECK(is_solilunar_festival),
+    DAY_DIVERGES(days_to_solilunar_samhain, HUGE_VAL, SAMHAIN_WINDOW),
+    DAY_DIVERGES(days_to_yule, 5.0, EXACT_CROSSING),
+    DAY_DIVERGES(days_to_ostara, 5.0, EXACT_CROSSING),
+    DAY_DIVERGES(days_to_litha, 5.0, EXACT_CROSSING),
+    DAY_DIVERGES(days_to_mabon, 5.0, EXACT_CROSSING),
+    DAY_DIVERGES(nearest_eightfold_event, HUGE_VAL, NEAREST_EVENT),
+    DAY_CHECK(jd_from_ymd),
+    DAY_CHECK(celtic_year_from_jd),
+    DAY_CHECK(day_of_year),
+    DAY_CHECK(day_of_month),
+    DAY_CHECK(celtic_month_index),
+    {"elapsed_fraction", SAMPLE_DAY, ref_day_elapsed_fraction, fast_day_elapsed_fraction, 1e-12, 0, 0.0, NULL},
+    DAY_CHECK(days_remaining),
+    DAY_CHECK(current_year_length),
+    DAY_CHECK(age_and_year_in_age),
+    {"celtic_date_from_jd", SAMPLE_DAY, ref_day_celtic_date, fast_day_celtic_date, 0.0, 0, 0.0, NULL},
+    {"celtic_date_from_jd.elapsed", SAMPLE_DAY, ref_day_elapsed_fraction, fast_day_celtic_date_elapsed, 1e-12, 0, 0.0, NULL},
+    {"jd_from_celtic", SAMPLE_DAY, ref_day_identity, fast_day_jd_from_celtic, 0.0, 0, 0.0, NULL},
+    {"jd_from_lunar_celtic", SAMPLE_DAY, ref_day_identity, fast_day_jd_from_lunar_celtic, 0.0, 0, 0.0, NULL},
+    {"celtic_dates_from_jd_array", SAMPLE_DAY, ref_day_columns, fast_day_columns, 0.0, 0, 0.0, NULL},
+    {"celtic_dates_from_jd_array.lunar", SAMPLE_DAY, ref_day_lunar_celtic_month_index, fast_day_columns_lunar,
+     0.0, 0, 12.0, SAMHAIN_WINDOW},
+    {"cursor.date", SAMPLE_DAY, ref_day_celtic_date, fast_day_cursor_date, 0.0, 0, 0.0, NULL},
+    {"cursor.lunation_start", SAMPLE_DAY, ref_day_find_full_moon_before, fast_day_cursor_lunation, 0.0, 0, 0.0, NULL},
+    {"cursor.lunar_day", SAMPLE_DAY, ref_day_lunar_day_of_month, fast_day_cursor_lunar_day, 0.0, 0, 0.0, NULL},
+    {"cursor.lunar_month_length", SAMPLE_DAY, ref_day_lunar_month_length, fast_day_cursor_month_length,
+     0.0, 0, 0.0, NULL},
+    {"cursor.lunar_month", SAMPLE_DAY, ref_day_lunar_celtic_month_index, fast_day_cursor_lunar_month,
+     0.0, 0, 12.0, SAMHAIN_WINDOW},
+    {"cursor.metonic_year", SAMPLE_DAY, ref_day_metonic_year, fast_day_cursor_metonic_year, 0.0, 0, 0.0, NULL},
+    {"cursor.metonic_lunation", SAMPLE_DAY, ref_day_metonic_lunation, fast_day_cursor_metonic_lunation,
+     0.0, 0, 0.0, NULL},
+    {"celtic_search.month+day", SAMPLE_DAY, ref_day_search_0, fast_day_search_0, 0.0, 0, 0.0, NULL},
+    {"celtic_search.full+festival", SAMPLE_DAY, ref_day_search_1, fast_day_search_1, 0.0, 0, 0.0, NULL},
+    {"celtic_search.events", SAMPLE_DAY, ref_day_search_2, fast_day_search_2, 0.0, 0, 0.0, NULL},
+    {"celtic_search.mat+atenoux+sign", SAMPLE_DAY, ref_day_search_3, fast_day_search_3, 0.0, 0, 0.0, NULL},
+    {"celtic_search.solilunar", SAMPLE_DAY, ref_day_search_4, fast_day_search_4, 0.0, 0, 0.0, NULL},
+    {"celtic_search.pleiades+phase", SAMPLE_DAY, ref_day_search_5, fast_day_search_5, 0.0, 0, 0.0, NULL},
+    {"celtic_search.festival_id+anm", SAMPLE_DAY, ref_day_search_6, fast_day_search_6, 0.0, 0, 0.0, NULL},
+    {"celtic_search.event+exclusions", SAMPLE_DAY, ref_day_search_7, fast_day_search_7, 0.0, 0, 0.0, NULL},
+    {"festival_rule_at", SAMPLE_DAY, ref_day_festival_rule, fast_day_festival_rule, 0.0, 0, 0.0, NULL},
+    {"find_samonios_start", SAMPLE_YEAR, ref_year_samonios, fast_year_samonios, 0.0, 0, 31.0, SAMHAIN_WINDOW},
+    {"find_solilunar_samhain", SAMPLE_YEAR, ref_year_solilunar, fast_year_solilunar, 0.0, 0, 31.0, SAMHAIN_WINDOW},
+    {"jd_start_of_celtic_year", SAMPLE_YEAR, ref_year_start, fast_year_start, 0.0, 0, 0.0, NULL},
+    {"jd_start_of_celtic_month", SAMPLE_YEAR, ref_year_month_starts, fast_year_month_starts, 0.0, 0, 0.0, NULL},
+    {"get_celtic_month_name", SAMPLE_DOMAIN, ref_dom_month_name, fast_dom_month_name, 0.0, 0, 0.0, NULL},
+    {"get_month_abbrev", SAMPLE_DOMAIN, ref_dom_month_abbrev, fast_dom_month_abbrev, 0.0, 0, 0.0, NULL},
+    {"is_mat_month", SAMPLE_DOMAIN, ref_dom_is_mat, fast_dom_is_mat, 0.0, 0, 0.0, NULL},
+    {"get_month_days", SAMPLE_DOMAIN, ref_dom_month_days, fast_dom_month_days, 0.0, 0, 0.0, NULL},
+    {"is_atenoux", SAMPLE_DOMAIN, ref_dom_is_atenoux, fast_dom_is_atenoux, 0.0, 0, 0.0, NULL},
+    {"is_d_amb", SAMPLE_DOMAIN, ref_dom_is_d_amb, fast_dom_is_d_amb, 0.0, 0, 0.0, NULL},
+    {"get_multi_festival", SAMPLE_DOMAIN, ref_dom_multi_festival, fast_dom_multi_festival, 0.0, 0, 0.0, NULL},
+    {"get_festival_day_number", SAMPLE_DOMAIN, ref_dom_festival_day, fast_dom_festival_day, 0.0, 0, 0.0, NULL},
+    {"festival_lookup", SAMPLE_DOMAIN, ref_dom_festival_lookup, fast_dom_festival_lookup, 0.0, 0, 0.0, NULL},
+};
+
+/* ═══════════════════════════════════════════════════════════════════════════
+ * RUNNER
+ * ═══════════════════════════════════════════════════════════════════════════ */
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static const Sweep *sweep_of(SampleKind kind)
+{
+    if (kind == SAMPLE_DAY) return &day_sweep;
+    if (kind == SAMPLE_YEAR) return &year_sweep;
+    return &domain_sweep;
+}
+
+static long sample_count(const Sweep *s)
+{
+    return (s->last - s->first) / s->stride + 1;
+}
+
+static double time_pass(SampleFn fn, const Sweep *s, double *out)
+{
+    long i = 0;
+    double start = now_ns();
+    for (long x = s->first; x <= s->last; x += s->stride) out[i++] = fn(x);
+    return now_ns() - start;
+}
+
+static int values_differ(double a, double b, double tolerance)
+{
+    if (isnan(a) || isnan(b)) return isnan(a) != isnan(b);
+    return fabs(a - b) > tolerance;
+}
+
+static const char *sample_label(SampleKind kind, long x, char *buf, size_t size)
+{
+    if (kind == SAMPLE_DAY) {
+        int y, m, d;
+        ymd_from_jd(x, &y, &m, &d);
+        snprintf(buf, size, "jd %ld (%d-%02d-%02d)", x, y, m, d);
+    } else if (kind == SAMPLE_YEAR) {
+        snprintf(buf, size, "Samhain year %ld", x);
+    } else {
+        snprintf(buf, size, "month %d day %d", domain_month(x), domain_day(x));
+    }
+    return buf;
+}
+
+/* Sample i differs beyond the tolerance; *diverges if within the documented bound */
+static int sample_differs(const Check *c, double tolerance, double ref, double fast, int *diverges)
+{
+    *diverges = 0;
+    if (!values_differ(ref, fast, tolerance)) return 0;
+    *diverges = c->divergence && !isnan(ref) && !isnan(fast) && fabs(ref - fast) <= c->bound;
+    return 1;
+}
+
+/* Returns the number of mismatching samples */
+static long run_check(const Check *c, double *ref_out, double *fast_out)
+{
+    const Sweep *s = sweep_of(c->kind);
+    long n = sample_count(s);
+    double tolerance = c->tolerance;
+    if (c->quantized && ephemeris_day(s->first) && tolerance < EPHEMERIS_LONGITUDE_TOLERANCE)
+        tolerance = EPHEMERIS_LONGITUDE_TOLERANCE;
+
+    double ref_ns = time_pass(c->ref, s, ref_out);
+    double fast_ns = time_pass(c->fast, s, fast_out);
+
+    long mismatches = 0, divergences = 0;
+    double worst = 0.0;
+    for (long i = 0; i < n; i++) {
+        int diverges;
+        if (!sample_differs(c, tolerance, ref_out[i], fast_out[i], &diverges)) continue;
+        double diff = fabs(ref_out[i] - fast_out[i]);
+        if (diff > worst || isnan(diff)) worst = diff;
+        if (diverges) divergences++;
+        else mismatches++;
+    }
+
+    printf("%-32s %9ld %9ld %9ld %12.4g %12.1f %12.1f %9.1fx\n", c->name, n, mismatches, divergences,
+           worst, ref_ns / n, fast_ns / n, fast_ns > 0 ? ref_ns / fast_ns : 0.0);
+    if (divergences) printf("    diverges by design: %s\n", c->divergence);
+
+    long listed = 0;
+    for (long i = 0; i < n && listed < MISMATCH_REPORT; i++) {
+        int diverges;
+        if (!sample_differs(c, tolerance, ref_out[i], fast_out[i], &diverges) || diverges) continue;
+        char label[64];
+        printf("    %s: reference %.10g, fast %.10g\n",
+               sample_label(c->kind, s->first + i * s->stride, label, sizeof(label)),
+               ref_out[i], fast_out[i]);
+        listed++;
+    }
+    fflush(stdout);
+    return mismatches;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [-y FIRST:LAST] [-s stride-days] [-f name-substring] [-e ephemeris.eph]\n", prog);
+}
+
+int main(int argc, char *argv[])
+{
+    int first_year = SWEEP_FIRST_YEAR, last_year = SWEEP_LAST_YEAR;
+    long stride = 1;
+    const char *filter = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "-y") == 0) {
+            if (sscanf(argv[++i], "%d:%d", &first_year, &last_year) != 2) {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (i + 1 < argc && strcmp(argv[i], "-s") == 0) {
+            stride = atol(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "-f") == 0) {
+            filter = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "-e") == 0) {
+            if (ephemeris_open(argv[++i]) != 0) {
+                perror(argv[i]);
+                return 1;
+            }
+            /* The reference engine is the fast tier; other tiers move days on purpose */
+            if (ephemeris_tier() != PRECISION_FAST) {
+                fprintf(stderr, "%s: generated with the %s tier, only fast files compare\n",
+                        argv[i], precision_tier_name((PrecisionTier)ephemeris_tier()));
+                return 1;
+            }
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (stride < 1 || first_year > last_year) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    day_sweep = (Sweep){jd_from_ymd(first_year, 1, 1), jd_from_ymd(last_year, 12, 31), stride};
+    year_sweep = (Sweep){first_year, last_year, 1};
+
+    long max_samples = sample_count(&day_sweep);
+    if (sample_count(&year_sweep) > max_samples) max_samples = sample_count(&year_sweep);
+    if (sample_count(&domain_sweep) > max_samples) max_samples = sample_count(&domain_sweep);
+    double *ref_out = malloc(sizeof(double) * max_samples);
+    double *fast_out = malloc(sizeof(double) * max_samples);
+    if (!ref_out || !fast_out) {
+        fprintf(stderr, "test_engines: out of memory\n");
+        return 1;
+    }
+
+#ifdef CELTIC_FIXED_POINT
+    const char *backend = ", fixed-point backend";
+#else
+    const char *backend = "";
+#endif
+    printf("Sweep %d..%d, every %ld day(s)%s%s\n", first_year, last_year, stride,
+           ephemeris_day(day_sweep.first) ? ", ephemeris loaded" : "", backend);
+    printf("%-32s %9s %9s %9s %12s %12s %12s %10s\n", "check", "samples", "mismatch", "diverge",
+           "worst diff", "ref ns", "fast ns", "speedup");
+
+    int run = 0, failed = 0;
+    for (size_t i = 0; i < sizeof(checks) / sizeof(checks[0]); i++) {
+        if (filter && !strstr(checks[i].name, filter)) continue;
+        run++;
+        if (run_check(&checks[i], ref_out, fast_out) > 0) failed++;
+    }
+
+    printf("%d check(s), %d with mismatches\n", run, failed);
+    free(ref_out);
+    free(fast_out);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,181 @@
+#define _XOPEN_SOURCE 700
+#include <wchar.h>
+#include <locale.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "text_layout.h"
+#include "data.h"
+
+/*
+ * ═══════════════════════════════════════════════════════════════════════════
+ * GLYPH WIDTH TABLE
+ * Open-addressed code point -> width table, filled once from the glyph
+ * strings the renderers emit on every cell and border.
+ * ═══════════════════════════════════════════════════════════════════════════
+ */
+#define GLYPH_TABLE_SLOTS 256   /* Power of two, well above the interned set */
+
+typedef struct {
+    unsigned int codepoint;     /* 0 = empty slot */
+    int width;
+} GlyphWidth;
+
+static GlyphWidth glyph_table[GLYPH_TABLE_SLOTS];
+static pthread_once_t layout_once = PTHREAD_ONCE_INIT;
+static int layout_utf8 = 0;     /* Locale decodes UTF-8; otherwise every byte is 1 column */
+
+/* Fixed glyphs of the month views, tablet panel and CLI boxes */
+static const char *interned_glyphs[] = {
+    "♈♉♊♋♌♍♎♏♐♑♒♓",              /* Zodiac */
+    "☉☽♂☿♃♀♄",                     /* Weekdays */
+    "─│┌┐└┘├┤┬┴┼",                 /* Grid and info boxes */
+    "═║╔╗╚╝╠╣",                    /* Tablet panel and coicise banners */
+    "☆⚐⚠◎→⌘",                      /* Status marks and decorations */
+    "ƚı°",                         /* Triple marks, degrees */
+};
+
+/* Treat emoji code points as width 2 on terminals that report 1 */
+static int codepoint_width(unsigned int cp)
+{
+    int w = wcwidth((wchar_t)cp);
+    if (w < 0) w = 1;
+    if (w < 2) {
+        if ((cp >= 0x1F300 && cp <= 0x1FAFF) || /* Misc emoji, moons */
+            (cp >= 0x1F600 && cp <= 0x1F64F)) { /* Emoticons block */
+            w = 2;
+        }
+    }
+    return w;
+}
+
+static unsigned int glyph_slot(unsigned int cp)
+{
+    return (cp * 2654435761u) & (GLYPH_TABLE_SLOTS - 1);
+}
+
+/*
+ * Decode one UTF-8 sequence of at most n bytes. Returns its length, or 0
+ * for an invalid or truncated sequence.
+ */
+static size_t utf8_decode(const unsigned char *p, size_t n, unsigned int *cp)
+{
+    unsigned char c = p[0];
+    size_t len;
+    unsigned int v;
+
+    if (c < 0xC2) return 0;
+    if (c < 0xE0)      { len = 2; v = c & 0x1F; }
+    else if (c < 0xF0) { len = 3; v = c & 0x0F; }
+    else if (c < 0xF5) { len = 4; v = c & 0x07; }
+    else return 0;
+
+    if (len > n) return 0;
+    for (size_t i = 1; i < len; i++) {
+        if ((p[i] & 0xC0) != 0x80) return 0;
+        v = (v << 6) | (p[i] & 0x3F);
+    }
+
+    /* Reject overlong forms, surrogates and values past U+10FFFF */
+    if ((len == 3 && v < 0x800) || (len == 4 && (v < 0x10000 || v > 0x10FFFF)) ||
+        (v >= 0xD800 && v <= 0xDFFF)) {
+        return 0;
+    }
+    *cp = v;
+    return len;
+}
+
+static void intern_glyphs(const char *s)
+{
+    const unsigned char *p = (const unsigned char *)s;
+    size_t n = strlen(s);
+
+    while (n > 0) {
+        unsigned int cp;
+        size_t len = (*p < 0x80) ? 0 : utf8_decode(p, n, &cp);
+        if (len == 0) {
+            p++;
+            n--;
+            continue;
+        }
+
+        unsigned int slot = glyph_slot(cp);
+        while (glyph_table[slot].codepoint && glyph_table[slot].codepoint != cp) {
+            slot = (slot + 1) & (GLYPH_TABLE_SLOTS - 1);
+        }
+        glyph_table[slot].codepoint = cp;
+        glyph_table[slot].width = codepoint_width(cp);
+
+        p += len;
+        n -= len;
+    }
+}
+
+static int glyph_width(unsigned int cp)
+{
+    unsigned int slot = glyph_slot(cp);
+    while (glyph_table[slot].codepoint) {
+        if (glyph_table[slot].codepoint == cp) return glyph_table[slot].width;
+        slot = (slot + 1) & (GLYPH_TABLE_SLOTS - 1);
+    }
+    return codepoint_width(cp);
+}
+
+static void build_layout(void)
+{
+    /* Locale-aware widths so emoji align in boxes */
+    setlocale(LC_ALL, "");
+    layout_utf8 = (MB_CUR_MAX > 1);
+
+    if (layout_utf8) {
+        for (size_t i = 0; i < sizeof(interned_glyphs) / sizeof(interned_glyphs[0]); i++) {
+            intern_glyphs(interned_glyphs[i]);
+        }
+        for (int i = 0; i < 8; i++) {
+            intern_glyphs(moon_symbols[i]);
+        }
+    }
+}
+
+void text_layout_init(void)
+{
+    pthread_once(&layout_once, build_layout);
+}
+
+/* Measure displayed width of n bytes (accounts for double-width emoji) */
+int text_display_width_n(const char *s, size_t n)
+{
+    text_layout_init();
+
+    const unsigned char *p = (const unsigned char *)s;
+    int width = 0;
+
+    while (n > 0 && *p) {
+        /* ASCII fast path */
+        if (*p < 0x80 || !layout_utf8) {
+            p++;
+            n--;
+            width++;
+            continue;
+        }
+
+        unsigned int cp;
+        size_t len = utf8_decode(p, n, &cp);
+        if (len == 0) {
+            /* Invalid sequence; treat byte as width 1 and advance */
+            p++;
+            n--;
+            width++;
+            continue;
+        }
+        width += glyph_width(cp);
+        p += len;
+        n -= len;
+    }
+    return width;
+}
+
+int text_display_width(const char *s)
+{
+    return text_display_width_n(s, strlen(s));
+}
@@ -0,0 +1,23 @@
+#ifndef TEXT_LAYOUT_H
+#define TEXT_LAYOUT_H
+
+#include <stddef.h>
+
+/*
+ * Terminal display width of UTF-8 text, shared by the CLI, the month
+ * renderers and the TUI. ASCII is counted directly; other code points are
+ * looked up in a width table interned at startup from the calendar's fixed
+ * glyphs (moon phases, zodiac, box drawing, status marks), falling back to
+ * wcwidth() for anything else. Emoji count as 2 columns even on terminals
+ * whose wcwidth() reports 1.
+ */
+
+/* Select the user's locale and build the glyph table (called lazily, once
+ * per process; setlocale() itself is not thread-safe, so call this before
+ * starting threads that print or use locale-dependent libc calls) */
+void text_layout_init(void);
+
+int text_display_width(const char *s);
+int text_display_width_n(const char *s, size_t n);  /* First n bytes */
+
+#endif
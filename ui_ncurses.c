@@ -6,13 +6,15 @@
 #include <locale.h>
 #include <langinfo.h>
 #include <stdio.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
 #include "calendar.h"
 #include "astronomy.h"
 #include "festivals.h"
 #include "glyphs.h"
-
-/* Default location: Coligny, France */
-#define LATITUDE 46.38
+#include "location.h"
 
 /* Color pair definitions */
 #define COLOR_PAIR_TITLE 1
@@ -30,14 +32,16 @@
 #define MENU_SEARCH_DATE 1
 #define MENU_NEXT_MONTH 2
 #define MENU_PREV_MONTH 3
-#define MENU_QUIT 4
-#define MENU_COUNT 5
+#define MENU_YEAR_SHEET 4
+#define MENU_QUIT 5
+#define MENU_COUNT 6
 
 static const char *menu_items[] = {
     "View Today's Calendar",
     "Search for Specific Date",
     "Next Celtic Month",
     "Previous Celtic Month",
+    "Year at a Glance",
     "Quit to Terminal"
 };
 
@@ -137,97 +141,368 @@ static void draw_main_menu(WINDOW *win, int selected)
     wrefresh(win);
 }
 
-/* Render the rich text month view (same as CLI) into the ncurses window */
-static void render_month_view(WINDOW *win, long jd_actual)
+/*
+ * ═══════════════════════════════════════════════════════════════════════════
+ * MONTH VIEW CACHE
+ * Rendered month views are kept in a small LRU keyed by (lunar month start,
+ * after_sunset, today). An idle worker thread renders the previous and next
+ * months after each view so paging is a cache hit. Renders run unlocked
+ * into a private sink that is then swapped into its slot, so the lock is
+ * only held for lookups and publishing. ncurses is only touched from the
+ * UI thread: the worker fills sinks, the UI thread turns them into pads,
+ * rebuilt only when a slot's generation changes.
+ * ═══════════════════════════════════════════════════════════════════════════
+ */
+#define VIEW_CACHE_SLOTS 8
+
+typedef struct {
+    long month_start;
+    int after_sunset;
+    long today_jd;
+} ViewKey;
+
+typedef struct {
+    ViewKey key;
+    long celtic_today_jd;
+    int month_idx;
+    int month_days;
+} ViewContext;
+
+typedef struct {
+    int valid;
+    ViewKey key;
+    unsigned long last_used;
+    unsigned long generation;   /* Changes whenever the slot is re-rendered */
+    RenderSink sink;
+} CachedView;
+
+static CachedView view_cache[VIEW_CACHE_SLOTS];
+static unsigned long view_clock;
+static unsigned long view_generation;
+
+/* UI thread only: pads built from the cache slots */
+static struct {
+    WINDOW *pad;
+    unsigned long generation;
+    int height;
+    int width;      /* Window width the pad was built for */
+} view_pads[VIEW_CACHE_SLOTS];
+
+/* Guards the view cache and the prefetch request; calendar calls need no lock */
+static pthread_mutex_t render_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t prefetch_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t prefetch_thread;
+static int prefetch_running;
+static int prefetch_pending;
+static long prefetch_jd;
+static long prefetch_today;
+static double prefetch_hour;
+
+/*
+ * Observer for sunset reckoning: Coligny in local solar time unless
+ * CELTIC_LOCATION="LAT,LON[,TZ]" names a site. Set before the prefetcher
+ * starts and read-only afterwards.
+ */
+static CelticLocation ui_location;
+
+/* Lunar month navigation, shared by the menu, the view keys and the prefetcher */
+static long next_month_jd(long jd)
 {
-    int height, width;
-    getmaxyx(win, height, width);
+    long celtic_jd = location_celtic_jd(&ui_location, jd, 12.0);
+    long month_start = find_full_moon_before(celtic_jd);
+    int month_len = lunar_month_length(celtic_jd);
+    return month_start + month_len + 1; /* jump to start of next lunar month */
+}
+
+static long prev_month_jd(long jd)
+{
+    long celtic_jd = location_celtic_jd(&ui_location, jd, 12.0);
+    /* Step to just before this month's full moon, then rendering will pick the prior month. */
+    return find_full_moon_before(celtic_jd) - 1;
+}
 
-    /* Compute Celtic context for the month being viewed and anchor "Today" to the real current date */
+static double local_hour_now(void)
+{
     time_t t = time(NULL);
     struct tm *local = localtime(&t);
-    double current_hour = 12.0;
-    if (local) current_hour = local->tm_hour + local->tm_min / 60.0;
-
-    long today_jd = jd_today();
-    int after_sunset = is_after_sunset(today_jd, current_hour, LATITUDE);
-    long celtic_today_jd = celtic_jd_from_time(today_jd, current_hour, LATITUDE);
-
-    long celtic_view_jd = celtic_jd_from_time(jd_actual, current_hour, LATITUDE);
-    int month_idx = lunar_celtic_month_index(celtic_view_jd);
-    long jd_month_start = find_full_moon_before(celtic_view_jd);
-    int month_days = lunar_month_length(celtic_view_jd);
-
-    /* Capture CLI rendering into a buffer */
-    char *buf = NULL;
-    size_t len = 0;
-    FILE *mem = open_memstream(&buf, &len);
-    if (!mem) {
-        /* Show a helpful message instead of a blank screen when buffer creation fails */
-        werase(win);
-        box(win, 0, 0);
-        mvwprintw(win, 1, 2, "Unable to render calendar (open_memstream failed).");
-        mvwprintw(win, 2, 2, "Try recompiling with -lncursesw -lm or check memory limits.");
-        wrefresh(win);
-        wgetch(win);
+    return local ? local->tm_hour + local->tm_min / 60.0 : 12.0;
+}
+
+/* Today's civil day and hour at the observer */
+static void observer_now(long *today_jd, double *hour)
+{
+    if (ui_location.solar_time) {
+        *today_jd = jd_today();
+        *hour = local_hour_now();
         return;
     }
+    location_local_time(&ui_location, time(NULL), today_jd, hour);
+}
 
-    FILE *saved = stdout;
-    stdout = mem;
-    print_celtic_month_lunar(month_idx, jd_month_start, celtic_today_jd, today_jd, month_days, after_sunset);
-    fflush(mem);
-    stdout = saved;
-    fclose(mem);
+static long observer_today(void)
+{
+    long today_jd;
+    double hour;
+    observer_now(&today_jd, &hour);
+    return today_jd;
+}
 
-    if (!buf || len == 0) {
-        /* Protect against empty output so the user sees an actionable message */
-        werase(win);
-        box(win, 0, 0);
-        mvwprintw(win, 1, 2, "Calendar output was empty.");
-        mvwprintw(win, 2, 2, "Run the CLI (./celtic_calendar) to verify data, then retry.");
-        wrefresh(win);
-        wgetch(win);
-        free(buf);
-        return;
+/* Celtic context for the month being viewed, anchoring "Today" to the real date */
+static void resolve_view(long jd_actual, long today_jd, double current_hour, ViewContext *ctx)
+{
+    ctx->key.today_jd = today_jd;
+    ctx->key.after_sunset = location_is_after_sunset(&ui_location, today_jd, current_hour);
+    ctx->celtic_today_jd = location_celtic_jd(&ui_location, today_jd, current_hour);
+
+    long celtic_view_jd = location_celtic_jd(&ui_location, jd_actual, current_hour);
+    ctx->month_idx = lunar_celtic_month_index(celtic_view_jd);
+    ctx->key.month_start = find_full_moon_before(celtic_view_jd);
+    ctx->month_days = lunar_month_length(celtic_view_jd);
+}
+
+/* Slot holding the view for key, or -1; caller holds render_lock */
+static int find_view(const ViewKey *key)
+{
+    for (int i = 0; i < VIEW_CACHE_SLOTS; i++) {
+        CachedView *v = &view_cache[i];
+        if (v->valid && v->key.month_start == key->month_start &&
+            v->key.after_sunset == key->after_sunset && v->key.today_jd == key->today_jd) {
+            v->last_used = ++view_clock;
+            return i;
+        }
     }
+    return -1;
+}
+
+static void render_view(RenderSink *sink, const ViewContext *ctx)
+{
+    render_sink_reset(sink);
+    render_celtic_month_lunar(sink, ctx->month_idx, ctx->key.month_start, ctx->celtic_today_jd,
+                              ctx->key.today_jd, ctx->month_days, ctx->key.after_sunset);
+}
+
+/*
+ * Store a view rendered into *sink under key, evicting the least recently
+ * used slot; the evicted slot's buffers are swapped back into *sink for
+ * reuse. If the other thread published the same view first, that one is
+ * kept. Caller holds render_lock.
+ */
+static int publish_view(const ViewKey *key, RenderSink *sink)
+{
+    int slot = find_view(key);
+    if (slot >= 0) return slot;
+
+    int victim = 0;
+    for (int i = 1; i < VIEW_CACHE_SLOTS && view_cache[victim].valid; i++) {
+        if (!view_cache[i].valid || view_cache[i].last_used < view_cache[victim].last_used) {
+            victim = i;
+        }
+    }
+
+    CachedView *v = &view_cache[victim];
+    RenderSink evicted = v->sink;
+    v->sink = *sink;
+    *sink = evicted;
+    v->key = *key;
+    v->valid = 1;
+    v->last_used = ++view_clock;
+    v->generation = ++view_generation;
+    return victim;
+}
 
-    /* Display buffer line by line inside the window */
-    /* Split buffer into lines to load into a pad for scrolling */
-    int line_count = 0;
-    int max_line_len = 0;
-    for (char *p = buf; *p; p++) {
-        if (*p == '\n') {
-            line_count++;
+static void *prefetch_main(void *arg)
+{
+    (void)arg;
+    RenderSink scratch;
+    render_sink_init(&scratch);
+
+    pthread_mutex_lock(&render_lock);
+    while (prefetch_running) {
+        if (!prefetch_pending) {
+            pthread_cond_wait(&prefetch_cond, &render_lock);
+            continue;
+        }
+        prefetch_pending = 0;
+        long jd = prefetch_jd;
+        long today_jd = prefetch_today;
+        double hour = prefetch_hour;
+
+        /* A newer request abandons the rest of this one */
+        for (int i = 0; i < 2 && !prefetch_pending && prefetch_running; i++) {
+            pthread_mutex_unlock(&render_lock);
+            ViewContext ctx;
+            resolve_view(i == 0 ? prev_month_jd(jd) : next_month_jd(jd), today_jd, hour, &ctx);
+            pthread_mutex_lock(&render_lock);
+            if (find_view(&ctx.key) >= 0) continue;
+
+            pthread_mutex_unlock(&render_lock);
+            render_view(&scratch, &ctx);
+            pthread_mutex_lock(&render_lock);
+            publish_view(&ctx.key, &scratch);
         }
     }
-    line_count++; /* last line */
-
-    char *cursor = buf;
-    for (int i = 0; i < line_count; i++) {
-        char *nl = strchr(cursor, '\n');
-        int len_line = nl ? (int)(nl - cursor) : (int)strlen(cursor);
-        if (len_line > max_line_len) max_line_len = len_line;
-        if (!nl) break;
-        cursor = nl + 1;
+    pthread_mutex_unlock(&render_lock);
+
+    render_sink_free(&scratch);
+    return NULL;
+}
+
+/* Queue the neighbours of jd for rendering; caller holds render_lock */
+static void request_prefetch(long jd, long today_jd, double current_hour)
+{
+    if (!prefetch_running) return;
+    prefetch_jd = jd;
+    prefetch_today = today_jd;
+    prefetch_hour = current_hour;
+    prefetch_pending = 1;
+    pthread_cond_signal(&prefetch_cond);
+}
+
+static void start_prefetcher(void)
+{
+    prefetch_running = 1;
+    if (pthread_create(&prefetch_thread, NULL, prefetch_main, NULL) != 0) {
+        prefetch_running = 0;  /* Views are then rendered on demand only */
     }
+}
 
-    int pad_h = line_count + 2;
-    int pad_w = (max_line_len + 4 > width - 2) ? max_line_len + 4 : width - 2;
+static void stop_prefetcher(void)
+{
+    pthread_mutex_lock(&render_lock);
+    int was_running = prefetch_running;
+    prefetch_running = 0;
+    pthread_cond_signal(&prefetch_cond);
+    pthread_mutex_unlock(&render_lock);
+    if (was_running) pthread_join(prefetch_thread, NULL);
+
+    for (int i = 0; i < VIEW_CACHE_SLOTS; i++) {
+        if (view_pads[i].pad) delwin(view_pads[i].pad);
+        view_pads[i].pad = NULL;
+        render_sink_free(&view_cache[i].sink);
+        view_cache[i].valid = 0;
+    }
+}
+
+/* Pad for a cache slot, rebuilt only if the slot was re-rendered or the window resized; caller holds render_lock */
+static WINDOW *view_pad(int slot, int width)
+{
+    const CachedView *v = &view_cache[slot];
+    if (view_pads[slot].pad && view_pads[slot].generation == v->generation &&
+        view_pads[slot].width == width) {
+        return view_pads[slot].pad;
+    }
+    if (view_pads[slot].pad) delwin(view_pads[slot].pad);
+    view_pads[slot].pad = NULL;
+
+    int pad_h = v->sink.line_count + 2;
+    int pad_w = (v->sink.max_width + 4 > width - 2) ? v->sink.max_width + 4 : width - 2;
     WINDOW *pad = newpad(pad_h, pad_w);
-    if (!pad) { free(buf); return; }
-
-    cursor = buf;
-    for (int row = 0; row < line_count; row++) {
-        char *nl = strchr(cursor, '\n');
-        int len_line = nl ? (int)(nl - cursor) : (int)strlen(cursor);
-        char saved = '\0';
-        if (nl) { saved = cursor[len_line]; cursor[len_line] = '\0'; }
-        mvwprintw(pad, row, 0, "%s", cursor);
-        if (nl) {
-            cursor[len_line] = saved;
-            cursor = nl + 1;
+    if (!pad) return NULL;
+
+    for (int row = 0; row < v->sink.line_count; row++) {
+        size_t len_line;
+        const char *text = render_sink_line(&v->sink, row, &len_line);
+        mvwaddnstr(pad, row, 0, text, (int)len_line);
+    }
+
+    view_pads[slot].pad = pad;
+    view_pads[slot].generation = v->generation;
+    view_pads[slot].height = pad_h;
+    view_pads[slot].width = width;
+    return pad;
+}
+
+#define MONTH_VIEW_HELP "↑↓ PgUp/PgDn scroll • Home/End • ←→ month • q/ESC back"
+#define SHEET_VIEW_HELP "↑↓ PgUp/PgDn scroll • Home/End • ←→ year • m Metonic cycle • q/ESC back"
+
+#define VIEW_BACK 0
+#define VIEW_PREV 1
+#define VIEW_NEXT 2
+#define VIEW_RESIZE 3
+
+/* Refit the main window to the terminal, keeping the margins run_interactive_ui() gives it */
+static void fit_main_window(WINDOW *win)
+{
+    int rows = LINES - 2;
+    int cols = COLS - 4;
+    if (rows < 4) rows = 4;
+    if (cols < 8) cols = 8;
+    wresize(win, rows, cols);
+    clear();
+    refresh();
+}
+
+/*
+ * ncurses leaves errno alone when a blocking getch() returns ERR, so ask
+ * the terminal itself: a hung-up or closed stdin reports it at once.
+ */
+static int terminal_gone(void)
+{
+    struct pollfd pfd = { .fd = STDIN_FILENO, .events = POLLIN };
+    if (poll(&pfd, 1, 0) < 0) return errno != EINTR;
+    return (pfd.revents & (POLLHUP | POLLERR | POLLNVAL)) != 0;
+}
+
+static void draw_view_frame(WINDOW *win, int height, const char *help)
+{
+    werase(win);
+    box(win, 0, 0);
+
+    wattron(win, COLOR_PAIR(COLOR_PAIR_MENU));
+    mvwprintw(win, height - 2, 1, "%s", help);
+    wattroff(win, COLOR_PAIR(COLOR_PAIR_MENU));
+
+    /* Draw border/help first, then overlay the pad so content stays visible */
+    wrefresh(win);
+}
+
+/* Show the rich text month view (same as CLI) in the ncurses window until the user leaves it */
+static int render_month_view(WINDOW *win, long jd_actual)
+{
+    int height, width;
+    getmaxyx(win, height, width);
+
+    double current_hour;
+    long today_jd;
+    observer_now(&today_jd, &current_hour);
+
+    ViewContext ctx;
+    resolve_view(jd_actual, today_jd, current_hour, &ctx);
+
+    /* A miss is rendered unlocked, so it never waits behind the prefetcher */
+    RenderSink fresh;
+    render_sink_init(&fresh);
+    pthread_mutex_lock(&render_lock);
+    int slot = find_view(&ctx.key);
+    if (slot < 0) {
+        pthread_mutex_unlock(&render_lock);
+        render_view(&fresh, &ctx);
+        pthread_mutex_lock(&render_lock);
+        slot = publish_view(&ctx.key, &fresh);
+    }
+    const RenderSink *sink = &view_cache[slot].sink;
+    int truncated = sink->failed;
+    int empty = sink->line_count == 0;
+    WINDOW *pad = (truncated || empty) ? NULL : view_pad(slot, width);
+    int pad_h = view_pads[slot].height;
+    request_prefetch(jd_actual, today_jd, current_hour);
+    pthread_mutex_unlock(&render_lock);
+    render_sink_free(&fresh);
+
+    if (truncated || empty || !pad) {
+        /* Give the user an actionable message instead of a blank or partial view */
+        werase(win);
+        box(win, 0, 0);
+        if (empty && !truncated) {
+            mvwprintw(win, 1, 2, "Calendar output was empty.");
+            mvwprintw(win, 2, 2, "Run the CLI (./celtic_calendar) to verify data, then retry.");
+        } else {
+            mvwprintw(win, 1, 2, "Out of memory while rendering this month.");
+            mvwprintw(win, 2, 2, "Free some memory, then retry.");
         }
+        wrefresh(win);
+        wgetch(win);
+        return VIEW_BACK;
     }
 
     /* Constrain drawing to the inside of the border */
@@ -241,24 +516,15 @@ static void render_month_view(WINDOW *win, long jd_actual)
     int win_y, win_x;
     getbegyx(win, win_y, win_x);
 
-    int ch;
-    do {
-        werase(win);
-        box(win, 0, 0);
-
-        wattron(win, COLOR_PAIR(COLOR_PAIR_MENU));
-        mvwprintw(win, height - 2, 1, "↑↓ PgUp/PgDn scroll • Home/End • q/ESC back");
-        wattroff(win, COLOR_PAIR(COLOR_PAIR_MENU));
-
-        /* Draw border/help first, then overlay the pad so content stays visible */
-        wrefresh(win);
-
+    /* Only the pad is redrawn while scrolling; the frame is drawn once */
+    draw_view_frame(win, height, MONTH_VIEW_HELP);
+    for (;;) {
         /* Render pad inside the window border; offsets keep content visible */
         prefresh(pad, top, 0,
              win_y + 1, win_x + 1,
              win_y + view_h, win_x + view_w);
 
-        ch = wgetch(win);
+        int ch = wgetch(win);
         switch (ch) {
             case KEY_UP:    if (top > 0) top--; break;
             case KEY_DOWN:  if (top < max_top) top++; break;
@@ -266,17 +532,99 @@ static void render_month_view(WINDOW *win, long jd_actual)
             case KEY_NPAGE: top += view_h; if (top > max_top) top = max_top; break;
             case KEY_HOME:  top = 0; break;
             case KEY_END:   top = max_top; break;
+            case KEY_LEFT:  return VIEW_PREV;
+            case KEY_RIGHT: return VIEW_NEXT;
+            case KEY_RESIZE: fit_main_window(win); return VIEW_RESIZE;
+            case 'q': case 'Q': case 27: return VIEW_BACK;
+            case ERR: return VIEW_BACK;   /* The menu tells a lost terminal from an interrupted read */
             default: break;
         }
-    } while (ch != 'q' && ch != 'Q' && ch != 27);
+    }
+}
 
-    delwin(pad);
-    free(buf);
+/* Month view loop; returns the JD last shown so menu navigation continues from it */
+static long display_calendar_view(WINDOW *win, long jd_date)
+{
+    for (;;) {
+        int action = render_month_view(win, jd_date);
+        if (action == VIEW_BACK) return jd_date;
+        if (action == VIEW_RESIZE) continue;   /* Same month, laid out for the new size */
+        jd_date = (action == VIEW_NEXT) ? next_month_jd(jd_date) : prev_month_jd(jd_date);
+    }
 }
 
-static void display_calendar_view(WINDOW *win, long jd_date)
+/*
+ * Year-at-a-glance screen for the lunar year holding jd, with as many
+ * month blocks across as fit. ←→ step a year (a cycle on the Metonic
+ * sheet) and m toggles the 19-year sheet. Sheets are cheap enough to
+ * re-render on every step, so they bypass the month view cache.
+ */
+static void display_year_sheet(WINDOW *win, long jd)
 {
-    render_month_view(win, jd_date);
+    double current_hour;
+    long today_jd;
+    observer_now(&today_jd, &current_hour);
+
+    long celtic_today = location_celtic_jd(&ui_location, today_jd, current_hour);
+    int samhain_year = lunar_samhain_year(location_celtic_jd(&ui_location, jd, current_hour));
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int threads = cpus > 1 ? (int)cpus : 1;
+    int metonic = 0;
+    RenderSink sink;
+    render_sink_init(&sink);
+
+    for (;;) {
+        int height, width;
+        getmaxyx(win, height, width);
+        int columns = celtic_sheet_columns(width - 2);
+
+        render_sink_reset(&sink);
+        if (metonic) render_metonic_sheet(&sink, samhain_year, celtic_today, columns, threads);
+        else render_celtic_year(&sink, samhain_year, celtic_today, columns, threads);
+
+        int pad_h = sink.line_count + 1;
+        int pad_w = (sink.max_width + 1 > width - 2) ? sink.max_width + 1 : width - 2;
+        WINDOW *pad = (sink.failed || sink.line_count == 0) ? NULL : newpad(pad_h, pad_w);
+        if (!pad) break;
+        for (int row = 0; row < sink.line_count; row++) {
+            size_t len_line;
+            const char *text = render_sink_line(&sink, row, &len_line);
+            mvwaddnstr(pad, row, 0, text, (int)len_line);
+        }
+
+        int view_h = height - 3;
+        if (view_h < 1) view_h = 1;
+        int top = 0;
+        int max_top = pad_h - view_h;
+        if (max_top < 0) max_top = 0;
+        int win_y, win_x;
+        getbegyx(win, win_y, win_x);
+
+        draw_view_frame(win, height, SHEET_VIEW_HELP);
+        int action = 0;   /* 0 = keep scrolling, 1 = re-render, -1 = leave */
+        while (action == 0) {
+            prefresh(pad, top, 0, win_y + 1, win_x + 1, win_y + view_h, win_x + width - 2);
+            switch (wgetch(win)) {
+                case KEY_UP:    if (top > 0) top--; break;
+                case KEY_DOWN:  if (top < max_top) top++; break;
+                case KEY_PPAGE: top -= view_h; if (top < 0) top = 0; break;
+                case KEY_NPAGE: top += view_h; if (top > max_top) top = max_top; break;
+                case KEY_HOME:  top = 0; break;
+                case KEY_END:   top = max_top; break;
+                case KEY_LEFT:  samhain_year -= metonic ? 19 : 1; action = 1; break;
+                case KEY_RIGHT: samhain_year += metonic ? 19 : 1; action = 1; break;
+                case 'm': case 'M': metonic = !metonic; action = 1; break;
+                case KEY_RESIZE: fit_main_window(win); action = 1; break;
+                case 'q': case 'Q': case 27: action = -1; break;
+                case ERR: action = -1; break;   /* As in the month view, the menu decides what ERR meant */
+                default: break;
+            }
+        }
+        delwin(pad);
+        if (action < 0) break;
+    }
+    render_sink_free(&sink);
 }
 
 static long get_date_from_user(WINDOW *win)
@@ -315,6 +663,13 @@ static long get_date_from_user(WINDOW *win)
 
 void run_interactive_ui(void)
 {
+    ui_location = LOCATION_COLIGNY;
+    const char *site = getenv("CELTIC_LOCATION");
+    if (site && *site && location_parse(site, &ui_location) != 0) {
+        fprintf(stderr, "Ignoring CELTIC_LOCATION '%s' (expected LAT,LON[,TZ])\n", site);
+        ui_location = LOCATION_COLIGNY;
+    }
+
     /* Prefer UTF-8 so emoji/line art render instead of mojibake */
     int has_utf8 = ensure_utf8_locale();
 
@@ -345,7 +700,8 @@ void run_interactive_ui(void)
     noecho();
     curs_set(0);
     keypad(stdscr, TRUE);
-    timeout(50);  /* 50ms timeout for input */
+    timeout(-1);  /* Block for input: no idle polling */
+    set_escdelay(25);  /* Arrow-key sequences arrive together even over slow links */
 
     /* Comprehensive mouse disabling */
     printf("\033[?1000l");  /* Disable X10 mouse reporting */
@@ -373,9 +729,12 @@ void run_interactive_ui(void)
     /* Enable window input */
     keypad(main_win, TRUE);
 
+    /* Neighbouring months are rendered in the background while the user reads */
+    start_prefetcher();
+
     int selected = 0;
     int running = 1;
-    long current_jd = jd_today();
+    long current_jd = observer_today();
 
     /* Clear screen and refresh */
     clear();
@@ -386,8 +745,9 @@ void run_interactive_ui(void)
 
         int ch = getch();
 
-        /* Handle timeout (ERR) - just continue loop */
+        /* Input is blocking: ERR means an interrupted read, or the terminal went away */
         if (ch == ERR) {
+            if (terminal_gone()) break;
             continue;
         }
 
@@ -395,7 +755,7 @@ void run_interactive_ui(void)
         if (ch == 27) {  /* ESC - either quit or mouse sequence */
             timeout(10);  /* Quick timeout to check for sequence */
             int next_ch = getch();
-            timeout(50);  /* Restore normal timeout */
+            timeout(-1);  /* Restore blocking input */
 
             if (next_ch == ERR) {
                 /* Single ESC - quit */
@@ -416,48 +776,42 @@ void run_interactive_ui(void)
                 selected = (selected + 1) % MENU_COUNT;
                 break;
 
+            case KEY_RESIZE:
+                fit_main_window(main_win);
+                break;
+
             case 10:  /* LF - Line Feed */
             case 13:  /* CR - Carriage Return */
             case ' ':  /* Space bar as alternative */
             case KEY_ENTER:
-                timeout(-1);  /* Make operations blocking */
                 switch (selected) {
                     case MENU_TODAY:
-                        current_jd = jd_today();
-                        display_calendar_view(main_win, current_jd);
+                        current_jd = display_calendar_view(main_win, observer_today());
                         break;
 
                     case MENU_SEARCH_DATE:
-                        current_jd = get_date_from_user(main_win);
-                        display_calendar_view(main_win, current_jd);
+                        current_jd = display_calendar_view(main_win, get_date_from_user(main_win));
                         break;
 
                     case MENU_NEXT_MONTH:
-                        {
-                            /* Align navigation with the lunar month rendering used in this UI. */
-                            long celtic_jd = celtic_jd_from_time(current_jd, 12.0, LATITUDE);
-                            long month_start = find_full_moon_before(celtic_jd);
-                            int month_len = lunar_month_length(celtic_jd);
-                            current_jd = month_start + month_len + 1; /* jump to start of next lunar month */
-                        }
-                        display_calendar_view(main_win, current_jd);
+                        /* Align navigation with the lunar month rendering used in this UI. */
+                        current_jd = next_month_jd(current_jd);
+                        current_jd = display_calendar_view(main_win, current_jd);
                         break;
 
                     case MENU_PREV_MONTH:
-                        {
-                            long celtic_jd = celtic_jd_from_time(current_jd, 12.0, LATITUDE);
-                            long month_start = find_full_moon_before(celtic_jd);
-                            /* Step to just before this month's full moon, then rendering will pick the prior month. */
-                            current_jd = month_start - 1;
-                        }
-                        display_calendar_view(main_win, current_jd);
+                        current_jd = prev_month_jd(current_jd);
+                        current_jd = display_calendar_view(main_win, current_jd);
+                        break;
+
+                    case MENU_YEAR_SHEET:
+                        display_year_sheet(main_win, current_jd);
                         break;
 
                     case MENU_QUIT:
                         running = 0;
                         break;
                 }
-                timeout(50);  /* Return to normal timeout after any selection */
                 break;
 
             case 'q':
@@ -468,6 +822,7 @@ void run_interactive_ui(void)
     }
 
     /* Cleanup */
+    stop_prefetcher();
     delwin(main_win);
 
     /* Restore terminal settings and disable any mouse tracking */